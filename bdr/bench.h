@@ -0,0 +1,56 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_BENCH_STATIC)
+#define BDRBDEF static
+#else
+#define BDRBDEF extern
+#endif
+
+// Timing for headless benchmarks, which can't use raylib's GetTime() because they don't open a window.
+
+// clang-format off
+
+BDRBDEF double GetBenchTime(void); // Get the time in seconds from a monotonic clock.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_BENCH_IMPLEMENTATION)
+
+#if defined(_WIN32)
+// Declare what we need from Windows ourselves, because windows.h clashes with raylib.h.
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(long long* count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long* frequency);
+#elif defined(__EMSCRIPTEN__)
+#include <emscripten/emscripten.h>
+#else
+#include <time.h>
+#endif
+
+BDRBDEF double GetBenchTime(void)
+{
+#if defined(_WIN32)
+    long long count;
+    long long frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double)count / (double)frequency;
+#elif defined(__EMSCRIPTEN__)
+    return emscripten_get_now() / 1000.0;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+#endif
+}
+
+#endif // BDR_BENCH_IMPLEMENTATION
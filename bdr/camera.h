@@ -0,0 +1,105 @@
+#pragma once
+
+#include "raylib.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_CAMERA_STATIC)
+#define BDRCDEF static
+#else
+#define BDRCDEF extern
+#endif
+
+// A pseudo-3D camera, as used by racing games that draw their tracks as a series of flat segments. It looks straight down the
+// z-axis, so a point's scale only depends on how far in front of the camera it is, and everything at the same distance shares
+// one scale. A point at a distance z in front of the camera has a scale of depth / z, and is drawn at:
+//
+//     screen x = centre.x + (x - camera x) * scale * pixels.x
+//     screen y = centre.y - (y - camera y) * scale * pixels.y
+//
+// Tracks are drawn a row of segments at a time, so scales are worked out for rows of evenly spaced distances in one go, then
+// whole batches of points are projected with them. The batches are a structure of arrays, so the loops are simple enough for the
+// compiler to vectorise.
+//
+// Positions can be relative to anything, but keeping them relative to somewhere near the camera, e.g., the segment that it's on,
+// keeps them precise on long tracks.
+typedef struct
+{
+    Vector3 position; // Where is the camera?
+    Vector2 centre;   // Where on the screen is the point straight ahead of the camera?
+    Vector2 pixels;   // How many pixels is one world unit, at a scale of 1?
+    float depth;      // What is the scale at a distance of 1?
+} PseudoCamera;
+
+// clang-format off
+
+BDRCDEF float GetPseudoScale(const PseudoCamera* camera, float z);                // Get the scale at a distance along the z-axis.
+BDRCDEF Vector2 ProjectPseudoPoint(const PseudoCamera* camera, Vector3 point);    // Project a point to the screen.
+BDRCDEF float GetPseudoSize(const PseudoCamera* camera, float scale, float size); // Get the size in pixels of something at a scale.
+
+// Fill a scale table for count distances, starting at z and spacing apart.
+BDRCDEF void ComputePseudoScales(const PseudoCamera* camera, float z, float spacing, int count, float* scales);
+
+// Project a batch of points, given their scales.
+BDRCDEF void ProjectPseudoPoints(const PseudoCamera* camera, int count, const float* scales, const float* x, const float* y,
+                                 float* screenX, float* screenY);
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_CAMERA_IMPLEMENTATION)
+
+BDRCDEF float GetPseudoScale(const PseudoCamera* camera, float z)
+{
+    return camera->depth / (z - camera->position.z);
+}
+
+BDRCDEF Vector2 ProjectPseudoPoint(const PseudoCamera* camera, Vector3 point)
+{
+    const float scale = GetPseudoScale(camera, point.z);
+    return (Vector2){camera->centre.x + (point.x - camera->position.x) * scale * camera->pixels.x,
+                     camera->centre.y - (point.y - camera->position.y) * scale * camera->pixels.y};
+}
+
+BDRCDEF float GetPseudoSize(const PseudoCamera* camera, float scale, float size)
+{
+    return size * scale * camera->pixels.x;
+}
+
+// Work out the scales for a row of count distances, starting at z and spacing apart, e.g., for the segments in front of the
+// camera.
+BDRCDEF void ComputePseudoScales(const PseudoCamera* camera, float z, float spacing, int count, float* scales)
+{
+    const float first = z - camera->position.z;
+    const float depth = camera->depth;
+    for (int i = 0; i < count; i++)
+    {
+        scales[i] = depth / (first + spacing * (float)i);
+    }
+}
+
+// Project a batch of points, given their scales from a scale table.
+BDRCDEF void ProjectPseudoPoints(const PseudoCamera* camera, int count, const float* scales, const float* x, const float* y,
+                                 float* screenX, float* screenY)
+{
+    const float cx = camera->centre.x;
+    const float cy = camera->centre.y;
+    const float px = camera->pixels.x;
+    const float py = camera->pixels.y;
+    const float x0 = camera->position.x;
+    const float y0 = camera->position.y;
+    for (int i = 0; i < count; i++)
+    {
+        screenX[i] = cx + (x[i] - x0) * scales[i] * px;
+        screenY[i] = cy - (y[i] - y0) * scales[i] * py;
+    }
+}
+
+#endif // BDR_CAMERA_IMPLEMENTATION
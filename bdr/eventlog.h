@@ -0,0 +1,366 @@
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_EVENTLOG_STATIC)
+#define BDREDEF static
+#else
+#define BDREDEF extern
+#endif
+
+#if !defined(BDR_EVENTLOG_BUFFER_SIZE)
+#define BDR_EVENTLOG_BUFFER_SIZE (64 * 1024) // How many bytes of events can wait to be written. There are two buffers this size.
+#endif
+
+#if !defined(BDR_EVENTLOG_FLUSH_INTERVAL)
+#define BDR_EVENTLOG_FLUSH_INTERVAL 1000 // How often, in milliseconds, the writer flushes whatever events are waiting.
+#endif
+
+// Event log layout. All integers are little-endian. The log is only ever appended to, so a file can hold several runs' events,
+// one after the other, and the header only appears at the start.
+//
+//   header  "BDRE", version (u32)
+//   events  { type (u8), size (u8), data (size bytes) }, in the order that they were logged
+#define BDR_EVENTLOG_MAGIC "BDRE"
+#define BDR_EVENTLOG_VERSION 1
+#define BDR_EVENTLOG_HEADER_SIZE 8
+#define BDR_EVENTLOG_MAX_EVENT_SIZE 255
+
+// An append-only log of small binary events, e.g., for gameplay analytics. Logging an event copies it into a fixed-size buffer in
+// memory, and a thread of the log's own writes the buffer to disk every BDR_EVENTLOG_FLUSH_INTERVAL, or sooner if it's half full,
+// while new events go into the other buffer. The game never waits for the disk. If the disk can't keep up and both buffers are
+// full, then events are dropped and counted rather than using more memory.
+//
+// On platforms without threads, e.g., the web, events are written when their buffer is half full, by whoever logs them.
+//
+// LogEvent() must only be called from one thread at a time.
+
+// clang-format off
+
+BDREDEF bool OpenEventLog(const char* fileName);             // Start appending events to a file, replacing any open log.
+BDREDEF void CloseEventLog(void);                            // Write any events that are waiting, then close the log.
+BDREDEF bool IsEventLogOpen(void);                           // Check if there's a log to write events to.
+BDREDEF bool LogEvent(int type, const void* data, int size); // Add an event, or drop it if there's no room for it.
+BDREDEF void FlushEventLog(void);                            // Ask the writer to write the waiting events now, without waiting.
+BDREDEF int GetDroppedEventCount(void);                      // Get how many events have been dropped since the log was opened.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_EVENTLOG_IMPLEMENTATION)
+
+#include "sync.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#if defined(BDR_SYNC_PTHREADS)
+#include <time.h>
+#endif
+
+static struct
+{
+    FILE* file;                                         // Where do the events go, or NULL if the log isn't open?
+    unsigned char buffers[2][BDR_EVENTLOG_BUFFER_SIZE]; // Events wait in one buffer while the other is written.
+    int front;                                          // Which buffer do new events go into?
+    int used;                                           // How many bytes of the front buffer are used?
+    int dropped;                                        // How many events didn't fit?
+    bool flushRequested;                                // Should the writer write the front buffer now?
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    bool quit;                                          // Should the writer stop?
+    bool threaded;                                      // Is there a writer?
+    BdrLock lock;                                       // Protects everything above.
+    BdrCondition wake;                                  // Signalled when the writer has something to do.
+    BdrThread writer;                                   // The writer.
+#endif
+} eventLog = {.file = NULL};
+
+// Write a buffer's events to disk, without holding the log's lock.
+static void WriteEvents(const unsigned char* events, int size)
+{
+    if (size > 0)
+    {
+        fwrite(events, 1, (size_t)size, eventLog.file);
+        fflush(eventLog.file);
+    }
+}
+
+// Is it worth waking the writer?
+static bool IsEventLogDue(void)
+{
+    return eventLog.flushRequested || eventLog.used >= BDR_EVENTLOG_BUFFER_SIZE / 2;
+}
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+
+static void AcquireEventLog(void)
+{
+#if defined(BDR_SYNC_WIN32)
+    AcquireSRWLockExclusive(&eventLog.lock);
+#else
+    pthread_mutex_lock(&eventLog.lock);
+#endif
+}
+
+static void ReleaseEventLog(void)
+{
+#if defined(BDR_SYNC_WIN32)
+    ReleaseSRWLockExclusive(&eventLog.lock);
+#else
+    pthread_mutex_unlock(&eventLog.lock);
+#endif
+}
+
+static void WakeEventLogWriter(void)
+{
+#if defined(BDR_SYNC_WIN32)
+    WakeAllConditionVariable(&eventLog.wake);
+#else
+    pthread_cond_broadcast(&eventLog.wake);
+#endif
+}
+
+// Wait until the writer is woken, or until it's time to flush anyway. Called with the lock held, and returns with it held.
+static void WaitForEventLogWriter(void)
+{
+#if defined(BDR_SYNC_WIN32)
+    SleepConditionVariableSRW(&eventLog.wake, &eventLog.lock, BDR_EVENTLOG_FLUSH_INTERVAL, 0);
+#else
+    struct timespec until;
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += BDR_EVENTLOG_FLUSH_INTERVAL / 1000;
+    until.tv_nsec += (BDR_EVENTLOG_FLUSH_INTERVAL % 1000) * 1000000L;
+    if (until.tv_nsec >= 1000000000L)
+    {
+        ++until.tv_sec;
+        until.tv_nsec -= 1000000000L;
+    }
+    pthread_cond_timedwait(&eventLog.wake, &eventLog.lock, &until);
+#endif
+}
+
+// Swap the buffers whenever there's something to write, then write the back buffer without holding the lock, so that new events
+// can go into the front buffer in the meantime.
+static void RunEventLogWriter(void)
+{
+    AcquireEventLog();
+    for (;;)
+    {
+        if (!eventLog.quit && !IsEventLogDue())
+        {
+            WaitForEventLogWriter();
+        }
+        const bool quit = eventLog.quit;
+        const int back = eventLog.front;
+        const int size = eventLog.used;
+        eventLog.front = 1 - back;
+        eventLog.used = 0;
+        eventLog.flushRequested = false;
+
+        ReleaseEventLog();
+        WriteEvents(eventLog.buffers[back], size);
+        AcquireEventLog();
+
+        if (quit)
+        {
+            break;
+        }
+    }
+    ReleaseEventLog();
+}
+
+#if defined(BDR_SYNC_WIN32)
+static unsigned long __stdcall EventLogWriterThread(void* parameter)
+{
+    (void)parameter;
+    RunEventLogWriter();
+    return 0;
+}
+#else
+static void* EventLogWriterThread(void* parameter)
+{
+    (void)parameter;
+    RunEventLogWriter();
+    return NULL;
+}
+#endif
+
+#endif // BDR_SYNC_WIN32 || BDR_SYNC_PTHREADS
+
+BDREDEF bool OpenEventLog(const char* fileName)
+{
+    CloseEventLog();
+
+    eventLog.file = fopen(fileName, "ab");
+    if (eventLog.file == NULL)
+    {
+        return false;
+    }
+
+    // Only a new log gets a header. Anything else is appended to what's there.
+    fseek(eventLog.file, 0, SEEK_END);
+    if (ftell(eventLog.file) == 0)
+    {
+        const unsigned char header[BDR_EVENTLOG_HEADER_SIZE] = {'B', 'D', 'R', 'E', BDR_EVENTLOG_VERSION, 0, 0, 0};
+        WriteEvents(header, BDR_EVENTLOG_HEADER_SIZE);
+    }
+    eventLog.front = 0;
+    eventLog.used = 0;
+    eventLog.dropped = 0;
+    eventLog.flushRequested = false;
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    eventLog.quit = false;
+#if defined(BDR_SYNC_WIN32)
+    InitializeSRWLock(&eventLog.lock);
+    InitializeConditionVariable(&eventLog.wake);
+    eventLog.writer = CreateThread(NULL, 0, EventLogWriterThread, NULL, 0, NULL);
+    eventLog.threaded = eventLog.writer != NULL;
+#else
+    pthread_mutex_init(&eventLog.lock, NULL);
+    pthread_cond_init(&eventLog.wake, NULL);
+    eventLog.threaded = pthread_create(&eventLog.writer, NULL, EventLogWriterThread, NULL) == 0;
+#endif
+    if (!eventLog.threaded)
+    {
+        // Without a writer, the events are written by whoever logs them, as they are on platforms without threads.
+#if defined(BDR_SYNC_PTHREADS)
+        pthread_cond_destroy(&eventLog.wake);
+        pthread_mutex_destroy(&eventLog.lock);
+#endif
+    }
+#endif
+
+    return true;
+}
+
+BDREDEF void CloseEventLog(void)
+{
+    if (eventLog.file == NULL)
+    {
+        return;
+    }
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    if (eventLog.threaded)
+    {
+        // The writer writes whatever is waiting before it stops.
+        AcquireEventLog();
+        eventLog.quit = true;
+        WakeEventLogWriter();
+        ReleaseEventLog();
+#if defined(BDR_SYNC_WIN32)
+        WaitForSingleObject(eventLog.writer, BDR_INFINITE);
+        CloseHandle(eventLog.writer);
+#else
+        pthread_join(eventLog.writer, NULL);
+        pthread_cond_destroy(&eventLog.wake);
+        pthread_mutex_destroy(&eventLog.lock);
+#endif
+        eventLog.threaded = false;
+        eventLog.used = 0;
+    }
+#endif
+
+    WriteEvents(eventLog.buffers[eventLog.front], eventLog.used);
+    fclose(eventLog.file);
+    eventLog.file = NULL;
+}
+
+BDREDEF bool IsEventLogOpen(void)
+{
+    return eventLog.file != NULL;
+}
+
+BDREDEF bool LogEvent(int type, const void* data, int size)
+{
+    if (eventLog.file == NULL || type < 0 || type > 255 || size < 0 || size > BDR_EVENTLOG_MAX_EVENT_SIZE)
+    {
+        return false;
+    }
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    if (eventLog.threaded)
+    {
+        AcquireEventLog();
+    }
+#endif
+
+    // Only the front buffer is ours. If it's full then the writer is still busy with the back buffer, so drop the event.
+    const bool fits = eventLog.used + 2 + size <= BDR_EVENTLOG_BUFFER_SIZE;
+    if (fits)
+    {
+        unsigned char* event = &eventLog.buffers[eventLog.front][eventLog.used];
+        event[0] = (unsigned char)type;
+        event[1] = (unsigned char)size;
+        if (size > 0)
+        {
+            memcpy(event + 2, data, (size_t)size);
+        }
+        eventLog.used += 2 + size;
+    }
+    else
+    {
+        ++eventLog.dropped;
+    }
+    const bool due = IsEventLogDue();
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    if (eventLog.threaded)
+    {
+        if (due)
+        {
+            WakeEventLogWriter();
+        }
+        ReleaseEventLog();
+        return fits;
+    }
+#endif
+
+    if (due)
+    {
+        WriteEvents(eventLog.buffers[eventLog.front], eventLog.used);
+        eventLog.used = 0;
+        eventLog.flushRequested = false;
+    }
+    return fits;
+}
+
+BDREDEF void FlushEventLog(void)
+{
+    if (eventLog.file == NULL)
+    {
+        return;
+    }
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    if (eventLog.threaded)
+    {
+        AcquireEventLog();
+        eventLog.flushRequested = true;
+        WakeEventLogWriter();
+        ReleaseEventLog();
+        return;
+    }
+#endif
+
+    WriteEvents(eventLog.buffers[eventLog.front], eventLog.used);
+    eventLog.used = 0;
+    eventLog.flushRequested = false;
+}
+
+BDREDEF int GetDroppedEventCount(void)
+{
+    return eventLog.dropped;
+}
+
+#endif // BDR_EVENTLOG_IMPLEMENTATION
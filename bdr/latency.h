@@ -0,0 +1,266 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_LATENCY_STATIC)
+#define BDRTDEF static
+#else
+#define BDRTDEF extern
+#endif
+
+#if !defined(BDR_LATENCY_BUCKETS)
+#define BDR_LATENCY_BUCKETS 64 // The number of 1ms histogram buckets. Anything slower goes into an overflow bucket.
+#endif
+
+#if !defined(BDR_LATENCY_SCANOUT)
+#define BDR_LATENCY_SCANOUT (1.0 / 60.0) // Estimated time from a frame being presented to it reaching the screen.
+#endif
+
+// Latency tracking follows an input event through the loop.
+//
+//   event     the input was sampled, i.e., raylib polled it in EndDrawing() and CheckTriggers() saw it
+//   consumed  the game acted on it, e.g., in FixedUpdate()
+//   presented the first frame drawn after it was consumed has been presented by EndDrawing()
+//
+// Only one event is tracked at a time. Events that arrive while one is being tracked are counted, but not timed. Each event comes
+// from a source, e.g., a controller, and it's only consumed when the game acts on that source's input from the event's sample or
+// later, so that acting on another source's input, or on something sampled before the event, doesn't count. If the game stops
+// acting on input, e.g., because it's paused, then the event should be cancelled rather than being left to be consumed later.
+
+// clang-format off
+
+BDRTDEF void EnableLatencyTracking(bool enable);                         // Turn tracking on or off, logging the results when off.
+BDRTDEF bool IsLatencyTrackingEnabled(void);                             // Check if latency tracking is on.
+BDRTDEF void ResetLatencyTracking(void);                                 // Clear the histograms.
+BDRTDEF void MarkInputEvent(int source, double time);                    // Record that a source's input event was sampled then.
+BDRTDEF void MarkInputConsumed(int source, double sampled, double time); // Record acting on a source's input that was sampled then.
+BDRTDEF void CancelInputEvent(void);                                     // Stop tracking the event, e.g., because the game paused.
+BDRTDEF void MarkFramePresented(double time);                            // Record that a frame was presented at the given time.
+BDRTDEF void LogLatencyHistograms(void);                                 // Log a summary of the histograms.
+BDRTDEF void DrawLatencyHistograms(int x, int y);                        // Draw the histograms, if latency tracking is on.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_LATENCY_IMPLEMENTATION)
+
+typedef struct
+{
+    const char* name;                    // What does this histogram measure?
+    Color colour;                        // What colour is it drawn in?
+    int counts[BDR_LATENCY_BUCKETS + 1]; // Counts per 1ms bucket, plus an overflow bucket.
+    int total;                           // Total number of samples.
+    double sum;                          // Sum of all samples (seconds).
+    double max;                          // Largest sample (seconds).
+} LatencyHistogram;
+
+enum
+{
+    LATENCY_INPUT_TO_TICK,   // Input sampled to input consumed.
+    LATENCY_TICK_TO_FRAME,   // Input consumed to frame presented.
+    LATENCY_INPUT_TO_PHOTON, // Input sampled to the estimated time that the frame reached the screen.
+    LATENCY_HISTOGRAM_COUNT
+};
+
+static struct
+{
+    bool enabled;        // Are we tracking latency?
+    bool hasEvent;       // Are we tracking an event?
+    bool hasConsumed;    // Has the tracked event been consumed?
+    int source;          // Where did the tracked event come from?
+    double eventTime;    // When was the tracked event sampled?
+    double consumedTime; // When was the tracked event consumed?
+    int coalesced;       // How many events arrived while another was being tracked?
+    LatencyHistogram histograms[LATENCY_HISTOGRAM_COUNT];
+} latency = {.enabled = false,
+             .histograms = {{.name = "input to tick", .colour = {0, 228, 48, 255}},
+                            {.name = "tick to frame", .colour = {253, 249, 0, 255}},
+                            {.name = "input to photon (est)", .colour = {230, 41, 55, 255}}}};
+
+static void AddLatencySample(LatencyHistogram* histogram, double seconds)
+{
+    int bucket = (int)(seconds * 1000.0);
+    if (bucket < 0)
+    {
+        bucket = 0;
+    }
+    if (bucket > BDR_LATENCY_BUCKETS)
+    {
+        bucket = BDR_LATENCY_BUCKETS;
+    }
+    ++histogram->counts[bucket];
+    ++histogram->total;
+    histogram->sum += seconds;
+    if (seconds > histogram->max)
+    {
+        histogram->max = seconds;
+    }
+}
+
+// Find the bucket (in ms) below which the given fraction of the samples lie.
+static int GetLatencyPercentile(const LatencyHistogram* histogram, double fraction)
+{
+    const int target = (int)(fraction * histogram->total);
+    int seen = 0;
+    for (int i = 0; i <= BDR_LATENCY_BUCKETS; i++)
+    {
+        seen += histogram->counts[i];
+        if (seen > target)
+        {
+            return i;
+        }
+    }
+    return BDR_LATENCY_BUCKETS;
+}
+
+BDRTDEF void EnableLatencyTracking(bool enable)
+{
+    if (latency.enabled && !enable)
+    {
+        LogLatencyHistograms();
+    }
+    if (enable && !latency.enabled)
+    {
+        ResetLatencyTracking();
+    }
+    latency.enabled = enable;
+}
+
+BDRTDEF bool IsLatencyTrackingEnabled(void)
+{
+    return latency.enabled;
+}
+
+BDRTDEF void ResetLatencyTracking(void)
+{
+    latency.hasEvent = false;
+    latency.hasConsumed = false;
+    latency.coalesced = 0;
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++)
+    {
+        LatencyHistogram* histogram = &latency.histograms[i];
+        for (int j = 0; j <= BDR_LATENCY_BUCKETS; j++)
+        {
+            histogram->counts[j] = 0;
+        }
+        histogram->total = 0;
+        histogram->sum = 0.0;
+        histogram->max = 0.0;
+    }
+}
+
+BDRTDEF void MarkInputEvent(int source, double time)
+{
+    if (!latency.enabled)
+    {
+        return;
+    }
+
+    if (latency.hasEvent)
+    {
+        ++latency.coalesced;
+        return;
+    }
+
+    latency.hasEvent = true;
+    latency.hasConsumed = false;
+    latency.source = source;
+    latency.eventTime = time;
+}
+
+BDRTDEF void MarkInputConsumed(int source, double sampled, double time)
+{
+    if (!latency.enabled || !latency.hasEvent || latency.hasConsumed || source != latency.source || sampled < latency.eventTime)
+    {
+        return;
+    }
+
+    latency.hasConsumed = true;
+    latency.consumedTime = time;
+}
+
+BDRTDEF void CancelInputEvent(void)
+{
+    latency.hasEvent = false;
+    latency.hasConsumed = false;
+}
+
+BDRTDEF void MarkFramePresented(double time)
+{
+    if (!latency.enabled || !latency.hasConsumed)
+    {
+        return;
+    }
+
+    AddLatencySample(&latency.histograms[LATENCY_INPUT_TO_TICK], latency.consumedTime - latency.eventTime);
+    AddLatencySample(&latency.histograms[LATENCY_TICK_TO_FRAME], time - latency.consumedTime);
+    AddLatencySample(&latency.histograms[LATENCY_INPUT_TO_PHOTON], time + BDR_LATENCY_SCANOUT - latency.eventTime);
+    latency.hasEvent = false;
+    latency.hasConsumed = false;
+}
+
+BDRTDEF void LogLatencyHistograms(void)
+{
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++)
+    {
+        const LatencyHistogram* histogram = &latency.histograms[i];
+        if (histogram->total == 0)
+        {
+            continue;
+        }
+        TraceLog(LOG_INFO, "LATENCY: %-22s n=%d mean=%.1fms p50=%dms p95=%dms max=%.1fms", histogram->name, histogram->total,
+                 1000.0 * histogram->sum / histogram->total, GetLatencyPercentile(histogram, 0.5),
+                 GetLatencyPercentile(histogram, 0.95), 1000.0 * histogram->max);
+    }
+    if (latency.coalesced > 0)
+    {
+        TraceLog(LOG_INFO, "LATENCY: %d events arrived while another was being tracked", latency.coalesced);
+    }
+}
+
+BDRTDEF void DrawLatencyHistograms(int x, int y)
+{
+    if (!latency.enabled)
+    {
+        return;
+    }
+
+    const int barWidth = 4;
+    const int height = 60;
+    for (int i = 0; i < LATENCY_HISTOGRAM_COUNT; i++)
+    {
+        const LatencyHistogram* histogram = &latency.histograms[i];
+        const int top = y + i * (height + 24);
+
+        int largest = 1;
+        for (int j = 0; j <= BDR_LATENCY_BUCKETS; j++)
+        {
+            largest = histogram->counts[j] > largest ? histogram->counts[j] : largest;
+        }
+
+        DrawRectangleLines(x, top, (BDR_LATENCY_BUCKETS + 1) * barWidth, height, DARKGRAY);
+        for (int j = 0; j <= BDR_LATENCY_BUCKETS; j++)
+        {
+            const int barHeight = histogram->counts[j] * height / largest;
+            DrawRectangle(x + j * barWidth, top + height - barHeight, barWidth - 1, barHeight, histogram->colour);
+        }
+
+        const double mean = histogram->total > 0 ? 1000.0 * histogram->sum / histogram->total : 0.0;
+        DrawText(TextFormat("%s: mean %.1fms p95 %dms (n=%d)", histogram->name, mean, GetLatencyPercentile(histogram, 0.95),
+                            histogram->total),
+                 x, top + height + 2, 10, histogram->colour);
+    }
+}
+
+#endif // BDR_LATENCY_IMPLEMENTATION
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_LAYERS_STATIC)
+#define BDRYDEF static
+#else
+#define BDRYDEF extern
+#endif
+
+// A static layer caches something that rarely changes, e.g., a background, in its own render texture, so that it can be drawn
+// with a single textured quad instead of being drawn again every frame. It is only drawn again when it is marked as dirty, or
+// when its size changes.
+//
+// Render textures can't be nested, so draw static layers before BeginDrawing(), or at least before BeginTextureMode() or
+// BeginScaledDrawing().
+//
+//     if (BeginStaticLayer(&layer, width, height))
+//     {
+//         ... draw the layer's contents ...
+//         EndStaticLayer(&layer);
+//     }
+//     BeginDrawing();
+//     DrawStaticLayer(&layer, (Rectangle){0, 0, width, height});
+//     ...
+typedef struct
+{
+    RenderTexture2D target; // The layer's contents.
+    bool loaded;            // Has the render texture been loaded?
+    bool dirty;             // Does the layer need to be drawn again?
+} StaticLayer;
+
+// clang-format off
+
+BDRYDEF void InitStaticLayer(StaticLayer* layer);                         // Initialise a layer. It loads when first drawn.
+BDRYDEF void UnloadStaticLayer(StaticLayer* layer);                       // Release a layer's render texture.
+BDRYDEF void MarkStaticLayerDirty(StaticLayer* layer);                    // Redraw a layer, e.g., if the view changed.
+BDRYDEF bool BeginStaticLayer(StaticLayer* layer, int width, int height); // Start drawing a layer's contents, if they need drawing.
+BDRYDEF void EndStaticLayer(StaticLayer* layer);                          // Finish drawing a layer's contents.
+BDRYDEF void DrawStaticLayer(const StaticLayer* layer, Rectangle dest);   // Draw a layer.
+BDRYDEF int GetStaticLayerRenderCount(void);                              // Count layer redraws, for diagnostics.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_LAYERS_IMPLEMENTATION)
+
+static int staticLayerRenderCount = 0;
+
+BDRYDEF void InitStaticLayer(StaticLayer* layer)
+{
+    layer->loaded = false;
+    layer->dirty = true;
+}
+
+BDRYDEF void UnloadStaticLayer(StaticLayer* layer)
+{
+    if (layer->loaded)
+    {
+        UnloadRenderTexture(layer->target);
+        layer->loaded = false;
+    }
+    layer->dirty = true;
+}
+
+BDRYDEF void MarkStaticLayerDirty(StaticLayer* layer)
+{
+    layer->dirty = true;
+}
+
+BDRYDEF bool BeginStaticLayer(StaticLayer* layer, int width, int height)
+{
+    if (layer->loaded && (layer->target.texture.width != width || layer->target.texture.height != height))
+    {
+        UnloadStaticLayer(layer);
+    }
+
+    if (!layer->dirty)
+    {
+        return false;
+    }
+
+    if (!layer->loaded)
+    {
+        layer->target = LoadRenderTexture(width, height);
+        layer->loaded = true;
+    }
+
+    BeginTextureMode(layer->target);
+    ++staticLayerRenderCount;
+
+    return true;
+}
+
+BDRYDEF void EndStaticLayer(StaticLayer* layer)
+{
+    EndTextureMode();
+    layer->dirty = false;
+}
+
+BDRYDEF void DrawStaticLayer(const StaticLayer* layer, Rectangle dest)
+{
+    if (!layer->loaded)
+    {
+        return;
+    }
+
+    // Render textures are upside down.
+    const Texture2D texture = layer->target.texture;
+    const Rectangle source = {0, 0, (float)texture.width, (float)-texture.height};
+    DrawTexturePro(texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+}
+
+BDRYDEF int GetStaticLayerRenderCount(void)
+{
+    return staticLayerRenderCount;
+}
+
+#endif // BDR_LAYERS_IMPLEMENTATION
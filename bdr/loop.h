@@ -78,6 +78,9 @@ BDRLDEF void SetUpdateInterval(double seconds);
 BDRLDEF double GetRenderInterval(void);
 BDRLDEF void SetRenderInterval(double seconds);
 
+BDRLDEF double GetPhysicsTime(void);
+BDRLDEF double GetPhysicsTimeAt(double time);
+
 #ifdef __cplusplus
 }
 #endif
@@ -130,6 +133,19 @@ BDRLDEF void SetRenderInterval(double seconds)
     timing.renderInterval = seconds;
 }
 
+// Get the physics time. During a fixed update this is the time at the start of the update.
+BDRLDEF double GetPhysicsTime(void)
+{
+    return timing.t;
+}
+
+// Convert a time from GetTime() to physics time, e.g., to work out which fixed update an input event belongs to.
+BDRLDEF double GetPhysicsTimeAt(double time)
+{
+    // Physics time has caught up to lastTime, except for whatever is left in the accumulator.
+    return timing.t + timing.accumulator + (time - timing.lastTime);
+}
+
 BDRLDEF void BDR_LOOP_UPDATE_DRAW_FRAME(void)
 {
 #if defined(__EMSCRIPTEN__)
@@ -0,0 +1,264 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_PACK_STATIC)
+#define BDRPDEF static
+#else
+#define BDRPDEF extern
+#endif
+
+// Pack file layout. All integers are little-endian.
+//
+//   header  "BDRP", version (u32), entry count (u32), reserved (u32)
+//   index   entry count * { name (56 bytes, NUL terminated), offset (u32), size (u32) }, sorted by name
+//   data    the contents of each entry, each starting on a BDR_PACK_ALIGNMENT boundary
+#define BDR_PACK_MAGIC "BDRP"
+#define BDR_PACK_VERSION 1
+#define BDR_PACK_HEADER_SIZE 16
+#define BDR_PACK_NAME_SIZE 56
+#define BDR_PACK_ENTRY_SIZE (BDR_PACK_NAME_SIZE + 8)
+#define BDR_PACK_ALIGNMENT 16
+
+// clang-format off
+
+BDRPDEF bool MountAssetPack(const char* fileName);                              // Map an asset pack into memory, replacing any existing one.
+BDRPDEF void UnmountAssetPack(void);                                            // Release the mounted asset pack.
+BDRPDEF bool IsAssetPackMounted(void);                                          // Check if an asset pack is mounted.
+BDRPDEF const unsigned char* GetPackedAssetData(const char* name, int* dataSize); // Get a pointer into the pack for the named asset, or NULL.
+BDRPDEF Font LoadPackedFont(const char* fileName);                              // Load a font from the pack, falling back to the file system.
+BDRPDEF Texture2D LoadPackedTexture(const char* fileName);                      // Load a texture from the pack, falling back to the file system.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_PACK_IMPLEMENTATION)
+
+#include <string.h>
+
+// Map the pack with mmap() where we can so that only the pages we touch are read. Elsewhere (Windows, and the web, where
+// Emscripten has already fetched the pack as part of its single preloaded data blob) we read it with one call.
+#if !defined(_WIN32) && !defined(PLATFORM_WEB) && !defined(EMSCRIPTEN)
+#define BDR_PACK_USE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if !defined(BDR_PACK_TTF_SIZE)
+#define BDR_PACK_TTF_SIZE 32 // Matches the size used by raylib's LoadFont().
+#endif
+
+#if !defined(BDR_PACK_TTF_GLYPHS)
+#define BDR_PACK_TTF_GLYPHS 95 // Matches the number of glyphs used by raylib's LoadFont().
+#endif
+
+static struct
+{
+    const unsigned char* data; // The start of the pack.
+    unsigned int size;         // The size of the pack in bytes.
+    unsigned int count;        // The number of entries in the index.
+    bool mapped;               // Was the pack mapped with mmap() rather than loaded?
+} pack = {.data = NULL, .size = 0, .count = 0, .mapped = false};
+
+static unsigned int ReadPackU32(const unsigned char* p)
+{
+    return (unsigned int)p[0] | ((unsigned int)p[1] << 8) | ((unsigned int)p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static const unsigned char* GetPackEntry(unsigned int i)
+{
+    return pack.data + BDR_PACK_HEADER_SIZE + i * BDR_PACK_ENTRY_SIZE;
+}
+
+// Check that the header, the index and everything that it refers to lies within the pack.
+static bool ValidatePack(const unsigned char* data, unsigned int size)
+{
+    if (size < BDR_PACK_HEADER_SIZE || memcmp(data, BDR_PACK_MAGIC, 4) != 0 || ReadPackU32(data + 4) != BDR_PACK_VERSION)
+    {
+        return false;
+    }
+
+    const unsigned int count = ReadPackU32(data + 8);
+    if (count > (size - BDR_PACK_HEADER_SIZE) / BDR_PACK_ENTRY_SIZE)
+    {
+        return false;
+    }
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const unsigned char* entry = data + BDR_PACK_HEADER_SIZE + i * BDR_PACK_ENTRY_SIZE;
+        const unsigned int offset = ReadPackU32(entry + BDR_PACK_NAME_SIZE);
+        const unsigned int entrySize = ReadPackU32(entry + BDR_PACK_NAME_SIZE + 4);
+        if (entry[BDR_PACK_NAME_SIZE - 1] != '\0' || offset > size || entrySize > size - offset)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+BDRPDEF bool MountAssetPack(const char* fileName)
+{
+    UnmountAssetPack();
+
+    const unsigned char* data = NULL;
+    unsigned int size = 0;
+    bool mapped = false;
+
+#if defined(BDR_PACK_USE_MMAP)
+    int fd = open(fileName, O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                data = (const unsigned char*)p;
+                size = (unsigned int)st.st_size;
+                mapped = true;
+            }
+        }
+        close(fd); // The mapping keeps its own reference to the file.
+    }
+#else
+    data = LoadFileData(fileName, &size);
+#endif
+
+    if (data == NULL)
+    {
+        TraceLog(LOG_INFO, "PACK: [%s] Not available, loading assets individually", fileName);
+        return false;
+    }
+
+    if (!ValidatePack(data, size))
+    {
+        TraceLog(LOG_WARNING, "PACK: [%s] Invalid asset pack", fileName);
+#if defined(BDR_PACK_USE_MMAP)
+        munmap((void*)data, size);
+#else
+        UnloadFileData((unsigned char*)data);
+#endif
+        return false;
+    }
+
+    pack.data = data;
+    pack.size = size;
+    pack.count = ReadPackU32(data + 8);
+    pack.mapped = mapped;
+    TraceLog(LOG_INFO, "PACK: [%s] Mounted %u assets (%u bytes)%s", fileName, pack.count, pack.size, mapped ? ", mapped" : "");
+
+    return true;
+}
+
+BDRPDEF void UnmountAssetPack(void)
+{
+    if (pack.data == NULL)
+    {
+        return;
+    }
+
+#if defined(BDR_PACK_USE_MMAP)
+    if (pack.mapped)
+    {
+        munmap((void*)pack.data, pack.size);
+    }
+#else
+    UnloadFileData((unsigned char*)pack.data);
+#endif
+
+    pack.data = NULL;
+    pack.size = 0;
+    pack.count = 0;
+    pack.mapped = false;
+}
+
+BDRPDEF bool IsAssetPackMounted(void)
+{
+    return pack.data != NULL;
+}
+
+BDRPDEF const unsigned char* GetPackedAssetData(const char* name, int* dataSize)
+{
+    // The index is sorted by name, so binary search it.
+    unsigned int lo = 0;
+    unsigned int hi = pack.count;
+    while (lo < hi)
+    {
+        const unsigned int mid = lo + (hi - lo) / 2;
+        const unsigned char* entry = GetPackEntry(mid);
+        const int cmp = strcmp(name, (const char*)entry);
+        if (cmp == 0)
+        {
+            if (dataSize != NULL)
+            {
+                *dataSize = (int)ReadPackU32(entry + BDR_PACK_NAME_SIZE + 4);
+            }
+            return pack.data + ReadPackU32(entry + BDR_PACK_NAME_SIZE);
+        }
+        if (cmp < 0)
+        {
+            hi = mid;
+        }
+        else
+        {
+            lo = mid + 1;
+        }
+    }
+
+    return NULL;
+}
+
+BDRPDEF Font LoadPackedFont(const char* fileName)
+{
+    int dataSize = 0;
+    const unsigned char* data = GetPackedAssetData(fileName, &dataSize);
+    if (data == NULL)
+    {
+        return LoadFont(fileName);
+    }
+
+    // The font is parsed directly from the pack, so there's no intermediate copy of the file.
+    Font font = LoadFontFromMemory(GetFileExtension(fileName), data, dataSize, BDR_PACK_TTF_SIZE, NULL, BDR_PACK_TTF_GLYPHS);
+    if (font.texture.id == 0)
+    {
+        TraceLog(LOG_WARNING, "PACK: [%s] Failed to load font, using default font", fileName);
+        return GetFontDefault();
+    }
+    SetTextureFilter(font.texture, TEXTURE_FILTER_POINT);
+
+    return font;
+}
+
+BDRPDEF Texture2D LoadPackedTexture(const char* fileName)
+{
+    int dataSize = 0;
+    const unsigned char* data = GetPackedAssetData(fileName, &dataSize);
+    if (data == NULL)
+    {
+        return LoadTexture(fileName);
+    }
+
+    Image image = LoadImageFromMemory(GetFileExtension(fileName), data, dataSize);
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+
+    return texture;
+}
+
+#endif // BDR_PACK_IMPLEMENTATION
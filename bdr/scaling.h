@@ -0,0 +1,250 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_SCALING_STATIC)
+#define BDRSDEF static
+#else
+#define BDRSDEF extern
+#endif
+
+#if !defined(BDR_SCALING_STEP)
+#define BDR_SCALING_STEP 0.125f // How much the render scale changes by at a time.
+#endif
+
+#if !defined(BDR_SCALING_OVER_BUDGET)
+#define BDR_SCALING_OVER_BUDGET 1.2 // A frame is over budget when it takes this much longer than the budget.
+#endif
+
+#if !defined(BDR_SCALING_HEADROOM)
+#define BDR_SCALING_HEADROOM 0.5 // There is headroom when drawing and submitting a frame takes less than this much of the budget.
+#endif
+
+#if !defined(BDR_SCALING_DROP_FRAMES)
+#define BDR_SCALING_DROP_FRAMES 5 // How many frames in a row have to be over budget before the render scale is lowered.
+#endif
+
+#if !defined(BDR_SCALING_RAISE_FRAMES)
+#define BDR_SCALING_RAISE_FRAMES 120 // How many frames in a row need headroom before the render scale is raised.
+#endif
+
+// Scaled drawing renders into part of a render texture whose size is the screen size multiplied by the render scale, then
+// stretches it over the screen. Drawing coordinates don't change with the render scale.
+//
+// When dynamic resolution is on, the render scale is lowered quickly when frames take longer than the frame budget, and raised
+// slowly when there is headroom. At a render scale of 1, with the drawing size the same as the screen size, drawing goes straight
+// to the screen, so nothing is lost (e.g., MSAA) when there is no need to scale.
+
+// clang-format off
+
+BDRSDEF void SetScaledDrawingSize(int width, int height);         // Set the drawing coordinates' size. 0, 0 is the screen size.
+BDRSDEF void SetRenderScaleRange(float minScale, float maxScale); // Set the range of the render scale, relative to the screen size.
+BDRSDEF void SetRenderScale(float scale);                         // Set the render scale, e.g., when dynamic resolution is off.
+BDRSDEF float GetRenderScale(void);                               // Get the render scale.
+BDRSDEF void SetFrameBudget(double seconds);                      // Set the time that a frame should take.
+BDRSDEF void EnableDynamicResolution(bool enable);                // Turn dynamic resolution on or off.
+BDRSDEF bool IsDynamicResolutionEnabled(void);                    // Check if dynamic resolution is on.
+BDRSDEF void BeginScaledDrawing(void);                            // Start drawing at the render scale. Call after BeginDrawing().
+BDRSDEF void EndScaledDrawing(void);                              // Finish scaled drawing and draw the result to the screen.
+BDRSDEF void UnloadRenderScaling(void);                           // Release the render texture.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_SCALING_IMPLEMENTATION)
+
+#include "rlgl.h"
+
+static struct
+{
+    RenderTexture2D target; // The render texture, sized for the maximum render scale.
+    bool loaded;            // Has the render texture been loaded?
+    bool active;            // Are we drawing into the render texture this frame?
+    int width;              // Width of the drawing coordinates, or 0 for the screen width.
+    int height;             // Height of the drawing coordinates, or 0 for the screen height.
+    int viewportWidth;      // Width of the part of the render texture that we're drawing into.
+    int viewportHeight;     // Height of the part of the render texture that we're drawing into.
+    float scale;            // The render scale.
+    float minScale;         // The smallest render scale.
+    float maxScale;         // The largest render scale.
+    double budget;          // How long should a frame take?
+    bool dynamic;           // Is dynamic resolution on?
+    int overBudgetFrames;   // How many frames in a row have been over budget?
+    int headroomFrames;     // How many frames in a row have had headroom?
+    double beginTime;       // When did scaled drawing begin?
+    double submitTime;      // How long did the last frame take to draw and submit?
+} scaling = {.width = 0,
+             .height = 0,
+             .scale = 1.0f,
+             .minScale = 0.5f,
+             .maxScale = 1.0f,
+             .budget = 1.0 / 60.0,
+             .dynamic = false};
+
+static float ClampRenderScale(float scale)
+{
+    return scale < scaling.minScale ? scaling.minScale : (scale > scaling.maxScale ? scaling.maxScale : scale);
+}
+
+BDRSDEF void SetScaledDrawingSize(int width, int height)
+{
+    scaling.width = width;
+    scaling.height = height;
+}
+
+BDRSDEF void SetRenderScaleRange(float minScale, float maxScale)
+{
+    scaling.minScale = minScale;
+    scaling.maxScale = maxScale;
+    scaling.scale = ClampRenderScale(scaling.scale);
+}
+
+BDRSDEF void SetRenderScale(float scale)
+{
+    scale = ClampRenderScale(scale);
+    if (scale != scaling.scale)
+    {
+        TraceLog(LOG_INFO, "SCALING: Render scale %.3f -> %.3f", scaling.scale, scale);
+        scaling.scale = scale;
+    }
+}
+
+BDRSDEF float GetRenderScale(void)
+{
+    return scaling.scale;
+}
+
+BDRSDEF void SetFrameBudget(double seconds)
+{
+    scaling.budget = seconds;
+}
+
+BDRSDEF void EnableDynamicResolution(bool enable)
+{
+    scaling.dynamic = enable;
+    scaling.overBudgetFrames = 0;
+    scaling.headroomFrames = 0;
+}
+
+BDRSDEF bool IsDynamicResolutionEnabled(void)
+{
+    return scaling.dynamic;
+}
+
+// Adjust the render scale from the last frame's timings.
+static void UpdateRenderScale(void)
+{
+    const double interval = GetFrameTime();
+    if (interval > scaling.budget * BDR_SCALING_OVER_BUDGET)
+    {
+        scaling.headroomFrames = 0;
+        if (++scaling.overBudgetFrames >= BDR_SCALING_DROP_FRAMES)
+        {
+            scaling.overBudgetFrames = 0;
+            SetRenderScale(scaling.scale - BDR_SCALING_STEP);
+        }
+    }
+    else if (scaling.submitTime < scaling.budget * BDR_SCALING_HEADROOM)
+    {
+        scaling.overBudgetFrames = 0;
+        if (++scaling.headroomFrames >= BDR_SCALING_RAISE_FRAMES)
+        {
+            scaling.headroomFrames = 0;
+            SetRenderScale(scaling.scale + BDR_SCALING_STEP);
+        }
+    }
+    else
+    {
+        scaling.overBudgetFrames = 0;
+        scaling.headroomFrames = 0;
+    }
+}
+
+// Make sure that the render texture is big enough for the maximum render scale at the current screen size.
+static void LoadScalingTarget(void)
+{
+    const int width = (int)((float)GetScreenWidth() * scaling.maxScale + 0.5f);
+    const int height = (int)((float)GetScreenHeight() * scaling.maxScale + 0.5f);
+    if (scaling.loaded && scaling.target.texture.width == width && scaling.target.texture.height == height)
+    {
+        return;
+    }
+
+    UnloadRenderScaling();
+    scaling.target = LoadRenderTexture(width, height);
+    SetTextureFilter(scaling.target.texture, TEXTURE_FILTER_BILINEAR);
+    scaling.loaded = true;
+}
+
+BDRSDEF void BeginScaledDrawing(void)
+{
+    if (scaling.dynamic)
+    {
+        UpdateRenderScale();
+    }
+    scaling.beginTime = GetTime();
+
+    const int screenWidth = GetScreenWidth();
+    const int screenHeight = GetScreenHeight();
+    const int width = scaling.width > 0 ? scaling.width : screenWidth;
+    const int height = scaling.height > 0 ? scaling.height : screenHeight;
+
+    // Draw straight to the screen if there's nothing to scale.
+    scaling.active = scaling.scale < 1.0f || width != screenWidth || height != screenHeight;
+    if (!scaling.active)
+    {
+        return;
+    }
+
+    LoadScalingTarget();
+    scaling.viewportWidth = (int)((float)screenWidth * scaling.scale + 0.5f);
+    scaling.viewportHeight = (int)((float)screenHeight * scaling.scale + 0.5f);
+
+    // Map the drawing coordinates onto the part of the render texture that we're using.
+    BeginTextureMode(scaling.target);
+    rlViewport(0, 0, scaling.viewportWidth, scaling.viewportHeight);
+    rlMatrixMode(RL_PROJECTION);
+    rlLoadIdentity();
+    rlOrtho(0, width, height, 0, 0.0, 1.0);
+    rlMatrixMode(RL_MODELVIEW);
+    rlLoadIdentity();
+}
+
+BDRSDEF void EndScaledDrawing(void)
+{
+    if (scaling.active)
+    {
+        EndTextureMode();
+
+        // Render textures are upside down, and we're only using the bottom left of this one.
+        const Rectangle source = {0, 0, (float)scaling.viewportWidth, (float)-scaling.viewportHeight};
+        const Rectangle dest = {0, 0, (float)GetScreenWidth(), (float)GetScreenHeight()};
+        DrawTexturePro(scaling.target.texture, source, dest, (Vector2){0, 0}, 0.0f, WHITE);
+    }
+
+    // Submit what we've drawn so far, so that the submit time includes it.
+    rlDrawRenderBatchActive();
+    scaling.submitTime = GetTime() - scaling.beginTime;
+}
+
+BDRSDEF void UnloadRenderScaling(void)
+{
+    if (scaling.loaded)
+    {
+        UnloadRenderTexture(scaling.target);
+        scaling.loaded = false;
+    }
+}
+
+#endif // BDR_SCALING_IMPLEMENTATION
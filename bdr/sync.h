@@ -0,0 +1,53 @@
+#pragma once
+
+// What the worker pool and the event log need from the platform to run threads of their own. Either BDR_SYNC_WIN32 or
+// BDR_SYNC_PTHREADS is defined, unless there are no threads, e.g., on the web without pthreads, in which case nothing is declared.
+
+#include <stddef.h>
+
+#if defined(_WIN32)
+#define BDR_SYNC_WIN32
+#elif !defined(__EMSCRIPTEN__) || defined(__EMSCRIPTEN_PTHREADS__)
+#define BDR_SYNC_PTHREADS
+#endif
+
+#if defined(BDR_SYNC_WIN32)
+
+// Declare what we need from Windows ourselves, because windows.h clashes with raylib.h.
+typedef struct
+{
+    void* ptr;
+} BdrLock;
+
+typedef struct
+{
+    void* ptr;
+} BdrCondition;
+
+typedef void* BdrThread;
+
+__declspec(dllimport) void __stdcall InitializeSRWLock(BdrLock* lock);
+__declspec(dllimport) void __stdcall AcquireSRWLockExclusive(BdrLock* lock);
+__declspec(dllimport) void __stdcall ReleaseSRWLockExclusive(BdrLock* lock);
+__declspec(dllimport) void __stdcall InitializeConditionVariable(BdrCondition* condition);
+__declspec(dllimport) int __stdcall SleepConditionVariableSRW(BdrCondition* condition, BdrLock* lock, unsigned long ms,
+                                                              unsigned long flags);
+__declspec(dllimport) void __stdcall WakeAllConditionVariable(BdrCondition* condition);
+__declspec(dllimport) void* __stdcall CreateThread(void* attributes, size_t stackSize, unsigned long(__stdcall* start)(void*),
+                                                   void* parameter, unsigned long flags, unsigned long* threadId);
+__declspec(dllimport) unsigned long __stdcall WaitForSingleObject(void* handle, unsigned long ms);
+__declspec(dllimport) int __stdcall CloseHandle(void* handle);
+__declspec(dllimport) unsigned long __stdcall GetActiveProcessorCount(unsigned short group);
+
+#define BDR_INFINITE 0xffffffffu
+#define BDR_ALL_PROCESSOR_GROUPS 0xffff
+
+#elif defined(BDR_SYNC_PTHREADS)
+
+#include <pthread.h>
+
+typedef pthread_mutex_t BdrLock;
+typedef pthread_cond_t BdrCondition;
+typedef pthread_t BdrThread;
+
+#endif
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_THREADS_STATIC)
+#define BDRHDEF static
+#else
+#define BDRHDEF extern
+#endif
+
+#if !defined(BDR_THREADS_MAX_WORKERS)
+#define BDR_THREADS_MAX_WORKERS 15 // The most worker threads that the pool will start, not counting the calling thread.
+#endif
+
+// A small pool of worker threads for splitting loops into chunks. The thread that calls ParallelFor() works on chunks too, so a
+// pool with no workers runs everything on the calling thread. That's what happens on platforms without threads, e.g., the web.
+//
+// ParallelFor() must only be called from one thread at a time, and not from inside a chunk.
+
+// Process indices [start, end) of a loop.
+typedef void (*ParallelForFunction)(void* data, int start, int end);
+
+// clang-format off
+
+BDRHDEF bool InitWorkerPool(int workers);                                                 // Start workers, or one per spare CPU if negative.
+BDRHDEF void CloseWorkerPool(void);                                                       // Stop the workers.
+BDRHDEF int GetWorkerCount(void);                                                         // Get the number of workers.
+BDRHDEF int GetProcessorCount(void);                                                      // Get the number of processors.
+BDRHDEF void ParallelFor(int count, int grain, ParallelForFunction function, void* data); // Run a loop in chunks of grain indices.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_THREADS_IMPLEMENTATION)
+
+#include "sync.h"
+
+#if defined(BDR_SYNC_PTHREADS)
+#include <unistd.h>
+#endif
+
+static struct
+{
+    int workers;                  // How many workers are running?
+    bool quit;                    // Should the workers stop?
+    ParallelForFunction function; // The loop being run, or NULL.
+    void* data;                   // The loop's data.
+    int count;                    // How many indices does the loop have?
+    int grain;                    // How many indices are there in a chunk?
+    int next;                     // Where does the next unclaimed chunk start?
+    int pending;                  // How many chunks haven't finished yet?
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    BdrLock lock;                               // Protects everything above.
+    BdrCondition workReady;                     // Signalled when there is a new loop, or when the workers should stop.
+    BdrCondition workDone;                      // Signalled when the last chunk of a loop finishes.
+    BdrThread threads[BDR_THREADS_MAX_WORKERS]; // The workers.
+#endif
+} pool = {.workers = 0};
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+
+#if defined(BDR_SYNC_WIN32)
+#define BdrInitLock(lock) InitializeSRWLock(lock)
+#define BdrDestroyLock(lock) (void)(lock)
+#define BdrAcquire(lock) AcquireSRWLockExclusive(lock)
+#define BdrRelease(lock) ReleaseSRWLockExclusive(lock)
+#define BdrInitCondition(condition) InitializeConditionVariable(condition)
+#define BdrDestroyCondition(condition) (void)(condition)
+#define BdrWait(condition, lock) SleepConditionVariableSRW(condition, lock, BDR_INFINITE, 0)
+#define BdrWakeAll(condition) WakeAllConditionVariable(condition)
+#else
+#define BdrInitLock(lock) pthread_mutex_init(lock, NULL)
+#define BdrDestroyLock(lock) pthread_mutex_destroy(lock)
+#define BdrAcquire(lock) pthread_mutex_lock(lock)
+#define BdrRelease(lock) pthread_mutex_unlock(lock)
+#define BdrInitCondition(condition) pthread_cond_init(condition, NULL)
+#define BdrDestroyCondition(condition) pthread_cond_destroy(condition)
+#define BdrWait(condition, lock) pthread_cond_wait(condition, lock)
+#define BdrWakeAll(condition) pthread_cond_broadcast(condition)
+#endif
+
+// Claim and run chunks of the current loop until there are none left. Called with the lock held, and returns with it held.
+static void RunChunks(void)
+{
+    while (pool.function != NULL && pool.next < pool.count)
+    {
+        const int start = pool.next;
+        const int end = start + pool.grain < pool.count ? start + pool.grain : pool.count;
+        const ParallelForFunction function = pool.function;
+        void* data = pool.data;
+        pool.next = end;
+
+        BdrRelease(&pool.lock);
+        function(data, start, end);
+        BdrAcquire(&pool.lock);
+
+        if (--pool.pending == 0)
+        {
+            BdrWakeAll(&pool.workDone);
+        }
+    }
+}
+
+static void RunWorker(void)
+{
+    BdrAcquire(&pool.lock);
+    for (;;)
+    {
+        while (!pool.quit && (pool.function == NULL || pool.next >= pool.count))
+        {
+            BdrWait(&pool.workReady, &pool.lock);
+        }
+        if (pool.quit)
+        {
+            break;
+        }
+        RunChunks();
+    }
+    BdrRelease(&pool.lock);
+}
+
+#if defined(BDR_SYNC_WIN32)
+static unsigned long __stdcall WorkerThread(void* parameter)
+{
+    (void)parameter;
+    RunWorker();
+    return 0;
+}
+#else
+static void* WorkerThread(void* parameter)
+{
+    (void)parameter;
+    RunWorker();
+    return NULL;
+}
+#endif
+
+#endif // BDR_SYNC_WIN32 || BDR_SYNC_PTHREADS
+
+BDRHDEF int GetProcessorCount(void)
+{
+#if defined(BDR_SYNC_WIN32)
+    return (int)GetActiveProcessorCount(BDR_ALL_PROCESSOR_GROUPS);
+#elif defined(BDR_SYNC_PTHREADS)
+    const long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+BDRHDEF bool InitWorkerPool(int workers)
+{
+    CloseWorkerPool();
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    if (workers < 0)
+    {
+        workers = GetProcessorCount() - 1;
+    }
+    if (workers > BDR_THREADS_MAX_WORKERS)
+    {
+        workers = BDR_THREADS_MAX_WORKERS;
+    }
+    if (workers == 0)
+    {
+        return true;
+    }
+
+    BdrInitLock(&pool.lock);
+    BdrInitCondition(&pool.workReady);
+    BdrInitCondition(&pool.workDone);
+    pool.quit = false;
+    pool.function = NULL;
+
+    for (int i = 0; i < workers; i++)
+    {
+#if defined(BDR_SYNC_WIN32)
+        pool.threads[i] = CreateThread(NULL, 0, WorkerThread, NULL, 0, NULL);
+        const bool started = pool.threads[i] != NULL;
+#else
+        const bool started = pthread_create(&pool.threads[i], NULL, WorkerThread, NULL) == 0;
+#endif
+        if (!started)
+        {
+            break;
+        }
+        ++pool.workers;
+    }
+
+    return pool.workers == workers;
+#else
+    (void)workers;
+    return workers <= 0;
+#endif
+}
+
+BDRHDEF void CloseWorkerPool(void)
+{
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    if (pool.workers == 0)
+    {
+        return;
+    }
+
+    BdrAcquire(&pool.lock);
+    pool.quit = true;
+    BdrWakeAll(&pool.workReady);
+    BdrRelease(&pool.lock);
+
+    for (int i = 0; i < pool.workers; i++)
+    {
+#if defined(BDR_SYNC_WIN32)
+        WaitForSingleObject(pool.threads[i], BDR_INFINITE);
+        CloseHandle(pool.threads[i]);
+#else
+        pthread_join(pool.threads[i], NULL);
+#endif
+    }
+    pool.workers = 0;
+
+    BdrDestroyCondition(&pool.workDone);
+    BdrDestroyCondition(&pool.workReady);
+    BdrDestroyLock(&pool.lock);
+#endif
+}
+
+BDRHDEF int GetWorkerCount(void)
+{
+    return pool.workers;
+}
+
+BDRHDEF void ParallelFor(int count, int grain, ParallelForFunction function, void* data)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+    if (grain < 1)
+    {
+        grain = 1;
+    }
+
+    // Don't wake the workers if there's nothing to share.
+    if (pool.workers == 0 || count <= grain)
+    {
+        function(data, 0, count);
+        return;
+    }
+
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    BdrAcquire(&pool.lock);
+    pool.function = function;
+    pool.data = data;
+    pool.count = count;
+    pool.grain = grain;
+    pool.next = 0;
+    pool.pending = (count + grain - 1) / grain;
+    BdrWakeAll(&pool.workReady);
+
+    // Help out, then wait for any chunks that the workers are still running.
+    RunChunks();
+    while (pool.pending > 0)
+    {
+        BdrWait(&pool.workDone, &pool.lock);
+    }
+    pool.function = NULL;
+    BdrRelease(&pool.lock);
+#endif
+}
+
+#endif // BDR_THREADS_IMPLEMENTATION
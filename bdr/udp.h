@@ -0,0 +1,323 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_UDP_STATIC)
+#define BDRNDEF static
+#else
+#define BDRNDEF extern
+#endif
+
+// Non-blocking UDP sockets on the loopback interface, for running a game's server and its clients as separate processes on the
+// same machine. There are no sockets on the web, so everything there fails.
+
+// An IPv4 address and port, in host byte order.
+typedef struct
+{
+    unsigned int host;   // The address, e.g., 0x7f000001 for 127.0.0.1.
+    unsigned short port; // The port.
+} UdpAddress;
+
+// A socket.
+typedef struct
+{
+    intptr_t handle; // The operating system's handle for the socket, or -1 if it isn't open.
+} UdpSocket;
+
+// clang-format off
+
+BDRNDEF bool InitUdp(void);                                                        // Start up sockets. Windows needs this.
+BDRNDEF void CloseUdp(void);                                                       // Shut down sockets.
+BDRNDEF bool OpenUdpSocket(UdpSocket* udp, unsigned short port);                   // Open a socket on the loopback interface, on any free port if it's 0.
+BDRNDEF void CloseUdpSocket(UdpSocket* udp);                                       // Close a socket.
+BDRNDEF UdpAddress GetLoopbackAddress(unsigned short port);                        // Get the address of a port on the loopback interface.
+BDRNDEF bool IsSameUdpAddress(UdpAddress a, UdpAddress b);                         // Check if two addresses are the same.
+BDRNDEF bool SendUdp(UdpSocket udp, UdpAddress to, const void* data, int size);     // Send a datagram.
+BDRNDEF int ReceiveUdp(UdpSocket udp, UdpAddress* from, void* data, int capacity); // Receive a datagram, returning its size, or 0 if there isn't one.
+BDRNDEF bool WaitForUdp(UdpSocket udp, double seconds);                            // Wait for a datagram to arrive, for up to the given time.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_UDP_IMPLEMENTATION)
+
+#include <stddef.h>
+
+#if defined(_WIN32)
+#define BDR_UDP_WINSOCK
+#elif !defined(__EMSCRIPTEN__)
+#define BDR_UDP_POSIX
+#endif
+
+#if defined(BDR_UDP_WINSOCK)
+
+// Declare what we need from Winsock ourselves, because winsock2.h brings in windows.h, which clashes with raylib.h. Link with
+// ws2_32.
+#define BDR_AF_INET 2
+#define BDR_SOCK_DGRAM 2
+#define BDR_IPPROTO_UDP 17
+#define BDR_FIONBIO 0x8004667e
+#define BDR_WSAECONNRESET 10054
+#define BDR_WINSOCK_VERSION 0x0202
+#define BDR_FD_SETSIZE 64
+
+typedef struct
+{
+    unsigned short family;
+    unsigned short port;
+    unsigned int addr;
+    char zero[8];
+} BdrSocketAddress;
+
+typedef struct
+{
+    unsigned int count;
+    uintptr_t sockets[BDR_FD_SETSIZE];
+} BdrSocketSet;
+
+typedef struct
+{
+    long seconds;
+    long microseconds;
+} BdrTimeout;
+
+// Big enough for a WSADATA, which we never look at.
+typedef struct
+{
+    double align;
+    char data[512];
+} BdrWinsockData;
+
+__declspec(dllimport) int __stdcall WSAStartup(unsigned short version, BdrWinsockData* data);
+__declspec(dllimport) int __stdcall WSACleanup(void);
+__declspec(dllimport) int __stdcall WSAGetLastError(void);
+__declspec(dllimport) uintptr_t __stdcall socket(int family, int type, int protocol);
+__declspec(dllimport) int __stdcall bind(uintptr_t s, const BdrSocketAddress* address, int size);
+__declspec(dllimport) int __stdcall closesocket(uintptr_t s);
+__declspec(dllimport) int __stdcall ioctlsocket(uintptr_t s, long command, unsigned long* argument);
+__declspec(dllimport) int __stdcall sendto(uintptr_t s, const char* data, int size, int flags, const BdrSocketAddress* to,
+                                           int toSize);
+__declspec(dllimport) int __stdcall recvfrom(uintptr_t s, char* data, int capacity, int flags, BdrSocketAddress* from,
+                                             int* fromSize);
+__declspec(dllimport) int __stdcall select(int count, BdrSocketSet* read, BdrSocketSet* write, BdrSocketSet* error,
+                                           const BdrTimeout* timeout);
+__declspec(dllimport) unsigned short __stdcall htons(unsigned short value);
+__declspec(dllimport) unsigned long __stdcall htonl(unsigned long value);
+__declspec(dllimport) unsigned short __stdcall ntohs(unsigned short value);
+__declspec(dllimport) unsigned long __stdcall ntohl(unsigned long value);
+
+typedef BdrSocketAddress BdrAddressIn;
+typedef int BdrAddressSize;
+
+#elif defined(BDR_UDP_POSIX)
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+typedef struct sockaddr_in BdrAddressIn;
+typedef socklen_t BdrAddressSize;
+
+#endif
+
+#if defined(BDR_UDP_WINSOCK) || defined(BDR_UDP_POSIX)
+
+static BdrAddressIn ToAddressIn(UdpAddress address)
+{
+    BdrAddressIn in = {0};
+#if defined(BDR_UDP_WINSOCK)
+    in.family = BDR_AF_INET;
+    in.port = htons(address.port);
+    in.addr = (unsigned int)htonl(address.host);
+#else
+    in.sin_family = AF_INET;
+    in.sin_port = htons(address.port);
+    in.sin_addr.s_addr = htonl(address.host);
+#endif
+    return in;
+}
+
+static UdpAddress FromAddressIn(const BdrAddressIn* in)
+{
+#if defined(BDR_UDP_WINSOCK)
+    return (UdpAddress){.host = (unsigned int)ntohl(in->addr), .port = ntohs(in->port)};
+#else
+    return (UdpAddress){.host = ntohl(in->sin_addr.s_addr), .port = ntohs(in->sin_port)};
+#endif
+}
+
+#endif // BDR_UDP_WINSOCK || BDR_UDP_POSIX
+
+BDRNDEF bool InitUdp(void)
+{
+#if defined(BDR_UDP_WINSOCK)
+    BdrWinsockData data;
+    return WSAStartup(BDR_WINSOCK_VERSION, &data) == 0;
+#elif defined(BDR_UDP_POSIX)
+    return true;
+#else
+    return false;
+#endif
+}
+
+BDRNDEF void CloseUdp(void)
+{
+#if defined(BDR_UDP_WINSOCK)
+    WSACleanup();
+#endif
+}
+
+BDRNDEF bool OpenUdpSocket(UdpSocket* udp, unsigned short port)
+{
+    udp->handle = -1;
+
+#if defined(BDR_UDP_WINSOCK) || defined(BDR_UDP_POSIX)
+#if defined(BDR_UDP_WINSOCK)
+    const intptr_t handle = (intptr_t)socket(BDR_AF_INET, BDR_SOCK_DGRAM, BDR_IPPROTO_UDP);
+#else
+    const intptr_t handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#endif
+    if (handle == -1)
+    {
+        return false;
+    }
+
+    udp->handle = handle;
+    const BdrAddressIn address = ToAddressIn(GetLoopbackAddress(port));
+#if defined(BDR_UDP_WINSOCK)
+    unsigned long nonBlocking = 1;
+    const bool opened = bind((uintptr_t)handle, &address, sizeof(address)) == 0 &&
+                        ioctlsocket((uintptr_t)handle, BDR_FIONBIO, &nonBlocking) == 0;
+#else
+    const int flags = fcntl((int)handle, F_GETFL, 0);
+    const bool opened = bind((int)handle, (const struct sockaddr*)&address, sizeof(address)) == 0 && flags != -1 &&
+                        fcntl((int)handle, F_SETFL, flags | O_NONBLOCK) != -1;
+#endif
+    if (!opened)
+    {
+        CloseUdpSocket(udp);
+    }
+    return opened;
+#else
+    (void)port;
+    return false;
+#endif
+}
+
+BDRNDEF void CloseUdpSocket(UdpSocket* udp)
+{
+    if (udp->handle == -1)
+    {
+        return;
+    }
+#if defined(BDR_UDP_WINSOCK)
+    closesocket((uintptr_t)udp->handle);
+#elif defined(BDR_UDP_POSIX)
+    close((int)udp->handle);
+#endif
+    udp->handle = -1;
+}
+
+BDRNDEF UdpAddress GetLoopbackAddress(unsigned short port)
+{
+    return (UdpAddress){.host = 0x7f000001, .port = port};
+}
+
+BDRNDEF bool IsSameUdpAddress(UdpAddress a, UdpAddress b)
+{
+    return a.host == b.host && a.port == b.port;
+}
+
+BDRNDEF bool SendUdp(UdpSocket udp, UdpAddress to, const void* data, int size)
+{
+#if defined(BDR_UDP_WINSOCK) || defined(BDR_UDP_POSIX)
+    const BdrAddressIn address = ToAddressIn(to);
+#if defined(BDR_UDP_WINSOCK)
+    return sendto((uintptr_t)udp.handle, (const char*)data, size, 0, &address, sizeof(address)) == size;
+#else
+    return sendto((int)udp.handle, data, (size_t)size, 0, (const struct sockaddr*)&address, sizeof(address)) == size;
+#endif
+#else
+    (void)udp;
+    (void)to;
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+BDRNDEF int ReceiveUdp(UdpSocket udp, UdpAddress* from, void* data, int capacity)
+{
+#if defined(BDR_UDP_WINSOCK) || defined(BDR_UDP_POSIX)
+    for (;;)
+    {
+        BdrAddressIn address;
+        BdrAddressSize addressSize = sizeof(address);
+#if defined(BDR_UDP_WINSOCK)
+        const int size = recvfrom((uintptr_t)udp.handle, (char*)data, capacity, 0, &address, &addressSize);
+
+        // Windows reports an earlier datagram that couldn't be delivered as a failure of this one, so skip it.
+        if (size < 0 && WSAGetLastError() == BDR_WSAECONNRESET)
+        {
+            continue;
+        }
+#else
+        const int size = (int)recvfrom((int)udp.handle, data, (size_t)capacity, 0, (struct sockaddr*)&address, &addressSize);
+#endif
+        if (size <= 0)
+        {
+            return 0;
+        }
+        *from = FromAddressIn(&address);
+        return size;
+    }
+#else
+    (void)udp;
+    (void)from;
+    (void)data;
+    (void)capacity;
+    return 0;
+#endif
+}
+
+BDRNDEF bool WaitForUdp(UdpSocket udp, double seconds)
+{
+#if defined(BDR_UDP_WINSOCK) || defined(BDR_UDP_POSIX)
+    if (seconds < 0.0)
+    {
+        seconds = 0.0;
+    }
+    const long wholeSeconds = (long)seconds;
+    const long microseconds = (long)((seconds - (double)wholeSeconds) * 1e6);
+#if defined(BDR_UDP_WINSOCK)
+    BdrSocketSet readable = {.count = 1, .sockets = {(uintptr_t)udp.handle}};
+    const BdrTimeout timeout = {.seconds = wholeSeconds, .microseconds = microseconds};
+    return select(0, &readable, NULL, NULL, &timeout) > 0;
+#else
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET((int)udp.handle, &readable);
+    struct timeval timeout = {.tv_sec = wholeSeconds, .tv_usec = microseconds};
+    return select((int)udp.handle + 1, &readable, NULL, NULL, &timeout) > 0;
+#endif
+#else
+    (void)udp;
+    (void)seconds;
+    return false;
+#endif
+}
+
+#endif // BDR_UDP_IMPLEMENTATION
@@ -0,0 +1,230 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(BDR_UI_STATIC)
+#define BDRUDEF static
+#else
+#define BDRUDEF extern
+#endif
+
+#if !defined(BDR_UI_MAX_TEXT)
+#define BDR_UI_MAX_TEXT 64
+#endif
+
+// How a label's text is aligned within its bounds.
+typedef enum
+{
+    UI_ALIGN_LEFT,
+    UI_ALIGN_CENTRE
+} UiAlign;
+
+// A glyph quad, as it will be passed to DrawTexturePro().
+typedef struct
+{
+    Rectangle source; // Where the glyph is in the font's texture.
+    Rectangle dest;   // Where the glyph is drawn on the screen.
+} UiGlyph;
+
+// A retained text label. Its glyph quads are laid out when its text, font or bounds change, rather than every frame.
+typedef struct
+{
+    Font font;                        // The font to draw with.
+    float fontSize;                   // The font size.
+    float spacing;                    // Extra spacing between glyphs.
+    UiAlign align;                    // Horizontal alignment within the bounds.
+    Rectangle bounds;                 // Text wraps at the right edge and is clipped at the bottom edge, as with DrawTextRec().
+    Color colour;                     // The colour to draw with. Changing this doesn't need a new layout.
+    bool visible;                     // Is the label drawn?
+    bool dirty;                       // Does the label need to be laid out again before it is drawn?
+    char text[BDR_UI_MAX_TEXT];       // The label's text.
+    int glyphCount;                   // The number of laid out glyphs.
+    UiGlyph glyphs[BDR_UI_MAX_TEXT];  // The laid out glyphs.
+} UiLabel;
+
+// clang-format off
+
+BDRUDEF void InitUiLabel(UiLabel* label, Font font, float fontSize, float spacing, UiAlign align); // Initialise a label.
+BDRUDEF void SetUiLabelText(UiLabel* label, const char* text);          // Set a label's text, marking it dirty if it changed.
+BDRUDEF void SetUiLabelBounds(UiLabel* label, Rectangle bounds);        // Set a label's bounds, marking it dirty if they changed.
+BDRUDEF void SetUiLabelColour(UiLabel* label, Color colour);            // Set a label's colour.
+BDRUDEF void SetUiLabelVisible(UiLabel* label, bool visible);           // Show or hide a label.
+BDRUDEF void LayoutUiLabel(UiLabel* label);                             // Lay out a label's glyphs if it is dirty.
+BDRUDEF void DrawUiLabel(UiLabel* label);                               // Draw a label, laying it out first if it is dirty.
+BDRUDEF int GetUiLayoutCount(void);                                     // Get the number of label layouts so far, for diagnostics.
+
+// clang-format on
+
+#ifdef __cplusplus
+}
+#endif
+
+// --- Implementation --------------------------------------------------------------------------------------------------------------
+
+#if defined(BDR_UI_IMPLEMENTATION)
+
+#include <string.h>
+
+static int uiLayoutCount = 0;
+
+BDRUDEF void InitUiLabel(UiLabel* label, Font font, float fontSize, float spacing, UiAlign align)
+{
+    label->font = font;
+    label->fontSize = fontSize;
+    label->spacing = spacing;
+    label->align = align;
+    label->bounds = (Rectangle){0, 0, 0, 0};
+    label->colour = RAYWHITE;
+    label->visible = true;
+    label->dirty = true;
+    label->text[0] = '\0';
+    label->glyphCount = 0;
+}
+
+BDRUDEF void SetUiLabelText(UiLabel* label, const char* text)
+{
+    if (strncmp(label->text, text, BDR_UI_MAX_TEXT - 1) != 0)
+    {
+        strncpy(label->text, text, BDR_UI_MAX_TEXT - 1);
+        label->text[BDR_UI_MAX_TEXT - 1] = '\0';
+        label->dirty = true;
+    }
+}
+
+BDRUDEF void SetUiLabelBounds(UiLabel* label, Rectangle bounds)
+{
+    const Rectangle b = label->bounds;
+    if (b.x != bounds.x || b.y != bounds.y || b.width != bounds.width || b.height != bounds.height)
+    {
+        label->bounds = bounds;
+        label->dirty = true;
+    }
+}
+
+BDRUDEF void SetUiLabelColour(UiLabel* label, Color colour)
+{
+    label->colour = colour;
+}
+
+BDRUDEF void SetUiLabelVisible(UiLabel* label, bool visible)
+{
+    label->visible = visible;
+}
+
+// Lay out the glyphs the same way as DrawTextRec() does without word wrap, and DrawTextCodepoint() does for each glyph.
+BDRUDEF void LayoutUiLabel(UiLabel* label)
+{
+    if (!label->dirty)
+    {
+        return;
+    }
+
+    const Font font = label->font;
+    const Rectangle bounds = label->bounds;
+    const float scaleFactor = label->fontSize / (float)font.baseSize;
+    const float lineHeight = (float)(font.baseSize + font.baseSize / 2) * scaleFactor;
+    const float padding = (float)font.glyphPadding;
+    const int length = (int)TextLength(label->text);
+
+    float textOffsetX = 0.0f;
+    float textOffsetY = 0.0f;
+    float textWidth = 0.0f;
+    label->glyphCount = 0;
+
+    for (int i = 0; i < length; i++)
+    {
+        int codepointByteCount = 0;
+        const int codepoint = GetCodepoint(&label->text[i], &codepointByteCount);
+        const int index = GetGlyphIndex(font, codepoint);
+        if (codepoint == 0x3f)
+        {
+            codepointByteCount = 1;
+        }
+        i += codepointByteCount - 1;
+
+        if (codepoint == '\n')
+        {
+            textOffsetY += lineHeight;
+            textOffsetX = 0;
+            continue;
+        }
+
+        float glyphWidth = (font.glyphs[index].advanceX == 0) ? font.recs[index].width * scaleFactor
+                                                              : (float)font.glyphs[index].advanceX * scaleFactor;
+        if (i + 1 < length)
+        {
+            glyphWidth += label->spacing;
+        }
+
+        if (textOffsetX + glyphWidth > bounds.width)
+        {
+            textOffsetY += lineHeight;
+            textOffsetX = 0;
+        }
+
+        // When the text overflows the bounds, stop.
+        if (textOffsetY + (float)font.baseSize * scaleFactor > bounds.height)
+        {
+            break;
+        }
+
+        if (codepoint != ' ' && codepoint != '\t')
+        {
+            const Rectangle rec = font.recs[index];
+            UiGlyph* glyph = &label->glyphs[label->glyphCount++];
+            glyph->source = (Rectangle){rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding};
+            glyph->dest = (Rectangle){bounds.x + textOffsetX + ((float)font.glyphs[index].offsetX - padding) * scaleFactor,
+                                      bounds.y + textOffsetY + ((float)font.glyphs[index].offsetY - padding) * scaleFactor,
+                                      (rec.width + 2.0f * padding) * scaleFactor, (rec.height + 2.0f * padding) * scaleFactor};
+        }
+
+        textOffsetX += glyphWidth;
+        if (textOffsetX > textWidth)
+        {
+            textWidth = textOffsetX;
+        }
+    }
+
+    if (label->align == UI_ALIGN_CENTRE)
+    {
+        const float shift = (bounds.width - textWidth) / 2;
+        for (int i = 0; i < label->glyphCount; i++)
+        {
+            label->glyphs[i].dest.x += shift;
+        }
+    }
+
+    label->dirty = false;
+    ++uiLayoutCount;
+}
+
+BDRUDEF void DrawUiLabel(UiLabel* label)
+{
+    if (!label->visible)
+    {
+        return;
+    }
+
+    LayoutUiLabel(label);
+
+    // Every glyph comes from the same texture, so these all end up in the same batch.
+    const Texture2D texture = label->font.texture;
+    const Color colour = label->colour;
+    for (int i = 0; i < label->glyphCount; i++)
+    {
+        DrawTexturePro(texture, label->glyphs[i].source, label->glyphs[i].dest, (Vector2){0, 0}, 0.0f, colour);
+    }
+}
+
+BDRUDEF int GetUiLayoutCount(void)
+{
+    return uiLayoutCount;
+}
+
+#endif // BDR_UI_IMPLEMENTATION
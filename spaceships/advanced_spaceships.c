@@ -1,6 +1,16 @@
 #define BDR_LOOP_IMPLEMENTATION
 #define BDR_LOOP_SHOULD_QUIT ShouldQuit
+#define BDR_LATENCY_IMPLEMENTATION
+#define BDR_LAYERS_IMPLEMENTATION
+#define BDR_PACK_IMPLEMENTATION
+#define BDR_SCALING_IMPLEMENTATION
+#define BDR_UI_IMPLEMENTATION
 #include "bdr/loop.h"
+#include "bdr/latency.h"
+#include "bdr/layers.h"
+#include "bdr/pack.h"
+#include "bdr/scaling.h"
+#include "bdr/ui.h"
 #include "raylib.h"
 #include "spaceships.h"
 
@@ -105,6 +115,9 @@ void Update(double elapsed)
 
 void CheckTriggers(void)
 {
+    // Sample every controller once, for the screens to use.
+    SampleControllers();
+
     if (IsKeyPressed(KEY_F11))
     {
         ToggleFullscreen();
@@ -116,6 +129,19 @@ void CheckTriggers(void)
         SetTargetFPS(renderFps);
     }
 
+    // Toggle input latency tracking. The histograms are shown on the playing screen, and logged when tracking is turned off.
+    if (IsKeyPressed(KEY_F9))
+    {
+        EnableLatencyTracking(!IsLatencyTrackingEnabled());
+    }
+
+    // Toggle dynamic resolution.
+    if (IsKeyPressed(KEY_F8))
+    {
+        EnableDynamicResolution(!IsDynamicResolutionEnabled());
+        SetRenderScale(1.0f);
+    }
+
     switch (currentScreen)
     {
     case MENU:
@@ -152,6 +178,9 @@ void Draw(double alpha)
         EndDrawing();
         break;
     }
+
+    // EndDrawing() has presented the frame.
+    MarkFramePresented(GetTime());
 }
 
 #if !defined(PLATFORM_WEB) && !defined(EMSCRIPTEN)
@@ -169,10 +198,20 @@ int main(void)
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Advanced Spaceships");
     SetTargetFPS(renderFps);
     SetExitKey(0);
+    MountAssetPack("assets/assets.pak");
+
+    // Drop the resolution to keep up with the slow frame rate, whichever frame rate we're aiming for.
+    SetRenderScaleRange(0.5f, 1.0f);
+    SetFrameBudget(1.0 / SLOW_FPS);
+    EnableDynamicResolution(true);
+
     InitScreens();
 
     RunMainLoop();
 
+    EnableLatencyTracking(false);
+    UnmountAssetPack();
+    UnloadRenderScaling();
     CloseWindow();
 
     return 0;
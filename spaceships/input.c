@@ -0,0 +1,228 @@
+#include "raylib.h"
+#include "spaceships.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#define MAX_KEY_BINDINGS 6
+#define MAX_BUTTON_BINDINGS 5
+
+#define BIT(action) (1u << (action))
+
+// Latency tracking only times the inputs that drive a ship: thrust, reverse and the axes. Fire presses are
+// timed separately. An axis has to move by AXIS_EVENT_THRESHOLD to count, so that an analogue stick's jitter doesn't.
+#define DRIVING_ACTIONS (BIT(INPUT_THRUST) | BIT(INPUT_REVERSE))
+#define AXIS_EVENT_THRESHOLD 0.25f
+
+// A key or button and the actions that it drives.
+typedef struct
+{
+    int input;           // The raylib key or gamepad button.
+    unsigned int actions; // The actions that it drives, one bit per InputAction.
+} Binding;
+
+// A pair of keys that drive an axis from -1 to +1.
+typedef struct
+{
+    KeyboardKey negative;
+    KeyboardKey positive;
+} KeyAxis;
+
+// The state of every controller, sampled once per frame.
+typedef struct
+{
+    bool available;                    // Is the controller connected?
+    unsigned int down;                 // Actions that are held down.
+    unsigned int pressed;              // Actions that went down at the last sample.
+    unsigned int released;             // Actions that went up at the last sample.
+    float axes[INPUT_AXIS_COUNT];      // Axis positions.
+    float eventAxes[INPUT_AXIS_COUNT]; // Axis positions at the last event.
+    double lastEventTime;              // When was thrust or reverse last pressed or released, or an axis last moved?
+} ControllerState;
+
+// Keyboard bindings. Each key is queried once per frame, however many actions it drives.
+static const Binding keyBindings[MAX_KEYBOARDS][MAX_KEY_BINDINGS] = {
+        // Left keyboard.
+        {{KEY_W, BIT(INPUT_THRUST) | BIT(INPUT_BACK)},
+         {KEY_S, BIT(INPUT_REVERSE) | BIT(INPUT_SELECT)},
+         {KEY_SPACE, BIT(INPUT_FIRE) | BIT(INPUT_START)},
+         {KEY_ESCAPE, BIT(INPUT_PAUSE)},
+         {KEY_R, BIT(INPUT_RESUME)},
+         {KEY_NULL, 0}},
+        // Right keyboard.
+        {{KEY_UP, BIT(INPUT_THRUST) | BIT(INPUT_BACK)},
+         {KEY_DOWN, BIT(INPUT_REVERSE) | BIT(INPUT_SELECT)},
+         {KEY_ENTER, BIT(INPUT_FIRE) | BIT(INPUT_START)},
+         {KEY_KP_ENTER, BIT(INPUT_FIRE)},
+         {KEY_ESCAPE, BIT(INPUT_PAUSE)},
+         {KEY_R, BIT(INPUT_RESUME)}}};
+
+static const KeyAxis keyAxes[MAX_KEYBOARDS][INPUT_AXIS_COUNT] = {
+        // Left keyboard.
+        {{KEY_A, KEY_D}, {KEY_Q, KEY_E}},
+        // Right keyboard.
+        {{KEY_LEFT, KEY_RIGHT}, {KEY_COMMA, KEY_PERIOD}}};
+
+// Gamepad bindings. These are the same for every gamepad.
+static const Binding buttonBindings[MAX_BUTTON_BINDINGS] = {
+        {GAMEPAD_BUTTON_RIGHT_FACE_DOWN, BIT(INPUT_THRUST) | BIT(INPUT_SELECT) | BIT(INPUT_START)},
+        {GAMEPAD_BUTTON_RIGHT_FACE_RIGHT, BIT(INPUT_REVERSE) | BIT(INPUT_BACK)},
+        {GAMEPAD_BUTTON_RIGHT_FACE_LEFT, BIT(INPUT_FIRE)},
+        {GAMEPAD_BUTTON_MIDDLE_RIGHT, BIT(INPUT_PAUSE)},
+        {GAMEPAD_BUTTON_MIDDLE_LEFT, BIT(INPUT_RESUME)}};
+
+static const GamepadAxis gamepadAxes[INPUT_AXIS_COUNT] = {GAMEPAD_AXIS_LEFT_X, GAMEPAD_AXIS_RIGHT_X};
+
+static ControllerState controllerStates[MAX_CONTROLLERS];
+static double sampleTime = 0.0;
+
+static const ControllerState* GetControllerState(ControllerId controller)
+{
+    if (controller < 0 || controller >= MAX_CONTROLLERS)
+    {
+        return NULL;
+    }
+    return &controllerStates[controller];
+}
+
+// Update a controller's state from the actions that are now down, working out which ones changed.
+static void SetControllerDown(ControllerState* state, unsigned int down)
+{
+    state->pressed = down & ~state->down;
+    state->released = state->down & ~down;
+    state->down = down;
+    if (((state->pressed | state->released) & DRIVING_ACTIONS) != 0)
+    {
+        state->lastEventTime = sampleTime;
+    }
+}
+
+// Note when a controller's axes have moved far enough since its last event to count as a new one.
+static void CheckAxisEvents(ControllerState* state)
+{
+    for (int i = 0; i < INPUT_AXIS_COUNT; i++)
+    {
+        if (fabsf(state->axes[i] - state->eventAxes[i]) >= AXIS_EVENT_THRESHOLD)
+        {
+            state->lastEventTime = sampleTime;
+            for (int j = 0; j < INPUT_AXIS_COUNT; j++)
+            {
+                state->eventAxes[j] = state->axes[j];
+            }
+            return;
+        }
+    }
+}
+
+static void SampleKeyboard(int keyboard, ControllerState* state)
+{
+    unsigned int down = 0;
+    for (int i = 0; i < MAX_KEY_BINDINGS && keyBindings[keyboard][i].input != KEY_NULL; i++)
+    {
+        if (IsKeyDown(keyBindings[keyboard][i].input))
+        {
+            down |= keyBindings[keyboard][i].actions;
+        }
+    }
+
+    state->available = true;
+    SetControllerDown(state, down);
+    for (int i = 0; i < INPUT_AXIS_COUNT; i++)
+    {
+        const KeyAxis axis = keyAxes[keyboard][i];
+        state->axes[i] = (IsKeyDown(axis.positive) ? 1.0f : 0.0f) - (IsKeyDown(axis.negative) ? 1.0f : 0.0f);
+    }
+    CheckAxisEvents(state);
+}
+
+static void SampleGamepad(GamepadNumber gamepad, ControllerState* state)
+{
+    if (!IsGamepadAvailable(gamepad))
+    {
+        // Forget everything about a disconnected gamepad so that it doesn't generate events if it comes back.
+        *state = (ControllerState){0};
+        return;
+    }
+
+    unsigned int down = 0;
+    for (int i = 0; i < MAX_BUTTON_BINDINGS; i++)
+    {
+        if (IsGamepadButtonDown(gamepad, buttonBindings[i].input))
+        {
+            down |= buttonBindings[i].actions;
+        }
+    }
+
+    state->available = true;
+    SetControllerDown(state, down);
+    for (int i = 0; i < INPUT_AXIS_COUNT; i++)
+    {
+        state->axes[i] = GetGamepadAxisMovement(gamepad, gamepadAxes[i]);
+    }
+    CheckAxisEvents(state);
+}
+
+void SampleControllers(void)
+{
+    sampleTime = GetTime();
+
+    SampleKeyboard(0, &controllerStates[CONTROLLER_KEYBOARD1]);
+    SampleKeyboard(1, &controllerStates[CONTROLLER_KEYBOARD2]);
+    SampleGamepad(GAMEPAD_PLAYER1, &controllerStates[CONTROLLER_GAMEPAD1]);
+    SampleGamepad(GAMEPAD_PLAYER2, &controllerStates[CONTROLLER_GAMEPAD2]);
+    SampleGamepad(GAMEPAD_PLAYER3, &controllerStates[CONTROLLER_GAMEPAD3]);
+    SampleGamepad(GAMEPAD_PLAYER4, &controllerStates[CONTROLLER_GAMEPAD4]);
+}
+
+bool IsControllerAvailable(ControllerId controller)
+{
+    const ControllerState* state = GetControllerState(controller);
+    return state != NULL && state->available;
+}
+
+bool IsControllerDown(ControllerId controller, InputAction action)
+{
+    const ControllerState* state = GetControllerState(controller);
+    return state != NULL && (state->down & BIT(action)) != 0;
+}
+
+bool IsControllerPressed(ControllerId controller, InputAction action)
+{
+    const ControllerState* state = GetControllerState(controller);
+    return state != NULL && (state->pressed & BIT(action)) != 0;
+}
+
+bool IsControllerReleased(ControllerId controller, InputAction action)
+{
+    const ControllerState* state = GetControllerState(controller);
+    return state != NULL && (state->released & BIT(action)) != 0;
+}
+
+bool IsAnyControllerReleased(InputAction action)
+{
+    for (int i = 0; i < MAX_CONTROLLERS; i++)
+    {
+        if ((controllerStates[i].released & BIT(action)) != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+float GetControllerAxis(ControllerId controller, InputAxis axis)
+{
+    const ControllerState* state = GetControllerState(controller);
+    return state != NULL ? state->axes[axis] : 0.0f;
+}
+
+double GetInputSampleTime(void)
+{
+    return sampleTime;
+}
+
+double GetControllerEventTime(ControllerId controller)
+{
+    const ControllerState* state = GetControllerState(controller);
+    return state != NULL ? state->lastEventTime : 0.0;
+}
@@ -1,3 +1,5 @@
+#include "bdr/layers.h"
+#include "bdr/scaling.h"
 #include "raylib.h"
 #include "spaceships.h"
 
@@ -14,23 +16,7 @@ static int screenHeight;
 static bool startRequested;
 static bool quitRequested;
 static MenuState state;
-
-static void CheckKeyboard(KeyboardKey selectKey, KeyboardKey quitKey)
-{
-    startRequested = startRequested || IsKeyReleased(selectKey);
-    quitRequested = quitRequested || IsKeyReleased(quitKey);
-}
-
-static void CheckGamepad(GamepadNumber gamepad, GamepadButton selectButton, GamepadButton quitButton)
-{
-    if (!IsGamepadAvailable(gamepad))
-    {
-        return;
-    }
-
-    startRequested = startRequested || IsGamepadButtonReleased(gamepad, selectButton);
-    quitRequested = quitRequested || IsGamepadButtonReleased(gamepad, quitButton);
-}
+static StaticLayer menuLayer;
 
 void InitMenuScreen(void)
 {
@@ -40,10 +26,12 @@ void InitMenuScreen(void)
     state = SHOWING_MENU;
     startRequested = false;
     quitRequested = false;
+    InitStaticLayer(&menuLayer);
 }
 
 void FinishMenuScreen(void)
 {
+    UnloadStaticLayer(&menuLayer);
 }
 
 void UpdateMenuScreen(void)
@@ -64,22 +52,28 @@ void UpdateMenuScreen(void)
 void DrawMenuScreen(double alpha)
 {
     (void)alpha;
-    ClearBackground(BLACK);
+
+    // Nothing on the menu changes, so it only needs drawing once.
+    if (BeginStaticLayer(&menuLayer, screenWidth, screenHeight))
+    {
+        ClearBackground(BLACK);
+        DrawText("MENU", 4, 4, 20, RAYWHITE);
+        int width = MeasureText("Press [Space] / Controller (A) to start", 20);
+        DrawText("Press [Space] / Controller (A) to start", (screenWidth - width) / 2, 7 * screenHeight / 8, 20, RAYWHITE);
+        EndStaticLayer(&menuLayer);
+    }
+
     BeginDrawing();
-    DrawText("MENU", 4, 4, 20, RAYWHITE);
-    int width = MeasureText("Press [Space] / Controller (A) to start", 20);
-    DrawText("Press [Space] / Controller (A) to start", (screenWidth - width) / 2, 7 * screenHeight / 8, 20, RAYWHITE);
+    BeginScaledDrawing();
+    DrawStaticLayer(&menuLayer, (Rectangle){0, 0, (float)screenWidth, (float)screenHeight});
+    EndScaledDrawing();
     EndDrawing();
 }
 
 void CheckTriggersMenuScreen(void)
 {
-    CheckKeyboard(KEY_SPACE, KEY_ESCAPE);
-    CheckKeyboard(KEY_ENTER, KEY_ESCAPE);
-    CheckGamepad(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_RIGHT_FACE_DOWN, GAMEPAD_BUTTON_MIDDLE_RIGHT);
-    CheckGamepad(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_RIGHT_FACE_DOWN, GAMEPAD_BUTTON_MIDDLE_RIGHT);
-    CheckGamepad(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_RIGHT_FACE_DOWN, GAMEPAD_BUTTON_MIDDLE_RIGHT);
-    CheckGamepad(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_RIGHT_FACE_DOWN, GAMEPAD_BUTTON_MIDDLE_RIGHT);
+    startRequested = startRequested || IsAnyControllerReleased(INPUT_START);
+    quitRequested = quitRequested || IsAnyControllerReleased(INPUT_PAUSE);
 }
 
 bool IsStartedMenuScreen(void)
@@ -1,3 +1,5 @@
+#include "bdr/latency.h"
+#include "bdr/scaling.h"
 #include "raylib.h"
 #include "raymath.h"
 #include "spaceships.h"
@@ -36,6 +38,7 @@ typedef struct
     Heading heading;
     ControllerId controller;
     int index;
+    double lastInputTime; // When did this ship last act on an input event from its controller?
 } Ship;
 
 typedef struct
@@ -109,69 +112,6 @@ static bool pauseOrQuitRequested;
 static bool resumeRequested;
 static PlayingState state;
 
-static bool IsControllerThrustDown(int controller)
-{
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_GAMEPAD2:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_GAMEPAD3:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_GAMEPAD4:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_KEYBOARD1:
-        return IsKeyDown(KEY_W);
-    case CONTROLLER_KEYBOARD2:
-        return IsKeyDown(KEY_UP);
-    default:
-        return false;
-    }
-}
-
-static bool IsControllerFirePressed(int controller)
-{
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_GAMEPAD2:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_GAMEPAD3:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_GAMEPAD4:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_KEYBOARD1:
-        return IsKeyPressed(KEY_SPACE);
-    case CONTROLLER_KEYBOARD2:
-        return IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_KP_ENTER);
-    default:
-        return false;
-    }
-}
-
-static float GetControllerTurnRate(int controller)
-{
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER1, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_GAMEPAD2:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER2, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_GAMEPAD3:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER3, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_GAMEPAD4:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER4, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_KEYBOARD1:
-        return (IsKeyDown(KEY_D) ? 1.0f : 0.0f) - (IsKeyDown(KEY_A) ? 1.0f : 0.0f);
-    case CONTROLLER_KEYBOARD2:
-        return (IsKeyDown(KEY_RIGHT) ? 1.0f : 0.0f) - (IsKeyDown(KEY_LEFT) ? 1.0f : 0.0f);
-    default:
-        return 0.0f;
-    }
-}
-
 static Vector2 Move(Position pos, Velocity vel)
 {
     pos = Vector2Add(pos, vel);
@@ -207,11 +147,18 @@ static void MoveShot(Shot* shot)
     shot->pos = Move(shot->pos, shot->vel);
 }
 
+// A destroyed ship will never act on the input that latency tracking is waiting for, if it's the ship's, so stop waiting.
+static void DestroyShip(Ship* ship)
+{
+    ship->alive = false;
+    CancelInputEvent();
+}
+
 static void CollideShipShot(Ship* ship, Shot* shot)
 {
     if (CheckCollisionCircles(ship->pos, SHIP_COLLISION_RADIUS, shot->pos, SHOT_COLLISION_RADIUS))
     {
-        ship->alive = false;
+        DestroyShip(ship);
         shot->alive = 0;
     }
 }
@@ -225,8 +172,8 @@ static void CollideShipShip(Ship* ship1, Ship* ship2)
 
     if (CheckCollisionCircles(ship1->pos, SHIP_COLLISION_RADIUS, ship2->pos, SHIP_COLLISION_RADIUS))
     {
-        ship1->alive = false;
-        ship2->alive = false;
+        DestroyShip(ship1);
+        DestroyShip(ship2);
     }
 }
 
@@ -253,12 +200,20 @@ static void UpdateShip(Ship* ship)
         return;
     }
 
+    // Let latency tracking know when we first act on a new input event.
+    const double eventTime = GetControllerEventTime(ship->controller);
+    if (eventTime > ship->lastInputTime)
+    {
+        ship->lastInputTime = eventTime;
+        MarkInputConsumed(ship->controller, eventTime, GetTime());
+    }
+
     // Rotate the ship.
-    float axis = GetControllerTurnRate(ship->controller);
+    float axis = GetControllerAxis(ship->controller, INPUT_AXIS_TURN);
     ship->heading += axis * MAX_ROTATION_SPEED;
 
     // Accelerate the ship.
-    if (IsControllerThrustDown(ship->controller))
+    if (IsControllerDown(ship->controller, INPUT_THRUST))
     {
         ship->vel.x += cosf((ship->heading - 90) * DEG2RAD) * SPEED;
         ship->vel.y += sinf((ship->heading - 90) * DEG2RAD) * SPEED;
@@ -268,16 +223,24 @@ static void UpdateShip(Ship* ship)
     MoveShip(ship);
 }
 
-static void CheckForFire(Ship* ship)
+static void CheckForInput(Ship* ship)
 {
     if (!ship->alive)
     {
         return;
     }
 
+    // Let latency tracking know about new input that drives the ship or fires. Only this ship can consume it.
+    const bool fired = IsControllerPressed(ship->controller, INPUT_FIRE);
+    if (fired || GetControllerEventTime(ship->controller) == GetInputSampleTime())
+    {
+        MarkInputEvent(ship->controller, GetInputSampleTime());
+    }
+
     // Fire.
-    if (IsControllerFirePressed(ship->controller))
+    if (fired)
     {
+        MarkInputConsumed(ship->controller, GetInputSampleTime(), GetTime());
         const int baseStart = ship->index * SHOTS_PER_PLAYER;
         const int baseEnd = baseStart + SHOTS_PER_PLAYER;
         for (int i = baseStart; i < baseEnd; i++)
@@ -398,23 +361,6 @@ static void DrawShot(const Shot* shot, Color colour, double alpha)
     DrawShotAt(pos, shot->heading, colour);
 }
 
-static void CheckKeyboard(KeyboardKey selectKey, KeyboardKey cancelKey)
-{
-    pauseOrQuitRequested = pauseOrQuitRequested || IsKeyReleased(selectKey);
-    resumeRequested = resumeRequested || IsKeyReleased(cancelKey);
-}
-
-static void CheckGamepad(GamepadNumber gamepad, GamepadButton selectButton, GamepadButton cancelButton)
-{
-    if (!IsGamepadAvailable(gamepad))
-    {
-        return;
-    }
-
-    pauseOrQuitRequested = pauseOrQuitRequested || IsGamepadButtonReleased(gamepad, selectButton);
-    resumeRequested = resumeRequested || IsGamepadButtonReleased(gamepad, cancelButton);
-}
-
 void InitPlayingScreen(int players, const ControllerId* controllers)
 {
     screenWidth = GetScreenWidth();
@@ -440,6 +386,7 @@ void InitPlayingScreen(int players, const ControllerId* controllers)
     {
         float angle = (float)i * (2 * 3.141592654f) / (float)numPlayers;
         ships[i].controller = controllers[i];
+        ships[i].lastInputTime = GetControllerEventTime(controllers[i]);
         ships[i].alive = true;
         ships[i].pos.x = (float)screenWidth / 2.0f + cosf(angle) * (float)screenHeight / 3;
         ships[i].pos.y = (float)screenHeight / 2.0f + sinf(angle) * (float)screenHeight / 3;
@@ -452,10 +399,12 @@ void InitPlayingScreen(int players, const ControllerId* controllers)
     {
         shots[i].alive = false;
     }
+    CancelInputEvent();
 }
 
 void FinishPlayingScreen(void)
 {
+    CancelInputEvent();
 }
 
 void UpdatePlayingScreen(void)
@@ -467,6 +416,7 @@ void UpdatePlayingScreen(void)
         {
             pauseOrQuitRequested = false;
             state = PAUSED;
+            CancelInputEvent();
         }
     }
     else if (state == PAUSED)
@@ -522,6 +472,7 @@ void UpdatePlayingScreen(void)
 void DrawPlayingScreen(double alpha)
 {
     BeginDrawing();
+    BeginScaledDrawing();
 
     ClearBackground(BLACK);
     DrawText("PLAYING", 4, 4, 20, RAYWHITE);
@@ -556,6 +507,9 @@ void DrawPlayingScreen(double alpha)
         }
     }
 
+    // Diagnostics are drawn at full resolution.
+    EndScaledDrawing();
+    DrawLatencyHistograms(4, 32);
     DrawFPS(screenWidth / 2 - 16, screenHeight - 24);
 
     EndDrawing();
@@ -564,17 +518,14 @@ void DrawPlayingScreen(double alpha)
 void CheckTriggersPlayingScreen(void)
 {
     // Check for player(s) choosing to pause / resume / quit.
-    CheckKeyboard(KEY_ESCAPE, KEY_R);
-    CheckGamepad(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
-    CheckGamepad(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
-    CheckGamepad(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
-    CheckGamepad(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
+    pauseOrQuitRequested = pauseOrQuitRequested || IsAnyControllerReleased(INPUT_PAUSE);
+    resumeRequested = resumeRequested || IsAnyControllerReleased(INPUT_RESUME);
 
     if (state == PLAYING)
     {
         for (int i = 0; i < numPlayers; i++)
         {
-            CheckForFire(&ships[i]);
+            CheckForInput(&ships[i]);
         }
     }
 }
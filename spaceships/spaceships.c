@@ -1,5 +1,15 @@
+#define BDR_LATENCY_IMPLEMENTATION
+#define BDR_LAYERS_IMPLEMENTATION
+#define BDR_PACK_IMPLEMENTATION
+#define BDR_SCALING_IMPLEMENTATION
+#define BDR_UI_IMPLEMENTATION
 #include "spaceships.h"
 
+#include "bdr/latency.h"
+#include "bdr/layers.h"
+#include "bdr/pack.h"
+#include "bdr/scaling.h"
+#include "bdr/ui.h"
 #include "raylib.h"
 
 #if defined(PLATFORM_WEB) || defined(EMSCRIPTEN)
@@ -131,6 +141,9 @@ static void Update(double elapsed)
 
 static void CheckTriggers(void)
 {
+    // Sample every controller once, for the screens to use.
+    SampleControllers();
+
     if (IsKeyPressed(KEY_F11))
     {
         ToggleFullscreen();
@@ -142,6 +155,19 @@ static void CheckTriggers(void)
         SetTargetFPS(renderFps);
     }
 
+    // Toggle input latency tracking. The histograms are shown on the playing screen, and logged when tracking is turned off.
+    if (IsKeyPressed(KEY_F9))
+    {
+        EnableLatencyTracking(!IsLatencyTrackingEnabled());
+    }
+
+    // Toggle dynamic resolution.
+    if (IsKeyPressed(KEY_F8))
+    {
+        EnableDynamicResolution(!IsDynamicResolutionEnabled());
+        SetRenderScale(1.0f);
+    }
+
     switch (currentScreen)
     {
     case MENU:
@@ -174,6 +200,9 @@ static void Draw(double alpha)
     default:
         break;
     }
+
+    // EndDrawing() has presented the frame.
+    MarkFramePresented(GetTime());
 }
 
 static void UpdateDrawFrame(void)
@@ -228,6 +257,13 @@ int main(void)
     SetExitKey(0);
 
     InitTiming();
+    MountAssetPack("assets/assets.pak");
+
+    // Drop the resolution to keep up with the slow frame rate, whichever frame rate we're aiming for.
+    SetRenderScaleRange(0.5f, 1.0f);
+    SetFrameBudget(1.0 / SLOW_FPS);
+    EnableDynamicResolution(true);
+
     InitScreens();
 
 #if defined(PLATFORM_WEB) || defined(EMSCRIPTEN)
@@ -239,6 +275,9 @@ int main(void)
     }
 #endif
 
+    EnableLatencyTracking(false);
+    UnmountAssetPack();
+    UnloadRenderScaling();
     CloseWindow();
 
     return 0;
@@ -4,6 +4,10 @@
 
 #define MAX_PLAYERS 4
 
+#define MAX_KEYBOARDS 2
+#define MAX_GAMEPADS 4
+#define MAX_CONTROLLERS (MAX_KEYBOARDS + MAX_GAMEPADS)
+
 // Gamepad number (as it seems to have vanished from raylib.h)
 typedef enum
 {
@@ -24,8 +28,40 @@ typedef enum ControllerId
     CONTROLLER_GAMEPAD4
 } ControllerId;
 
+// Actions that a controller can perform.
+typedef enum
+{
+    INPUT_THRUST,  // Accelerate.
+    INPUT_REVERSE, // Brake / reverse.
+    INPUT_FIRE,    // Fire.
+    INPUT_START,   // Start from the menu.
+    INPUT_SELECT,  // Select / confirm a controller.
+    INPUT_BACK,    // Go back from a controller selection.
+    INPUT_PAUSE,   // Pause, or leave the current screen.
+    INPUT_RESUME   // Resume after pausing.
+} InputAction;
+
+// Axes that a controller can drive.
+typedef enum
+{
+    INPUT_AXIS_TURN, // Turn left / right.
+    INPUT_AXIS_GUN,  // Turn the gun left / right.
+    INPUT_AXIS_COUNT
+} InputAxis;
+
 // clang-format off
 
+// Input. Every device is sampled once per frame into a per-controller state table that the screens query.
+void SampleControllers(void);                                   // Sample every input device. Call once per frame.
+bool IsControllerAvailable(ControllerId controller);            // Check if a controller is connected.
+bool IsControllerDown(ControllerId controller, InputAction action); // Check if a controller's action is held down.
+bool IsControllerPressed(ControllerId controller, InputAction action); // Check if a controller's action went down this frame.
+bool IsControllerReleased(ControllerId controller, InputAction action); // Check if a controller's action went up this frame.
+bool IsAnyControllerReleased(InputAction action);               // Check if any controller's action went up this frame.
+float GetControllerAxis(ControllerId controller, InputAxis axis); // Get the position of a controller's axis.
+double GetInputSampleTime(void);                                // Get the time at which the controllers were last sampled.
+double GetControllerEventTime(ControllerId controller);         // Get the sample time of a controller's last driving input.
+
 // Menu screen.
 void InitMenuScreen(void);                                      // Initialise the menu screen.
 void FinishMenuScreen(void);                                    // Tear down the menu screen.
@@ -0,0 +1,187 @@
+#include "ai.h"
+#include "raymath.h"
+
+#include <math.h>
+
+// A small generator of our own, so that the same bots always make the same decisions.
+static unsigned int NextRandom(Bots* bots)
+{
+    bots->seed = bots->seed * 1664525u + 1013904223u;
+    return bots->seed >> 8;
+}
+
+static int ChooseReload(Bots* bots)
+{
+    return BOT_RELOAD_MIN + (int)(NextRandom(bots) % (BOT_RELOAD_MAX - BOT_RELOAD_MIN + 1));
+}
+
+// Wrap an angle in degrees to [-180, 180).
+static float WrapDegrees(float angle)
+{
+    angle = fmodf(angle + 180.0f, 360.0f);
+    return (angle < 0.0f ? angle + 360.0f : angle) - 180.0f;
+}
+
+// Get the shortest way along one axis of the wrapped arena.
+static float WrapDelta(float delta, float size)
+{
+    if (delta > size / 2.0f)
+    {
+        return delta - size;
+    }
+    if (delta < -size / 2.0f)
+    {
+        return delta + size;
+    }
+    return delta;
+}
+
+void InitBots(Bots* bots, int count, int firstTank, unsigned int seed)
+{
+    bots->count = count < MAX_BOTS ? count : MAX_BOTS;
+    bots->seed = seed;
+    for (int i = 0; i < bots->count; i++)
+    {
+        bots->tank[i] = firstTank + i;
+        bots->heading[i] = 0.0f;
+        bots->gunHeading[i] = 0.0f;
+        for (int ray = 0; ray < LIDAR_RAYS; ray++)
+        {
+            bots->lidar[ray][i] = LIDAR_RANGE;
+        }
+        bots->target[i] = -1;
+        bots->toTarget[i] = (Vector2){0.0f, 0.0f};
+        bots->reload[i] = ChooseReload(bots);
+        bots->thrust[i] = false;
+        bots->reverse[i] = false;
+        bots->turn[i] = 0.0f;
+        bots->gun[i] = 0.0f;
+        bots->fire[i] = false;
+    }
+}
+
+// Each bot goes after the nearest other tank, the shortest way round the arena.
+static void ChooseTargets(Bots* bots, int tanks, const Vector2* positions, const bool* alive, float width, float height)
+{
+    for (int i = 0; i < bots->count; i++)
+    {
+        const int self = bots->tank[i];
+        const Vector2 pos = positions[self];
+        int target = -1;
+        Vector2 toTarget = {0.0f, 0.0f};
+        float nearest = INFINITY;
+        for (int j = 0; j < tanks; j++)
+        {
+            const float dx = WrapDelta(positions[j].x - pos.x, width);
+            const float dy = WrapDelta(positions[j].y - pos.y, height);
+            const float distance2 = dx * dx + dy * dy;
+            if (alive[j] && j != self && distance2 < nearest)
+            {
+                nearest = distance2;
+                target = j;
+                toTarget = (Vector2){dx, dy};
+            }
+        }
+        bots->target[i] = target;
+        bots->toTarget[i] = toTarget;
+    }
+}
+
+// Turn each bot towards its target and aim its gun at it, backing away from anything that's right in front of it, and fire when
+// the gun is on target.
+static void Steer(Bots* bots, const bool* alive)
+{
+    for (int i = 0; i < bots->count; i++)
+    {
+        const bool hasTarget = bots->target[i] >= 0;
+        const Vector2 toTarget = bots->toTarget[i];
+        const float distance = sqrtf(toTarget.x * toTarget.x + toTarget.y * toTarget.y);
+
+        // Headings are clockwise from straight up.
+        const float bearing = atan2f(toTarget.y, toTarget.x) * RAD2DEG + 90.0f;
+        const float heading = bots->heading[i];
+        const float bodyError = hasTarget ? WrapDegrees(bearing - heading) : 0.0f;
+        const float gunError = WrapDegrees((hasTarget ? bearing - heading : 0.0f) - bots->gunHeading[i]);
+
+        // Lidar rays go clockwise from straight ahead, so ray 1 is just to the right and the last ray is just to the left.
+        const float right = bots->lidar[1][i];
+        const float left = bots->lidar[LIDAR_RAYS - 1][i];
+        const float ahead = fminf(bots->lidar[0][i], fminf(left, right));
+        const bool blocked = ahead < BOT_AVOID_DISTANCE;
+
+        const bool active = alive[bots->tank[i]];
+        bots->turn[i] = blocked ? (right > left ? 1.0f : -1.0f) : Clamp(bodyError * BOT_TURN_GAIN, -1.0f, 1.0f);
+        bots->gun[i] = Clamp(gunError * BOT_AIM_GAIN, -1.0f, 1.0f);
+        bots->thrust[i] = active && !blocked && (!hasTarget || distance > BOT_STANDOFF);
+        bots->reverse[i] = active && blocked;
+        bots->reload[i] = bots->reload[i] > 0 ? bots->reload[i] - 1 : 0;
+        bots->fire[i] = active && hasTarget && bots->reload[i] == 0 && fabsf(gunError) < BOT_FIRE_CONE &&
+                        distance < BOT_FIRE_RANGE;
+    }
+}
+
+// Give the bots that have just fired a new reload time. This is a pass of its own because it's the only one that draws random
+// numbers, and they have to be drawn one after another.
+static void Reload(Bots* bots)
+{
+    for (int i = 0; i < bots->count; i++)
+    {
+        if (bots->fire[i])
+        {
+            bots->reload[i] = ChooseReload(bots);
+        }
+    }
+}
+
+// Gather what each bot needs to know from its tank, a ray at a time, along with where every tank is, so that the bots can go after
+// each other as well as the players.
+static void Gather(Bots* bots, const Match* match, Vector2* positions, bool* alive)
+{
+    for (int i = 0; i < match->count; i++)
+    {
+        positions[i] = match->tanks[i].pos;
+        alive[i] = match->tanks[i].alive;
+    }
+    for (int i = 0; i < bots->count; i++)
+    {
+        const Tank* tank = &match->tanks[bots->tank[i]];
+        bots->heading[i] = tank->heading;
+        bots->gunHeading[i] = tank->gunHeading;
+    }
+    for (int ray = 0; ray < LIDAR_RAYS; ray++)
+    {
+        for (int i = 0; i < bots->count; i++)
+        {
+            bots->lidar[ray][i] = match->tanks[bots->tank[i]].lidar[ray];
+        }
+    }
+}
+
+// Decide what every bot does this update.
+void DecideBots(Bots* bots, const Match* match)
+{
+    Vector2 positions[MAX_TANKS];
+    bool alive[MAX_TANKS];
+    Gather(bots, match, positions, alive);
+    ChooseTargets(bots, match->count, positions, alive, match->width, match->height);
+    Steer(bots, alive);
+    Reload(bots);
+}
+
+// Turn the bots' decisions into their tanks' controls and shots, for running a match without controllers. Returns how many shots
+// were requested.
+int GetBotControls(const Bots* bots, TankControls* controls, ShotRequest* requests)
+{
+    int numRequests = 0;
+    for (int i = 0; i < bots->count; i++)
+    {
+        const int tank = bots->tank[i];
+        controls[tank] = (TankControls){
+                .thrust = bots->thrust[i], .reverse = bots->reverse[i], .turn = bots->turn[i], .gun = bots->gun[i]};
+        if (bots->fire[i])
+        {
+            requests[numRequests++] = (ShotRequest){.tank = tank, .fraction = 0.0f};
+        }
+    }
+    return numRequests;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "lidar.h"
+#include "match.h"
+#include "raylib.h"
+#include "tanks.h"
+
+#include <stdbool.h>
+
+#define BOT_AVOID_DISTANCE 48.0f // How close something has to be in front of a bot before it backs away and turns.
+#define BOT_STANDOFF 160.0f      // How close a bot likes to get to its target.
+#define BOT_FIRE_RANGE 360.0f    // How close a target has to be before a bot fires at it.
+#define BOT_FIRE_CONE 4.0f       // How far off target, in degrees, a bot's gun can be when it fires.
+#define BOT_TURN_GAIN 0.1f       // How hard a bot turns for each degree that it's facing away from where it wants to go.
+#define BOT_AIM_GAIN 0.5f        // How hard a bot turns its gun for each degree that it's off target.
+#define BOT_RELOAD_MIN 20        // The fewest updates between a bot's shots.
+#define BOT_RELOAD_MAX 50        // The most updates between a bot's shots.
+
+// The bots, as a structure of arrays. What each bot can see is gathered from its tank, then every bot decides what to do in a
+// few passes over all of them, rather than each tank asking its own controller.
+typedef struct
+{
+    int count;                         // How many bots are there?
+    unsigned int seed;                 // For choosing reload times.
+    int tank[MAX_BOTS];                // Which tank does each bot drive?
+    float heading[MAX_BOTS];           // Which way is each bot's tank facing?
+    float gunHeading[MAX_BOTS];        // Which way is each bot's gun facing, relative to its tank?
+    float lidar[LIDAR_RAYS][MAX_BOTS]; // How far each bot can see along each lidar ray, a ray at a time.
+    int target[MAX_BOTS];              // Which tank is each bot going after, or -1 if there's nothing left?
+    Vector2 toTarget[MAX_BOTS];        // How far away is each bot's target, the shortest way round the arena?
+    int reload[MAX_BOTS];              // How many more updates before each bot can fire?
+    bool thrust[MAX_BOTS];             // Does each bot want to go forwards?
+    bool reverse[MAX_BOTS];            // Does each bot want to go backwards?
+    float turn[MAX_BOTS];              // How hard does each bot want to turn?
+    float gun[MAX_BOTS];               // How hard does each bot want to turn its gun?
+    bool fire[MAX_BOTS];               // Does each bot want to fire?
+} Bots;
+
+void InitBots(Bots* bots, int count, int firstTank, unsigned int seed);
+void DecideBots(Bots* bots, const Match* match);
+int GetBotControls(const Bots* bots, TankControls* controls, ShotRequest* requests);
@@ -0,0 +1,249 @@
+// Connects bots to a server on this machine, to see how it copes with lots of clients.
+//
+// Usage: tanks_botclient [port] [clients] [seconds]
+//
+// Each client has its own socket, so the server sees it as a separate player. It joins whichever match has room, and each time a
+// snapshot arrives it decodes it, lets a bot decide what to do from it, and sends the bot's controls back. The server doesn't send
+// lidar, so the bots can't see what's in front of them and never back away from it.
+//
+// Once a second it reports how many snapshots the clients received, how big they were, and how many were lost.
+
+#define BDR_BENCH_IMPLEMENTATION
+#define BDR_UDP_IMPLEMENTATION
+#include "ai.h"
+#include "bdr/bench.h"
+#include "bdr/udp.h"
+#include "match.h"
+#include "net.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define MAX_CLIENTS 256
+#define HELLO_INTERVAL 0.5 // How long, in seconds, to wait for a welcome before saying hello again.
+#define POLL_INTERVAL 0.001
+#define REPORT_INTERVAL 1.0
+#define DEFAULT_CLIENTS 4
+#define DEFAULT_SECONDS 10.0
+
+typedef struct
+{
+    UdpSocket udp;      // The client's socket.
+    bool joined;        // Has the server welcomed it?
+    bool refused;       // Has the server told it that there's no room?
+    double lastHello;   // When did it last say hello?
+    NetWelcome welcome; // Where did the server put it?
+    int sequence;       // The sequence number of its next input.
+    int latest;         // The tick of the latest snapshot that it has, or NET_NO_BASELINE.
+    Match view;         // What it knows of the match.
+    Bots bots;          // Its bot, which drives its tank.
+    NetHistory history; // The snapshots that the server may send deltas from.
+} BotClient;
+
+// What happened since the last report.
+typedef struct
+{
+    int snapshots;     // How many snapshots were received?
+    int deltas;        // How many of them were deltas?
+    long long bytesIn; // How many bytes of snapshots were received?
+    int lost;          // How many ticks were skipped?
+    int stale;         // How many snapshots arrived after a later one?
+    int unusable;      // How many snapshots couldn't be decoded?
+} Stats;
+
+static UdpAddress server;
+static Stats stats;
+
+static unsigned char packet[NET_MAX_PACKET];
+
+static void Join(BotClient* client, const NetWelcome* welcome, unsigned int seed)
+{
+    client->joined = true;
+    client->welcome = *welcome;
+
+    // The bots need an arena of the right size. Until the first snapshot arrives, there's nothing in it.
+    Match* view = &client->view;
+    const MatchRules rules = GetDefaultMatchRules();
+    InitMatch(view, &rules, 0, 0, welcome->width, welcome->height, 0);
+    for (int i = 0; i < MAX_TANKS; i++)
+    {
+        for (int ray = 0; ray < LIDAR_RAYS; ray++)
+        {
+            view->tanks[i].lidar[ray] = LIDAR_RANGE;
+        }
+    }
+    InitBots(&client->bots, 1, welcome->tank, seed);
+}
+
+// Decode a snapshot, then reply with what the bot wants to do about it.
+static void TakeSnapshot(BotClient* client, int size)
+{
+    static NetSnapshot snapshot;
+
+    const int baselineTick = GetNetSnapshotBaseline(packet, size);
+    const NetSnapshot* baseline = FindNetSnapshot(&client->history, baselineTick);
+    if ((baselineTick != NET_NO_BASELINE && baseline == NULL) || !ReadNetSnapshot(packet, size, baseline, &snapshot))
+    {
+        ++stats.unusable;
+        return;
+    }
+    ++stats.snapshots;
+    stats.deltas += baseline != NULL ? 1 : 0;
+    stats.bytesIn += size;
+    if (snapshot.tick <= client->latest)
+    {
+        ++stats.stale;
+        return;
+    }
+    if (client->latest != NET_NO_BASELINE)
+    {
+        stats.lost += snapshot.tick - client->latest - 1;
+    }
+    client->latest = snapshot.tick;
+    StoreNetSnapshot(&client->history, &snapshot);
+    ApplyNetSnapshot(&snapshot, &client->view);
+
+    TankControls controls[MAX_TANKS];
+    ShotRequest requests[MAX_BOTS];
+    DecideBots(&client->bots, &client->view);
+    const int numRequests = GetBotControls(&client->bots, controls, requests);
+    const NetInput input = {.sequence = client->sequence++,
+                            .ack = client->latest,
+                            .controls = controls[client->welcome.tank],
+                            .fire = numRequests > 0};
+    SendUdp(client->udp, server, packet, WriteNetInput(packet, sizeof(packet), &input));
+}
+
+static void ReceivePackets(BotClient* client, unsigned int seed)
+{
+    UdpAddress from;
+    int size;
+    while ((size = ReceiveUdp(client->udp, &from, packet, sizeof(packet))) > 0)
+    {
+        if (!IsSameUdpAddress(from, server))
+        {
+            continue;
+        }
+        const NetMessageType type = GetNetMessageType(packet, size);
+        NetWelcome welcome;
+        if (type == NET_WELCOME && !client->joined && ReadNetWelcome(packet, size, &welcome))
+        {
+            Join(client, &welcome, seed);
+        }
+        else if (type == NET_FULL && !client->joined)
+        {
+            client->refused = true;
+        }
+        else if (type == NET_SNAPSHOT && client->joined)
+        {
+            TakeSnapshot(client, size);
+        }
+    }
+}
+
+static void Report(const BotClient* clients, int count, double interval)
+{
+    int joined = 0;
+    int refused = 0;
+    for (int i = 0; i < count; i++)
+    {
+        joined += clients[i].joined ? 1 : 0;
+        refused += clients[i].refused ? 1 : 0;
+    }
+    printf("%d client(s) joined, %d refused: %.0f snapshots/s, %.1f KB/s, %.0f bytes/snapshot, %.1f%% deltas, %d lost, "
+           "%d stale, %d unusable\n",
+           joined, refused, stats.snapshots / interval, stats.bytesIn / interval / 1024.0,
+           stats.snapshots > 0 ? (double)stats.bytesIn / stats.snapshots : 0.0,
+           stats.snapshots > 0 ? 100.0 * stats.deltas / stats.snapshots : 0.0, stats.lost, stats.stale, stats.unusable);
+    stats = (Stats){.snapshots = 0};
+}
+
+int main(int argc, char* argv[])
+{
+    int port = NET_DEFAULT_PORT;
+    int count = DEFAULT_CLIENTS;
+    double seconds = DEFAULT_SECONDS;
+    if (argc > 1)
+    {
+        port = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        count = atoi(argv[2]);
+    }
+    if (argc > 3)
+    {
+        seconds = atof(argv[3]);
+    }
+    if (argc > 4 || port <= 0 || port > 65535 || count <= 0 || count > MAX_CLIENTS || seconds <= 0.0)
+    {
+        fprintf(stderr, "Usage: %s [port] [clients (1-%d)] [seconds]\n", argv[0], MAX_CLIENTS);
+        return EXIT_FAILURE;
+    }
+
+    BotClient* clients = malloc((size_t)count * sizeof(BotClient));
+    if (clients == NULL)
+    {
+        fprintf(stderr, "tanks_botclient: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    if (!InitUdp())
+    {
+        fprintf(stderr, "tanks_botclient: can't start UDP\n");
+        return EXIT_FAILURE;
+    }
+    server = GetLoopbackAddress((unsigned short)port);
+    for (int i = 0; i < count; i++)
+    {
+        BotClient* client = &clients[i];
+        if (!OpenUdpSocket(&client->udp, 0))
+        {
+            fprintf(stderr, "tanks_botclient: can't open a socket for client %d\n", i);
+            return EXIT_FAILURE;
+        }
+        client->joined = false;
+        client->refused = false;
+        client->lastHello = -HELLO_INTERVAL;
+        client->sequence = 0;
+        client->latest = NET_NO_BASELINE;
+        InitNetHistory(&client->history);
+    }
+
+    // Poll every client's socket, sleeping briefly in between. It's crude, but it's only a load tester.
+    const double start = GetBenchTime();
+    double lastReport = start;
+    double now = start;
+    while (now - start < seconds)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            BotClient* client = &clients[i];
+            if (!client->joined && !client->refused && now - client->lastHello >= HELLO_INTERVAL)
+            {
+                client->lastHello = now;
+                SendUdp(client->udp, server, packet, WriteNetHello(packet, sizeof(packet), NET_ANY_MATCH));
+            }
+            ReceivePackets(client, (unsigned int)i + 1);
+        }
+
+        WaitForUdp(clients[0].udp, POLL_INTERVAL);
+        now = GetBenchTime();
+        if (now - lastReport >= REPORT_INTERVAL)
+        {
+            Report(clients, count, now - lastReport);
+            lastReport = now;
+        }
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (clients[i].joined)
+        {
+            SendUdp(clients[i].udp, server, packet, WriteNetBye(packet, sizeof(packet)));
+        }
+        CloseUdpSocket(&clients[i].udp);
+    }
+    CloseUdp();
+    free(clients);
+    return EXIT_SUCCESS;
+}
@@ -1,10 +1,11 @@
-#include "draw_text_rec/draw_text_rec.h"
+#include "bdr/layers.h"
+#include "bdr/pack.h"
+#include "bdr/scaling.h"
+#include "bdr/ui.h"
 #include "raylib.h"
 #include "tanks.h"
 
-#define MAX_KEYBOARDS 2
-#define MAX_GAMEPADS 4
-#define MAX_CONTROLLERS (MAX_KEYBOARDS + MAX_GAMEPADS)
+#define BOTS_STEP 4 // How many bots [+] and [-], or up and down on a gamepad's d-pad, add or remove.
 
 // Screen states.
 typedef enum
@@ -37,6 +38,8 @@ static int maxPlayers = 0;
 static int numPlayers = 0;
 static PlayerController playerControllers[MAX_PLAYERS];
 
+static int numBots = 0; // Kept between visits to the screen, so that it's easy to play against the same bots again.
+
 static int numControllers = 0;
 static int numAssigned = 0;
 static int numConfirmed = 0;
@@ -44,6 +47,19 @@ static int numActive = 0;
 
 static Font scoreFont;
 
+// Retained labels.
+static UiLabel titleLabel;
+static UiLabel promptLabel;
+static UiLabel footerLabel;
+static UiLabel botsLabel;
+static StaticLayer backgroundLayer; // The background, title and prompt, which hardly ever change.
+static struct
+{
+    UiLabel description; // The controller's description.
+    UiLabel back;        // How to return to the menu, or go back.
+    UiLabel select;      // How to select, confirm, or start.
+} controllerLabels[MAX_CONTROLLERS];
+
 // Currently available controllers.
 static struct
 {
@@ -66,15 +82,14 @@ static struct
 // Gamepad information.
 static struct
 {
-    GamepadNumber gamepadNumber;   // Which raylib gamepad is this?
     ControllerId controllerId;     // Which controller is this?
     const char* description;       // What do we display to the player?
     const char* cancelDescription; // Tell the player how to cancel.
     const char* selectDescription; // Tell the player how to select.
-} gamepadDescriptors[MAX_GAMEPADS] = {{GAMEPAD_PLAYER1, CONTROLLER_GAMEPAD1, "Gamepad 1", "(B)", "(A)"},
-                                      {GAMEPAD_PLAYER2, CONTROLLER_GAMEPAD2, "Gamepad 2", "(B)", "(A)"},
-                                      {GAMEPAD_PLAYER3, CONTROLLER_GAMEPAD3, "Gamepad 3", "(B)", "(A)"},
-                                      {GAMEPAD_PLAYER4, CONTROLLER_GAMEPAD4, "Gamepad 4", "(B)", "(A)"}};
+} gamepadDescriptors[MAX_GAMEPADS] = {{CONTROLLER_GAMEPAD1, "Gamepad 1", "(B)", "(A)"},
+                                      {CONTROLLER_GAMEPAD2, "Gamepad 2", "(B)", "(A)"},
+                                      {CONTROLLER_GAMEPAD3, "Gamepad 3", "(B)", "(A)"},
+                                      {CONTROLLER_GAMEPAD4, "Gamepad 4", "(B)", "(A)"}};
 
 static bool cancellationRequested = false;
 static bool startRequested = false;
@@ -165,10 +180,10 @@ static void UnconfirmController(ControllerId controller)
     }
 }
 
-// Check the keyboard for selection / cancellation.
-static void CheckKeyboard(KeyboardKey selectKey, KeyboardKey cancelKey, ControllerId controller)
+// Check a controller for selection / cancellation.
+static void CheckController(ControllerId controller)
 {
-    if (IsKeyReleased(selectKey))
+    if (IsControllerReleased(controller, INPUT_SELECT))
     {
         switch (GetControllerStatus(controller))
         {
@@ -185,7 +200,7 @@ static void CheckKeyboard(KeyboardKey selectKey, KeyboardKey cancelKey, Controll
             break;
         }
     }
-    if (IsKeyReleased(cancelKey))
+    if (IsControllerReleased(controller, INPUT_BACK))
     {
         switch (GetControllerStatus(controller))
         {
@@ -204,66 +219,6 @@ static void CheckKeyboard(KeyboardKey selectKey, KeyboardKey cancelKey, Controll
     }
 }
 
-// Check a gamepad for selection / Cancellation.
-static void CheckGamepad(GamepadNumber gamepad, ControllerId controller)
-{
-    if (IsGamepadAvailable(gamepad))
-    {
-        if (IsGamepadButtonReleased(gamepad, GAMEPAD_BUTTON_RIGHT_FACE_DOWN))
-        {
-            switch (GetControllerStatus(controller))
-            {
-            case UNASSIGNED:
-                AssignController(controller);
-                break;
-            case ASSIGNED_TO_PLAYER:
-                ConfirmController(controller);
-                break;
-            case CONFIRMED_BY_PLAYER:
-                startRequested = true;
-                break;
-            default:
-                break;
-            }
-        }
-        if (IsGamepadButtonReleased(gamepad, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT))
-        {
-            switch (GetControllerStatus(controller))
-            {
-            case UNASSIGNED:
-                cancellationRequested = true;
-                break;
-            case CONFIRMED_BY_PLAYER:
-                UnconfirmController(controller);
-                break;
-            case ASSIGNED_TO_PLAYER:
-                UnassignController(controller);
-                break;
-            default:
-                break;
-            }
-        }
-    }
-}
-
-// Check the keyboard for quitting this screen.
-static void CheckKeyboardQuit(KeyboardKey quitKey)
-{
-    if (IsKeyReleased(quitKey))
-    {
-        state = CANCELLED;
-    }
-}
-
-// Check a gamepad for quitting this screen.
-static void CheckGamepadQuit(GamepadNumber gamepad, GamepadButton quitButton)
-{
-    if (IsGamepadAvailable(gamepad) && IsGamepadButtonReleased(gamepad, quitButton))
-    {
-        state = CANCELLED;
-    }
-}
-
 // Check which controllers are available as this can change from frame to frame.
 static void UpdateAvailableControllers(void)
 {
@@ -282,7 +237,7 @@ static void UpdateAvailableControllers(void)
     // Check gamepad availability.
     for (int i = 0; i < MAX_GAMEPADS; i++)
     {
-        if (IsGamepadAvailable(gamepadDescriptors[i].gamepadNumber))
+        if (IsControllerAvailable(gamepadDescriptors[i].controllerId))
         {
             controllers[numControllers].controller = gamepadDescriptors[i].controllerId;
             controllers[numControllers].description = gamepadDescriptors[i].description;
@@ -297,9 +252,98 @@ static void UpdateAvailableControllers(void)
     }
 }
 
+// Bring the labels up to date with the screen's state. Only labels whose text or bounds change are laid out again.
+static void UpdateControlsLabels(void)
+{
+    // Share the screen width between the controllers.
+    float width = (float)(screenWidth / numControllers);
+    float controlWidth = width * 0.75f;
+    float margin = (width - controlWidth) / 2;
+
+    SetUiLabelBounds(&promptLabel, (Rectangle){margin, screenHeight / 4.0f, (float)screenWidth, (float)screenHeight});
+
+    for (int i = 0; i < numControllers; i++)
+    {
+        // Get the controller's status.
+        AssignmentStatus status = UNASSIGNED;
+        for (int j = 0; j < MAX_PLAYERS; j++)
+        {
+            if (playerControllers[j].controller == controllers[i].controller)
+            {
+                status = playerControllers[j].status;
+            }
+        }
+
+        // Unassigned controllers are disabled if the number of active controllers matches the maximum number of players.
+        const bool isEnabled = status != UNASSIGNED || numActive < maxPlayers;
+
+        // Describe the controller.
+        UiLabel* description = &controllerLabels[i].description;
+        SetUiLabelText(description, TextFormat("%-15s", controllers[i].description));
+        SetUiLabelBounds(description,
+                         (Rectangle){i * width + margin, (float)screenHeight / 2.0f, controlWidth, (float)screenHeight / 8.0f});
+        SetUiLabelColour(description, isEnabled ? RAYWHITE : GRAY);
+
+        // Return to menu / back.
+        UiLabel* back = &controllerLabels[i].back;
+        SetUiLabelBounds(back, (Rectangle){i * width + margin, screenHeight / 2.0f - 20.0f, controlWidth, screenHeight / 8.0f});
+        if (status == UNASSIGNED)
+        {
+            SetUiLabelText(back, TextFormat("%s Return to menu", controllers[i].cancelDescription));
+            SetUiLabelColour(back, canCancel ? RED : GRAY);
+        }
+        else
+        {
+            SetUiLabelText(back, TextFormat("%s Back", controllers[i].cancelDescription));
+            SetUiLabelColour(back, isEnabled ? ORANGE : GRAY);
+        }
+
+        // Select.
+        UiLabel* select = &controllerLabels[i].select;
+        SetUiLabelBounds(select, (Rectangle){i * width + margin, 40.0f + screenHeight / 2.0f, controlWidth, screenHeight / 8.0f});
+        switch (status)
+        {
+        case UNASSIGNED:
+            SetUiLabelText(select, TextFormat("%s Select", controllers[i].selectDescription));
+            SetUiLabelColour(select, isEnabled ? LIME : GRAY);
+            break;
+        case ASSIGNED_TO_PLAYER:
+            SetUiLabelText(select, TextFormat("%s Confirm", controllers[i].selectDescription));
+            SetUiLabelColour(select, isEnabled ? LIME : GRAY);
+            break;
+        case CONFIRMED_BY_PLAYER:
+            SetUiLabelText(select, TextFormat("%s Start\nPlayers %d", controllers[i].selectDescription, numPlayers));
+            SetUiLabelColour(select, (isEnabled && state == STARTABLE) ? LIME : GRAY);
+            break;
+        default:
+            break;
+        }
+    }
+
+    SetUiLabelText(&botsLabel, TextFormat("[-] Bots %d [+]", numBots));
+    SetUiLabelColour(&botsLabel, numBots > 0 ? SKYBLUE : GRAY);
+
+    if (state == STARTABLE)
+    {
+        SetUiLabelText(&footerLabel, TextFormat("Start %d player game", numPlayers));
+        SetUiLabelColour(&footerLabel, LIME);
+        SetUiLabelVisible(&footerLabel, true);
+    }
+    else if (numConfirmed > 0)
+    {
+        SetUiLabelText(&footerLabel, TextFormat("Waiting for %d player(s)", numAssigned));
+        SetUiLabelColour(&footerLabel, ORANGE);
+        SetUiLabelVisible(&footerLabel, true);
+    }
+    else
+    {
+        SetUiLabelVisible(&footerLabel, false);
+    }
+}
+
 void InitControlsScreen(void)
 {
-    scoreFont = LoadFont("assets/Mecha.ttf");
+    scoreFont = LoadPackedFont("assets/Mecha.ttf");
     screenWidth = GetScreenWidth();
     screenHeight = GetScreenHeight();
 
@@ -320,10 +364,33 @@ void InitControlsScreen(void)
         playerControllers[i].controller = CONTROLLER_UNASSIGNED;
         playerControllers[i].status = UNASSIGNED;
     }
+
+    // Declare the labels once. Their text, bounds and colours are filled in by UpdateControlsLabels().
+    InitUiLabel(&titleLabel, GetFontDefault(), 20, 2, UI_ALIGN_LEFT);
+    SetUiLabelText(&titleLabel, "CONTROLLER SELECTION");
+    SetUiLabelBounds(&titleLabel, (Rectangle){4, 4, (float)screenWidth, (float)screenHeight});
+    InitUiLabel(&promptLabel, scoreFont, 32, 2, UI_ALIGN_LEFT);
+    SetUiLabelText(&promptLabel, "Choose your controllers...");
+    for (int i = 0; i < MAX_CONTROLLERS; i++)
+    {
+        InitUiLabel(&controllerLabels[i].description, scoreFont, 32, 2, UI_ALIGN_LEFT);
+        InitUiLabel(&controllerLabels[i].back, scoreFont, 16, 2, UI_ALIGN_LEFT);
+        InitUiLabel(&controllerLabels[i].select, scoreFont, 32, 2, UI_ALIGN_LEFT);
+    }
+    InitUiLabel(&footerLabel, scoreFont, 32, 2, UI_ALIGN_CENTRE);
+    SetUiLabelBounds(&footerLabel, (Rectangle){0, 7 * (float)screenHeight / 8, (float)screenWidth, (float)screenHeight / 8});
+    InitUiLabel(&botsLabel, scoreFont, 32, 2, UI_ALIGN_CENTRE);
+    SetUiLabelBounds(&botsLabel, (Rectangle){0, 3 * (float)screenHeight / 4, (float)screenWidth, (float)screenHeight / 8});
+
+    InitStaticLayer(&backgroundLayer);
+
+    UpdateAvailableControllers();
+    UpdateControlsLabels();
 }
 
 void FinishControlsScreen(void)
 {
+    UnloadStaticLayer(&backgroundLayer);
     UnloadFont(scoreFont);
 }
 
@@ -378,112 +445,68 @@ void UpdateControlsScreen(void)
             state = CANCELLED;
         }
     }
+
+    UpdateControlsLabels();
 }
 
 void DrawControlsScreen(double alpha)
 {
     (void)alpha;
-    ClearBackground(BLACK);
-    BeginDrawing();
-
-    DrawText("CONTROLLER SELECTION", 4, 4, 20, RAYWHITE);
-
-    // Draw the controllers and whether they're unassigned, assigned, or confirmed.
-    float width = (float)(screenWidth / numControllers);
-    float controlWidth = width * 0.75f;
-    float margin = (width - controlWidth) / 2;
-
-    DrawTextEx(scoreFont, "Choose your controllers...", (Vector2){margin, screenHeight / 4.0f}, 32, 2, RAYWHITE);
 
-    for (int i = 0; i < numControllers; i++)
+    // The prompt moves when the number of controllers changes, so the background needs drawing again when it does.
+    if (titleLabel.dirty || promptLabel.dirty)
     {
-        // Get the controller's status.
-        AssignmentStatus status = UNASSIGNED;
-        for (int j = 0; j < MAX_PLAYERS; j++)
-        {
-            if (playerControllers[j].controller == controllers[i].controller)
-            {
-                status = playerControllers[j].status;
-            }
-        }
-
-        // Unassigned controllers are disabled if the number of active controllers matches the maximum number of players.
-        const bool isEnabled = status != UNASSIGNED || numActive < maxPlayers;
-
-        // Describe the controller.
-        DrawTextRec(scoreFont, TextFormat("%-15s", controllers[i].description),
-                    (Rectangle){i * width + margin, (float)screenHeight / 2.0f, controlWidth, (float)screenHeight / 8.0f}, 32, 2,
-                    false, isEnabled ? RAYWHITE : GRAY);
-
-        // Draw return to menu / back.
-        if (status == UNASSIGNED)
-        {
-            DrawTextRec(scoreFont, TextFormat("%s Return to menu", controllers[i].cancelDescription),
-                        (Rectangle){i * width + margin, screenHeight / 2.0f - 20.0f, controlWidth, screenHeight / 8.0f}, 16, 2,
-                        false, canCancel ? RED : GRAY);
-        }
-        else
-        {
-            DrawTextRec(scoreFont, TextFormat("%s Back", controllers[i].cancelDescription),
-                        (Rectangle){i * width + margin, screenHeight / 2.0f - 20.0f, controlWidth, screenHeight / 8.0f}, 16, 2,
-                        false, isEnabled ? ORANGE : GRAY);
-        }
-
-        // Draw select.
-        switch (status)
-        {
-        case UNASSIGNED:
-            DrawTextRec(scoreFont, TextFormat("%s Select", controllers[i].selectDescription),
-                        (Rectangle){i * width + margin, 40.0f + screenHeight / 2.0f, controlWidth, screenHeight / 8.0f}, 32, 2,
-                        false, isEnabled ? LIME : GRAY);
-            break;
-        case ASSIGNED_TO_PLAYER:
-            DrawTextRec(scoreFont, TextFormat("%s Confirm", controllers[i].selectDescription),
-                        (Rectangle){i * width + margin, 40.0f + screenHeight / 2.0f, controlWidth, screenHeight / 8.0f}, 32, 2,
-                        false, isEnabled ? LIME : GRAY);
-            break;
-        case CONFIRMED_BY_PLAYER:
-            DrawTextRec(scoreFont, TextFormat("%s Start\nPlayers %d", controllers[i].selectDescription, numPlayers),
-                        (Rectangle){i * width + margin, 40.0f + screenHeight / 2.0f, controlWidth, screenHeight / 8.0f}, 32, 2,
-                        false, (isEnabled && state == STARTABLE) ? LIME : GRAY);
-            break;
-        default:
-            break;
-        }
+        MarkStaticLayerDirty(&backgroundLayer);
     }
-
-    if (state == STARTABLE)
+    if (BeginStaticLayer(&backgroundLayer, screenWidth, screenHeight))
     {
-        Vector2 size = MeasureTextEx(scoreFont, TextFormat("Start %d player game", numPlayers), 32, 2);
-        Vector2 position = (Vector2){((float)screenWidth - size.x) / 2, 7 * (float)screenHeight / 8};
-        DrawTextEx(scoreFont, TextFormat("Start %d player game", numPlayers), position, 32, 2, LIME);
+        ClearBackground(BLACK);
+        DrawUiLabel(&titleLabel);
+        DrawUiLabel(&promptLabel);
+        EndStaticLayer(&backgroundLayer);
     }
-    else if (numConfirmed > 0)
+
+    BeginDrawing();
+    BeginScaledDrawing();
+    DrawStaticLayer(&backgroundLayer, (Rectangle){0, 0, (float)screenWidth, (float)screenHeight});
+
+    // The labels were brought up to date in UpdateControlsScreen(), so all that's left is to draw their cached glyphs.
+    for (int i = 0; i < numControllers; i++)
     {
-        Vector2 size = MeasureTextEx(scoreFont, TextFormat("Waiting for %d player(s)", numAssigned), 32, 2);
-        Vector2 position = (Vector2){((float)screenWidth - size.x) / 2, 7 * (float)screenHeight / 8};
-        DrawTextEx(scoreFont, TextFormat("Waiting for %d player(s)", numAssigned), position, 32, 2, ORANGE);
+        DrawUiLabel(&controllerLabels[i].description);
+        DrawUiLabel(&controllerLabels[i].back);
+        DrawUiLabel(&controllerLabels[i].select);
     }
+    DrawUiLabel(&botsLabel);
+    DrawUiLabel(&footerLabel);
 
+    EndScaledDrawing();
     EndDrawing();
 }
 
 void CheckTriggersControlsScreen(void)
 {
     // Check player selections.
-    CheckKeyboard(KEY_S, KEY_W, CONTROLLER_KEYBOARD1);
-    CheckKeyboard(KEY_DOWN, KEY_UP, CONTROLLER_KEYBOARD2);
-    CheckGamepad(GAMEPAD_PLAYER1, CONTROLLER_GAMEPAD1);
-    CheckGamepad(GAMEPAD_PLAYER2, CONTROLLER_GAMEPAD2);
-    CheckGamepad(GAMEPAD_PLAYER3, CONTROLLER_GAMEPAD3);
-    CheckGamepad(GAMEPAD_PLAYER4, CONTROLLER_GAMEPAD4);
+    for (int i = 0; i < MAX_CONTROLLERS; i++)
+    {
+        CheckController((ControllerId)i);
+    }
+
+    // Add or remove bots.
+    if (IsAnyControllerPressed(INPUT_ADD_BOTS) && numBots < MAX_BOTS)
+    {
+        numBots = MinInt(numBots + BOTS_STEP, MAX_BOTS);
+    }
+    if (IsAnyControllerPressed(INPUT_REMOVE_BOTS) && numBots > 0)
+    {
+        numBots = numBots > BOTS_STEP ? numBots - BOTS_STEP : 0;
+    }
 
     // Check if this screen should be abandoned.
-    CheckKeyboardQuit(KEY_ESCAPE);
-    CheckGamepadQuit(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_MIDDLE_RIGHT);
-    CheckGamepadQuit(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_MIDDLE_RIGHT);
-    CheckGamepadQuit(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_MIDDLE_RIGHT);
-    CheckGamepadQuit(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_MIDDLE_RIGHT);
+    if (IsAnyControllerReleased(INPUT_PAUSE))
+    {
+        state = CANCELLED;
+    }
 }
 
 bool IsCancelledControlsScreen(void)
@@ -505,3 +528,8 @@ int GetNumberOfPlayers(void)
 {
     return numPlayers;
 }
+
+int GetNumberOfBots(void)
+{
+    return numBots;
+}
@@ -0,0 +1,292 @@
+#include "draw.h"
+#include "lidar.h"
+#include "match.h"
+#include "raylib.h"
+#include "raymath.h"
+
+#define TANK_OVERLAP (2 * TANK_SCALE)
+
+#define MAX_LINES 12
+
+// Types of draw command.
+typedef enum
+{
+    END,  // Indicates the last command.
+    MOVE, // Move to a given position.
+    LINE  // Draw a line from the current position to the given position. If there is no current position, start from the origin.
+} CommandType;
+
+// A draw command.
+typedef struct
+{
+    CommandType type;
+    Vector2 pos;
+} Command;
+
+// Shot appearance (+x is right, +y is down).
+const Vector2 shotLines[] = {{0, -0.25f}, {0, 0.25f}};
+
+// Tank appearances (+x is right, +y is down). Currently they're all identical.
+const Command tankCommands[][MAX_LINES] = {
+        // Tank 0.
+        {{MOVE, {-0.67f, -1}},
+         {LINE, {0.67f, -1}},
+         {LINE, {1.0f, -0.67f}},
+         {LINE, {1, 1}},
+         {LINE, {-1, 1}},
+         {LINE, {-1, -0.67f}},
+         {LINE, {-0.67f, -1}},
+         {END, {0, 0}}},
+        // Tank 1.
+        {{MOVE, {-0.67f, -1}},
+         {LINE, {0.67f, -1}},
+         {LINE, {1.0f, -0.67f}},
+         {LINE, {1, 1}},
+         {LINE, {-1, 1}},
+         {LINE, {-1, -0.67f}},
+         {LINE, {-0.67f, -1}},
+         {END, {0, 0}}},
+        // Tank 2.
+        {{MOVE, {-0.67f, -1}},
+         {LINE, {0.67f, -1}},
+         {LINE, {1.0f, -0.67f}},
+         {LINE, {1, 1}},
+         {LINE, {-1, 1}},
+         {LINE, {-1, -0.67f}},
+         {LINE, {-0.67f, -1}},
+         {END, {0, 0}}},
+        // Tank 3.
+        {{MOVE, {-0.67f, -1}},
+         {LINE, {0.67f, -1}},
+         {LINE, {1.0f, -0.67f}},
+         {LINE, {1, 1}},
+         {LINE, {-1, 1}},
+         {LINE, {-1, -0.67f}},
+         {LINE, {-0.67f, -1}},
+         {END, {0, 0}}},
+};
+
+// Gun appearances. Currently they're all identical.
+const Command gunCommands[][MAX_LINES] = {
+        // Gun 0.
+        {{MOVE, {-0.125f, -1}},
+         {LINE, {0.125f, -1}},
+         {LINE, {0.125f, 0.125f}},
+         {LINE, {-0.125f, 0.125f}},
+         {LINE, {-0.125f, -1}},
+         {END, {0, 0}}},
+        // Gun 1.
+        {{MOVE, {-0.125f, -1}},
+         {LINE, {0.125f, -1}},
+         {LINE, {0.125f, 0.125f}},
+         {LINE, {-0.125f, 0.125f}},
+         {LINE, {-0.125f, -1}},
+         {END, {0, 0}}},
+        // Gun 2.
+        {{MOVE, {-0.125f, -1}},
+         {LINE, {0.125f, -1}},
+         {LINE, {0.125f, 0.125f}},
+         {LINE, {-0.125f, 0.125f}},
+         {LINE, {-0.125f, -1}},
+         {END, {0, 0}}},
+        // Gun 3.
+        {{MOVE, {-0.125f, -1}},
+         {LINE, {0.125f, -1}},
+         {LINE, {0.125f, 0.125f}},
+         {LINE, {-0.125f, 0.125f}},
+         {LINE, {-0.125f, -1}},
+         {END, {0, 0}}},
+};
+
+static void DrawCommands(const Command* commands, Vector2 pos, float heading, Color colour)
+{
+    Vector2 points[MAX_LINES];
+
+    Vector2 here = Vector2Add(Vector2Scale(Vector2Rotate((Vector2){0, 0}, heading), TANK_SCALE), pos);
+    int numPoints = 0;
+    for (int i = 0; commands[i].type != END; i++)
+    {
+        const Vector2 coord = Vector2Add(Vector2Scale(Vector2Rotate(commands[i].pos, heading), TANK_SCALE), pos);
+        if (commands[i].type == LINE)
+        {
+            if (numPoints == 0)
+            {
+                points[0] = here;
+                ++numPoints;
+            }
+            points[numPoints] = coord;
+            ++numPoints;
+        }
+        else if (commands[i].type == MOVE)
+        {
+            if (numPoints > 0)
+            {
+                DrawLineStrip(points, numPoints, colour);
+                numPoints = 0;
+            }
+        }
+        here = coord;
+    }
+    if (numPoints > 0)
+    {
+        DrawLineStrip(points, numPoints, colour);
+    }
+}
+
+static void DrawTankAt(int tankType, Vector2 pos, float heading, float gunHeading, Color colour)
+{
+    DrawCommands(tankCommands[tankType], pos, heading, colour);
+    DrawCommands(gunCommands[tankType], pos, heading + gunHeading, colour);
+}
+
+// Where is a position in the arena on the screen, given the position that's at the screen's top left?
+static Vector2 GetScreenPosition(const Match* match, Vector2 pos, Vector2 origin)
+{
+    Vector2 onScreen = Vector2Subtract(pos, origin);
+    if (onScreen.x < 0)
+    {
+        onScreen.x += match->width;
+    }
+    if (onScreen.y < 0)
+    {
+        onScreen.y += match->height;
+    }
+    return onScreen;
+}
+
+static void DrawTank(const Match* match, int index, Vector2 origin, double alpha)
+{
+    // Interpolate the tank's drawing position with its velocity to reduce stutter.
+    const Tank* tank = &match->tanks[index];
+    const Vector2 pos = Vector2Add(GetScreenPosition(match, tank->pos, origin), Vector2Scale(tank->vel, (float)alpha));
+    const float width = match->width;
+    const float height = match->height;
+
+    const float heading = tank->heading;
+    const float gunHeading = tank->gunHeading;
+
+    // Which edges of the play area does the tank overlap?
+    const bool overlapsTop = pos.y - TANK_OVERLAP < 0;          // Going off the top of the screen.
+    const bool overlapsBottom = pos.y + TANK_OVERLAP >= height; // Going off the bottom of the screen.
+    const bool overlapsLeft = pos.x - TANK_OVERLAP < 0;         // Going off the left of the screen.
+    const bool overlapsRight = pos.x + TANK_OVERLAP >= width;   // Going off the right of the screen.
+
+    const Color tankColour = GetTankColour(index);
+    const int tankType = index % MAX_PLAYERS;
+
+    DrawTankAt(tankType, pos, heading, gunHeading, tankColour);
+
+    if (overlapsTop)
+    {
+        DrawTankAt(tankType, Vector2Add(pos, (Vector2){0, height}), heading, gunHeading, tankColour);
+    }
+    if (overlapsBottom)
+    {
+        DrawTankAt(tankType, Vector2Add(pos, (Vector2){0, -height}), heading, gunHeading, tankColour);
+    }
+    if (overlapsLeft)
+    {
+        DrawTankAt(tankType, Vector2Add(pos, (Vector2){width, 0}), heading, gunHeading, tankColour);
+        if (overlapsTop)
+        {
+            DrawTankAt(tankType, Vector2Add(pos, (Vector2){width, height}), heading, gunHeading, tankColour);
+        }
+        else if (overlapsBottom)
+        {
+            DrawTankAt(tankType, Vector2Add(pos, (Vector2){width, -height}), heading, gunHeading, tankColour);
+        }
+    }
+    if (overlapsRight)
+    {
+        DrawTankAt(tankType, Vector2Add(pos, (Vector2){-width, 0}), heading, gunHeading, tankColour);
+        if (overlapsTop)
+        {
+            DrawTankAt(tankType, Vector2Add(pos, (Vector2){-width, height}), heading, gunHeading, tankColour);
+        }
+        else if (overlapsBottom)
+        {
+            DrawTankAt(tankType, Vector2Add(pos, (Vector2){-width, -height}), heading, gunHeading, tankColour);
+        }
+    }
+}
+
+// Draw what a tank's lidar can see as a sweep that goes round once a second, leaving the hits that it has passed to fade away. The
+// hits wrap around the play area, but the sweep line doesn't.
+static void DrawLidar(const Match* match, int index, Vector2 origin, double alpha)
+{
+    const Tank* tank = &match->tanks[index];
+    const Vector2 interpolated = Vector2Add(tank->pos, Vector2Scale(tank->vel, (float)alpha));
+    const Vector2 pos = Vector2Add(GetScreenPosition(match, tank->pos, origin), Vector2Scale(tank->vel, (float)alpha));
+    const Color colour = GetTankColour(index);
+    const int sweep = (int)(GetTime() * LIDAR_RAYS) % LIDAR_RAYS;
+    for (int ray = 0; ray < LIDAR_RAYS; ray++)
+    {
+        const float distance = tank->lidar[ray];
+        if (distance < LIDAR_RANGE)
+        {
+            const float age = (float)((sweep - ray + LIDAR_RAYS) % LIDAR_RAYS) / LIDAR_RAYS;
+            const Vector2 hit = MoveInMatch(match, interpolated, Vector2Scale(GetLidarDirection(tank->heading, ray), distance));
+            DrawCircleV(GetScreenPosition(match, hit, origin), 2.0f, Fade(colour, 1.0f - age));
+        }
+    }
+    const Vector2 end = Vector2Add(pos, Vector2Scale(GetLidarDirection(tank->heading, sweep), tank->lidar[sweep]));
+    DrawLineV(pos, end, Fade(colour, 0.5f));
+}
+
+static void DrawShotAt(Vector2 pos, float heading, Color colour)
+{
+    Vector2 points[2];
+    for (int i = 0; i < 2; i++)
+    {
+        points[i] = Vector2Add(Vector2Scale(Vector2Rotate(shotLines[i], heading), TANK_SCALE), pos);
+    }
+    DrawLineStrip(points, 2, colour);
+}
+
+static void DrawShot(const Match* match, const Shot* shot, Color colour, Vector2 origin, double alpha)
+{
+    // Interpolate the shot's drawing position with its velocity to reduce stutter.
+    const Vector2 pos = Vector2Add(GetScreenPosition(match, shot->pos, origin), Vector2Scale(shot->vel, (float)alpha));
+
+    DrawShotAt(pos, shot->heading, colour);
+}
+
+Color GetTankColour(int tank)
+{
+    // The players each have their own colour. The bots all look the same.
+    const Color playerColours[MAX_PLAYERS] = {GREEN, YELLOW, PINK, SKYBLUE};
+    return tank < MAX_PLAYERS ? playerColours[tank] : LIGHTGRAY;
+}
+
+void DrawMatch(const Match* match, Vector2 origin, double alpha)
+{
+    // Draw the tanks.
+    for (int i = 0; i < match->count; i++)
+    {
+        if (match->tanks[i].alive)
+        {
+            DrawTank(match, i, origin, alpha);
+        }
+    }
+
+    // Draw the shots.
+    for (int i = 0; i < match->count * SHOTS_PER_TANK; i++)
+    {
+        const Shot* shot = &match->shots[i];
+        if (shot->alive > 0)
+        {
+            DrawShot(match, shot, GetTankColour(i / SHOTS_PER_TANK), origin, alpha);
+        }
+    }
+}
+
+void DrawMatchLidar(const Match* match, Vector2 origin, double alpha)
+{
+    for (int i = 0; i < match->count; i++)
+    {
+        if (match->tanks[i].alive)
+        {
+            DrawLidar(match, i, origin, alpha);
+        }
+    }
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "match.h"
+#include "raylib.h"
+
+// How a match looks, for anything that draws one, e.g., the playing screen and the spectator. The arena wraps, so the screen's
+// top left corner can be anywhere in it, and anything that straddles an edge of the arena is drawn on both sides.
+
+// clang-format off
+
+Color GetTankColour(int tank);                                         // Get the colour that a tank, and its shots, are drawn in.
+void DrawMatch(const Match* match, Vector2 origin, double alpha);      // Draw the tanks and shots, from origin at the top left.
+void DrawMatchLidar(const Match* match, Vector2 origin, double alpha); // Draw what the match's tanks' lidar can see.
+
+// clang-format on
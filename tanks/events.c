@@ -0,0 +1,70 @@
+#include "events.h"
+#include "bdr/eventlog.h"
+#include "match.h"
+
+#include <time.h>
+
+// Write an unsigned integer's lowest four bytes, little-endian.
+static void PutU32(unsigned char* p, unsigned int value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+}
+
+// Fill in the part of an event that every event has.
+static void PutEvent(unsigned char* event, const Match* match, int tank, int other)
+{
+    PutU32(event, (unsigned int)match->ticks);
+    event[4] = (unsigned char)(tank >= 0 ? tank : EVENT_NO_TANK);
+    event[5] = (unsigned char)(other >= 0 ? other : EVENT_NO_TANK);
+}
+
+static void LogGameEvent(GameEventType type, const Match* match, int tank, int other)
+{
+    unsigned char event[EVENT_SIZE];
+    PutEvent(event, match, tank, other);
+    LogEvent(type, event, EVENT_SIZE);
+}
+
+void LogMatchStarted(const Match* match, int players)
+{
+    unsigned char event[EVENT_MATCH_STARTED_SIZE];
+    PutEvent(event, match, match->count, -1);
+    PutU32(&event[EVENT_SIZE], (unsigned int)time(NULL));
+    event[EVENT_SIZE + 4] = (unsigned char)players;
+    LogEvent(EVENT_MATCH_STARTED, event, EVENT_MATCH_STARTED_SIZE);
+}
+
+void LogMatchEvents(const Match* match)
+{
+    for (int i = 0; i < match->numEvents; i++)
+    {
+        const MatchEvent* event = &match->events[i];
+        const GameEventType type = event->type == MATCH_SHOT_FIRED  ? EVENT_SHOT_FIRED
+                                   : event->type == MATCH_TANK_SHOT ? EVENT_TANK_SHOT
+                                                                    : EVENT_TANKS_COLLIDED;
+        LogGameEvent(type, match, event->tank, event->other);
+    }
+}
+
+void LogPause(const Match* match, bool paused)
+{
+    LogGameEvent(paused ? EVENT_PAUSED : EVENT_RESUMED, match, -1, -1);
+}
+
+// A match is only over once there's at most one tank left. Leaving it before then abandons it, rather than making it a draw.
+void LogMatchEnded(const Match* match)
+{
+    const int living = CountLivingTanks(match);
+    if (living > 1)
+    {
+        LogGameEvent(EVENT_MATCH_ABANDONED, match, -1, living);
+    }
+    else
+    {
+        LogGameEvent(EVENT_MATCH_ENDED, match, GetMatchWinner(match), living);
+    }
+    FlushEventLog();
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "match.h"
+
+#include <stdbool.h>
+
+// What the game writes to the event log, for gameplay analytics. Every event's data starts with the match's tick (u32), then the
+// tank that it's about (u8), then the other tank involved (u8), or EVENT_NO_TANK if there isn't one. A match that has started has
+// the time that it started at (u32, seconds since 1970) and how many of its tanks are players (u8) after that.
+#define EVENT_NO_TANK 255
+#define EVENT_SIZE 6
+#define EVENT_MATCH_STARTED_SIZE (EVENT_SIZE + 5)
+
+typedef enum
+{
+    EVENT_MATCH_STARTED = 1, // A match started. The tank is how many tanks there are.
+    EVENT_SHOT_FIRED,        // A tank fired a shot.
+    EVENT_TANK_SHOT,         // A tank was destroyed by the other tank's shot.
+    EVENT_TANKS_COLLIDED,    // A tank ran into the other tank, destroying both.
+    EVENT_PAUSED,            // The match was paused.
+    EVENT_RESUMED,           // The match was resumed.
+    EVENT_MATCH_ENDED,       // A match ended. The tank is the winner, if there is one, and the other is how many tanks were left.
+    EVENT_MATCH_ABANDONED    // A match was left before it was over. The other is how many tanks were left.
+} GameEventType;
+
+// clang-format off
+
+void LogMatchStarted(const Match* match, int players); // Log that a match has started, with players as its first tanks.
+void LogMatchEvents(const Match* match);               // Log what happened during the match's last update.
+void LogPause(const Match* match, bool paused);        // Log that the match has been paused or resumed.
+void LogMatchEnded(const Match* match);                // Log that the match has ended or been left, then write the log out soon.
+
+// clang-format on
@@ -0,0 +1,177 @@
+// Summarises the event log that the game writes, without opening a window.
+//
+// Usage: tanks_events [file]
+//
+// The file defaults to the one that the game writes to. It can hold any number of runs of the game, one after the other, and each
+// run can have any number of matches. A match that was left while more than one tank was alive is counted as abandoned, rather than
+// as a draw, and its length isn't counted. A match that was still going when the game stopped has no end at all, so it's counted
+// as started but neither finished nor abandoned.
+//
+// It reports how many matches there were and how long they lasted, how many shots were fired and how many of them hit, how tanks
+// were destroyed, how often matches were paused, and how many of the matches the players won.
+
+#include "bdr/eventlog.h"
+#include "events.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DEFAULT_FILE "tanks_events.bin"
+#define UPDATE_FPS 50
+
+typedef struct
+{
+    int started;      // How many matches started?
+    int finished;     // How many matches ended?
+    long long ticks;  // How many updates did the finished matches last between them?
+    int abandoned;    // How many matches were left before they were over?
+    int left;         // How many tanks were left in the abandoned matches between them?
+    int players;      // How many players were there in the latest match?
+    int playerWins;   // How many matches did a player win?
+    int botWins;      // How many matches did a bot win?
+    int draws;        // How many matches ended without a winner?
+    int shots;        // How many shots were fired?
+    int playerShots;  // How many of them did players fire?
+    int kills;        // How many tanks were destroyed by shots?
+    int playerKills;  // How many of them did players' shots destroy?
+    int playerDeaths; // How many players were destroyed, by shots or otherwise?
+    int collisions;   // How many times did tanks run into each other?
+    int pauses;       // How many times was a match paused?
+    int invalid;      // How many events weren't understood?
+} Report;
+
+static unsigned int GetU32(const unsigned char* p)
+{
+    return (unsigned int)p[0] | (unsigned int)p[1] << 8 | (unsigned int)p[2] << 16 | (unsigned int)p[3] << 24;
+}
+
+static void CountEvent(Report* report, int type, const unsigned char* data, int size)
+{
+    if (size < EVENT_SIZE || (type == EVENT_MATCH_STARTED && size < EVENT_MATCH_STARTED_SIZE))
+    {
+        ++report->invalid;
+        return;
+    }
+    const int tick = (int)GetU32(data);
+    const int tank = data[4];
+    const int other = data[5];
+    const bool isPlayer = tank < report->players;
+    switch (type)
+    {
+    case EVENT_MATCH_STARTED:
+        ++report->started;
+        report->players = data[EVENT_SIZE + 4];
+        break;
+    case EVENT_SHOT_FIRED:
+        ++report->shots;
+        report->playerShots += isPlayer ? 1 : 0;
+        break;
+    case EVENT_TANK_SHOT:
+        ++report->kills;
+        report->playerKills += other < report->players ? 1 : 0;
+        report->playerDeaths += isPlayer ? 1 : 0;
+        break;
+    case EVENT_TANKS_COLLIDED:
+        ++report->collisions;
+        report->playerDeaths += (isPlayer ? 1 : 0) + (other < report->players ? 1 : 0);
+        break;
+    case EVENT_PAUSED:
+        ++report->pauses;
+        break;
+    case EVENT_RESUMED:
+        break;
+    case EVENT_MATCH_ENDED:
+        ++report->finished;
+        report->ticks += tick;
+        if (tank == EVENT_NO_TANK)
+        {
+            ++report->draws;
+        }
+        else if (isPlayer)
+        {
+            ++report->playerWins;
+        }
+        else
+        {
+            ++report->botWins;
+        }
+        break;
+    case EVENT_MATCH_ABANDONED:
+        ++report->abandoned;
+        report->left += other;
+        break;
+    default:
+        ++report->invalid;
+        break;
+    }
+}
+
+static double Percent(int part, int whole)
+{
+    return whole > 0 ? 100.0 * part / whole : 0.0;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* fileName = argc > 1 ? argv[1] : DEFAULT_FILE;
+    if (argc > 2)
+    {
+        fprintf(stderr, "Usage: %s [file]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "tanks_events: can't open %s\n", fileName);
+        return EXIT_FAILURE;
+    }
+    fseek(file, 0, SEEK_END);
+    const long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* data = malloc(size > 0 ? (size_t)size : 1);
+    const bool read = data != NULL && fread(data, 1, (size_t)size, file) == (size_t)size;
+    fclose(file);
+    if (!read || size < BDR_EVENTLOG_HEADER_SIZE || memcmp(data, BDR_EVENTLOG_MAGIC, 4) != 0 ||
+        GetU32(&data[4]) != BDR_EVENTLOG_VERSION)
+    {
+        fprintf(stderr, "tanks_events: %s isn't an event log\n", fileName);
+        free(data);
+        return EXIT_FAILURE;
+    }
+
+    // Count the events. If the game stopped part way through writing one, then the last one is cut short.
+    Report report = {0};
+    long at = BDR_EVENTLOG_HEADER_SIZE;
+    while (at + 2 <= size && at + 2 + data[at + 1] <= size)
+    {
+        CountEvent(&report, data[at], &data[at + 2], data[at + 1]);
+        at += 2 + data[at + 1];
+    }
+    const long truncated = size - at;
+    free(data);
+
+    printf("%s: %d matches started, %d finished", fileName, report.started, report.finished);
+    if (report.finished > 0)
+    {
+        printf(", lasting %.1f s on average", (double)report.ticks / report.finished / UPDATE_FPS);
+    }
+    if (report.abandoned > 0)
+    {
+        printf(", %d abandoned with %.1f tanks left on average", report.abandoned, (double)report.left / report.abandoned);
+    }
+    printf("\n");
+    printf("Winners: players %d, bots %d, nobody %d\n", report.playerWins, report.botWins, report.draws);
+    printf("Shots: %d fired, %d of them by players, %d hit (%.1f%%), %d of them players'\n", report.shots, report.playerShots,
+           report.kills, Percent(report.kills, report.shots), report.playerKills);
+    printf("Tanks destroyed: %d by shots, %d in %d collisions, of which %d were players\n", report.kills, 2 * report.collisions,
+           report.collisions, report.playerDeaths);
+    printf("Pauses: %d\n", report.pauses);
+    if (report.invalid > 0 || truncated > 0)
+    {
+        printf("%d events weren't understood, and %ld bytes at the end were cut short\n", report.invalid, truncated);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,252 @@
+#include "lidar.h"
+
+#include <math.h>
+
+// The range of cells that a circle covers, in unwrapped cell coordinates.
+typedef struct
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+} CellRange;
+
+static int WrapCell(int cell, int cells)
+{
+    const int wrapped = cell % cells;
+    return wrapped < 0 ? wrapped + cells : wrapped;
+}
+
+// Work out which cells a circle covers. Anything bigger than the arena covers every cell once, rather than some cells twice.
+static CellRange GetCellRange(const LidarScene* scene, Vector2 pos, float radius)
+{
+    CellRange range = {.left = (int)floorf((pos.x - radius) / scene->cellWidth),
+                       .top = (int)floorf((pos.y - radius) / scene->cellHeight),
+                       .right = (int)floorf((pos.x + radius) / scene->cellWidth),
+                       .bottom = (int)floorf((pos.y + radius) / scene->cellHeight)};
+    if (range.right - range.left >= scene->columns)
+    {
+        range.right = range.left + scene->columns - 1;
+    }
+    if (range.bottom - range.top >= scene->rows)
+    {
+        range.bottom = range.top + scene->rows - 1;
+    }
+    return range;
+}
+
+void BeginLidarScene(LidarScene* scene, float width, float height)
+{
+    scene->width = width;
+    scene->height = height;
+    scene->columns = width > LIDAR_CELL_SIZE ? (int)(width / LIDAR_CELL_SIZE) : 1;
+    scene->rows = height > LIDAR_CELL_SIZE ? (int)(height / LIDAR_CELL_SIZE) : 1;
+    while (scene->columns * scene->rows > LIDAR_MAX_CELLS)
+    {
+        if (scene->columns > scene->rows)
+        {
+            scene->columns /= 2;
+        }
+        else
+        {
+            scene->rows /= 2;
+        }
+    }
+    scene->cellWidth = width / (float)scene->columns;
+    scene->cellHeight = height / (float)scene->rows;
+    scene->count = 0;
+    scene->entries = 0;
+}
+
+bool AddLidarCircle(LidarScene* scene, Vector2 pos, float radius, int id)
+{
+    const CellRange range = GetCellRange(scene, pos, radius);
+    const int entries = (range.right - range.left + 1) * (range.bottom - range.top + 1);
+    if (scene->count == LIDAR_MAX_CIRCLES || scene->entries + entries > LIDAR_MAX_ENTRIES)
+    {
+        return false;
+    }
+
+    scene->pos[scene->count] = pos;
+    scene->radius[scene->count] = radius;
+    scene->id[scene->count] = id;
+    scene->count++;
+    scene->entries += entries;
+    return true;
+}
+
+// Sort the circles into the cells that they cover with a counting sort. Each entry holds a copy of its circle, moved by a whole
+// arena if need be so that it's next to the cell, e.g., a circle that hangs off the left edge has a copy beyond the right edge.
+void EndLidarScene(LidarScene* scene)
+{
+    const int cells = scene->columns * scene->rows;
+    for (int cell = 0; cell <= cells; cell++)
+    {
+        scene->cellStart[cell] = 0;
+    }
+
+    // Count each cell's entries, then turn the counts into where each cell's run ends.
+    for (int i = 0; i < scene->count; i++)
+    {
+        const CellRange range = GetCellRange(scene, scene->pos[i], scene->radius[i]);
+        for (int y = range.top; y <= range.bottom; y++)
+        {
+            for (int x = range.left; x <= range.right; x++)
+            {
+                scene->cellStart[WrapCell(y, scene->rows) * scene->columns + WrapCell(x, scene->columns)]++;
+            }
+        }
+    }
+    int total = 0;
+    for (int cell = 0; cell < cells; cell++)
+    {
+        total += scene->cellStart[cell];
+        scene->cellStart[cell] = total;
+    }
+    scene->cellStart[cells] = total;
+
+    // Fill each run from its end, which leaves each cell's start where it should be.
+    for (int i = 0; i < scene->count; i++)
+    {
+        const CellRange range = GetCellRange(scene, scene->pos[i], scene->radius[i]);
+        for (int y = range.top; y <= range.bottom; y++)
+        {
+            const int row = WrapCell(y, scene->rows);
+            const float dy = (float)(y - row) / (float)scene->rows * scene->height;
+            for (int x = range.left; x <= range.right; x++)
+            {
+                const int column = WrapCell(x, scene->columns);
+                const float dx = (float)(x - column) / (float)scene->columns * scene->width;
+                const int entry = --scene->cellStart[row * scene->columns + column];
+                scene->entryX[entry] = scene->pos[i].x - dx;
+                scene->entryY[entry] = scene->pos[i].y - dy;
+                scene->entryRadius2[entry] = scene->radius[i] * scene->radius[i];
+                scene->entryId[entry] = scene->id[i];
+            }
+        }
+    }
+}
+
+// Test a ray against a batch of circles, returning the distance to the nearest one that's closer than best, or best if there
+// isn't one. A ray that starts inside a circle hits it straight away. There are no early outs, so the compiler can vectorise it.
+static float IntersectCircles(float ox, float oy, float dx, float dy, int count, const float* x, const float* y,
+                              const float* radius2, const int* ids, int id, float best)
+{
+    for (int i = 0; i < count; i++)
+    {
+        const float mx = ox - x[i];
+        const float my = oy - y[i];
+        const float b = mx * dx + my * dy;
+        const float c = mx * mx + my * my - radius2[i];
+        const float discriminant = b * b - c;
+        const float t = c < 0.0f ? 0.0f : -b - sqrtf(fmaxf(discriminant, 0.0f));
+        const bool hit = discriminant >= 0.0f && t >= 0.0f && ids[i] != id;
+        best = hit ? fminf(best, t) : best;
+    }
+    return best;
+}
+
+// Walk the ray through the grid a cell at a time, testing each cell's circles as a batch. It stops when the next cell starts
+// further away than the nearest hit so far, because nothing in it can be any closer. When the ray wraps around an edge, its origin
+// moves by a whole arena the other way, so that it lines up with the circles in the cells on the far side.
+float CastLidarRay(const LidarScene* scene, Vector2 origin, Vector2 direction, float range, int id)
+{
+    const int columns = scene->columns;
+    const int rows = scene->rows;
+    const float cellWidth = scene->cellWidth;
+    const float cellHeight = scene->cellHeight;
+    const int x = (int)floorf(origin.x / cellWidth);
+    const int y = (int)floorf(origin.y / cellHeight);
+    int column = WrapCell(x, columns);
+    int row = WrapCell(y, rows);
+    float ox = origin.x - (float)(x - column) / (float)columns * scene->width;
+    float oy = origin.y - (float)(y - row) / (float)rows * scene->height;
+
+    const int stepX = direction.x < 0.0f ? -1 : 1;
+    const int stepY = direction.y < 0.0f ? -1 : 1;
+    const float deltaX = direction.x != 0.0f ? cellWidth / fabsf(direction.x) : INFINITY;
+    const float deltaY = direction.y != 0.0f ? cellHeight / fabsf(direction.y) : INFINITY;
+    float nextX = direction.x != 0.0f ? ((float)(x + (stepX > 0)) * cellWidth - origin.x) / direction.x : INFINITY;
+    float nextY = direction.y != 0.0f ? ((float)(y + (stepY > 0)) * cellHeight - origin.y) / direction.y : INFINITY;
+
+    float best = range;
+    float t = 0.0f;
+    while (t < best)
+    {
+        const int cell = row * columns + column;
+        const int start = scene->cellStart[cell];
+        const int count = scene->cellStart[cell + 1] - start;
+        best = IntersectCircles(ox, oy, direction.x, direction.y, count, scene->entryX + start, scene->entryY + start,
+                                scene->entryRadius2 + start, scene->entryId + start, id, best);
+
+        if (nextX < nextY)
+        {
+            t = nextX;
+            nextX += deltaX;
+            column += stepX;
+            if (column == columns)
+            {
+                column = 0;
+                ox -= scene->width;
+            }
+            else if (column < 0)
+            {
+                column = columns - 1;
+                ox += scene->width;
+            }
+        }
+        else
+        {
+            t = nextY;
+            nextY += deltaY;
+            row += stepY;
+            if (row == rows)
+            {
+                row = 0;
+                oy -= scene->height;
+            }
+            else if (row < 0)
+            {
+                row = rows - 1;
+                oy += scene->height;
+            }
+        }
+    }
+    return best;
+}
+
+// Test the ray against every circle, and against its copies in the neighbouring arenas. This is only right for ranges that are
+// shorter than the arena, but that's enough to check the grid against.
+float CastLidarRaySlowly(const LidarScene* scene, Vector2 origin, Vector2 direction, float range, int id)
+{
+    float best = range;
+    for (int i = 0; i < scene->count; i++)
+    {
+        const float radius2 = scene->radius[i] * scene->radius[i];
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            for (int dx = -1; dx <= 1; dx++)
+            {
+                const float x = scene->pos[i].x + (float)dx * scene->width;
+                const float y = scene->pos[i].y + (float)dy * scene->height;
+                best = IntersectCircles(origin.x, origin.y, direction.x, direction.y, 1, &x, &y, &radius2, &scene->id[i], id, best);
+            }
+        }
+    }
+    return best;
+}
+
+// Ray 0 points the way the tank is facing, and the rest go clockwise around it.
+Vector2 GetLidarDirection(float heading, int ray)
+{
+    const float angle = (heading - 90.0f + 360.0f * (float)ray / LIDAR_RAYS) * DEG2RAD;
+    return (Vector2){cosf(angle), sinf(angle)};
+}
+
+void ScanLidar(const LidarScene* scene, Vector2 origin, float heading, int id, float* distances)
+{
+    for (int ray = 0; ray < LIDAR_RAYS; ray++)
+    {
+        distances[ray] = CastLidarRay(scene, origin, GetLidarDirection(heading, ray), LIDAR_RANGE, id);
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "raylib.h"
+
+#include <stdbool.h>
+
+#define LIDAR_RAYS 32          // How many rays each tank casts, evenly spaced around it.
+#define LIDAR_RANGE 400.0f     // How far a ray can see. Rays that don't hit anything report this distance.
+#define LIDAR_CELL_SIZE 80.0f  // How big the grid's cells would like to be. They're stretched to fit the arena exactly.
+#define LIDAR_MAX_CIRCLES 1024 // The most things that the lidar can see at once.
+#define LIDAR_MAX_ENTRIES 4096 // The most grid entries. Something that straddles cells has an entry in each of them.
+#define LIDAR_MAX_CELLS 4096   // The most cells in the grid.
+#define LIDAR_NOBODY -1        // The id of things that no ray passes through, e.g., shots.
+
+// What the lidar can see, as circles in a uniform grid over the wrapped arena. Each cell's circles are copied next to each other,
+// as a structure of arrays, so that a ray can test all of them in one batch.
+//
+// There are no walls yet. When there are, they can go into the grid too, with a batched test of their own.
+typedef struct
+{
+    float width;                           // How wide is the arena? It wraps at the edges.
+    float height;                          // How tall is the arena?
+    int columns;                           // How many columns of cells are there?
+    int rows;                              // How many rows of cells are there?
+    float cellWidth;                       // How wide is each cell?
+    float cellHeight;                      // How tall is each cell?
+    int count;                             // How many circles are there?
+    Vector2 pos[LIDAR_MAX_CIRCLES];        // Where is each circle?
+    float radius[LIDAR_MAX_CIRCLES];       // How big is each circle?
+    int id[LIDAR_MAX_CIRCLES];             // Who owns each circle? Their own rays pass through it.
+    int entries;                           // How many grid entries are there?
+    int cellStart[LIDAR_MAX_CELLS + 1];    // Where does each cell's run of entries start?
+    float entryX[LIDAR_MAX_ENTRIES];       // What is the x coordinate of each entry's circle?
+    float entryY[LIDAR_MAX_ENTRIES];       // What is the y coordinate of each entry's circle?
+    float entryRadius2[LIDAR_MAX_ENTRIES]; // What is the square of each entry's radius?
+    int entryId[LIDAR_MAX_ENTRIES];        // Who owns each entry's circle?
+} LidarScene;
+
+// clang-format off
+
+void BeginLidarScene(LidarScene* scene, float width, float height);        // Empty the scene and size its grid to fit the arena.
+bool AddLidarCircle(LidarScene* scene, Vector2 pos, float radius, int id); // Add a circle to the scene, if there's room.
+void EndLidarScene(LidarScene* scene);                                     // Put the circles into the grid, ready to cast rays.
+Vector2 GetLidarDirection(float heading, int ray);                         // Get the direction of one of a tank's rays.
+
+// Cast a ray through the grid, returning how far it went before hitting a circle, up to range.
+float CastLidarRay(const LidarScene* scene, Vector2 origin, Vector2 direction, float range, int id);
+
+// Cast a ray against every circle, without the grid. For checking and benchmarking the grid.
+float CastLidarRaySlowly(const LidarScene* scene, Vector2 origin, Vector2 direction, float range, int id);
+
+// Cast all of a tank's rays, filling in LIDAR_RAYS distances.
+void ScanLidar(const LidarScene* scene, Vector2 origin, float heading, int id, float* distances);
+
+// clang-format on
@@ -0,0 +1,122 @@
+// Benchmarks the tanks' lidar without opening a window.
+//
+// Usage: lidar_bench [scans]
+//
+// For increasing numbers of things in the arena, every tank scans its surroundings the given number of times through the grid,
+// then a hundredth as many times by testing every ray against every circle. Then one scan's distances from the grid are checked
+// against the slow ones, because the grid must not change what the tanks can see. It fails if any of them don't match.
+
+#define BDR_BENCH_IMPLEMENTATION
+#include "bdr/bench.h"
+#include "lidar.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_WIDTH 1280.0f
+#define ARENA_HEIGHT 720.0f
+#define TANK_RADIUS 16.0f
+#define SHOT_RADIUS 8.0f
+#define DEFAULT_SCANS 1000
+#define SLOW_FRACTION 100
+
+static const int tankCounts[] = {4, 16, 64, 256};
+static const int shotsPerTank = 5;
+
+static LidarScene scene;
+
+static unsigned int seed = 1;
+
+static float RandomFloat(float max)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return max * (float)((seed >> 8) & 0xffff) / 65536.0f;
+}
+
+typedef float (*CastFunction)(const LidarScene* scene, Vector2 origin, Vector2 direction, float range, int id);
+
+// Scan from every tank the given number of times, turning a little each time. Returns the time per ray in seconds.
+static double Scan(CastFunction cast, int tanks, int scans, float* distances)
+{
+    const double start = GetBenchTime();
+    for (int scan = 0; scan < scans; scan++)
+    {
+        for (int tank = 0; tank < tanks; tank++)
+        {
+            for (int ray = 0; ray < LIDAR_RAYS; ray++)
+            {
+                const Vector2 direction = GetLidarDirection((float)scan, ray);
+                distances[tank * LIDAR_RAYS + ray] = cast(&scene, scene.pos[tank], direction, LIDAR_RANGE, tank);
+            }
+        }
+    }
+    return (GetBenchTime() - start) / ((double)scans * tanks * LIDAR_RAYS);
+}
+
+int main(int argc, char* argv[])
+{
+    const int scans = argc > 1 ? atoi(argv[1]) : DEFAULT_SCANS;
+    if (scans <= 0 || argc > 2)
+    {
+        fprintf(stderr, "Usage: %s [scans]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    bool mismatched = false;
+    printf("%d ray(s) per scan, %d scan(s) per tank\n", LIDAR_RAYS, scans);
+    for (size_t i = 0; i < sizeof(tankCounts) / sizeof(tankCounts[0]); i++)
+    {
+        const int tanks = tankCounts[i];
+        const int count = tanks * LIDAR_RAYS;
+        float* fast = malloc((size_t)count * sizeof(float));
+        float* slow = malloc((size_t)count * sizeof(float));
+        if (fast == NULL || slow == NULL)
+        {
+            fprintf(stderr, "lidar_bench: out of memory\n");
+            return EXIT_FAILURE;
+        }
+
+        // The tanks come first, so that each tank's circle has the same index as the tank.
+        BeginLidarScene(&scene, ARENA_WIDTH, ARENA_HEIGHT);
+        for (int tank = 0; tank < tanks; tank++)
+        {
+            AddLidarCircle(&scene, (Vector2){RandomFloat(ARENA_WIDTH), RandomFloat(ARENA_HEIGHT)}, TANK_RADIUS, tank);
+        }
+        for (int shot = 0; shot < tanks * shotsPerTank; shot++)
+        {
+            AddLidarCircle(&scene, (Vector2){RandomFloat(ARENA_WIDTH), RandomFloat(ARENA_HEIGHT)}, SHOT_RADIUS, LIDAR_NOBODY);
+        }
+        EndLidarScene(&scene);
+
+        Scan(CastLidarRay, tanks, 1, fast); // Warm up.
+        const double grid = Scan(CastLidarRay, tanks, scans, fast);
+        const double brute = Scan(CastLidarRaySlowly, tanks, scans > SLOW_FRACTION ? scans / SLOW_FRACTION : 1, slow);
+
+        Scan(CastLidarRay, tanks, 1, fast);
+        Scan(CastLidarRaySlowly, tanks, 1, slow);
+
+        int mismatches = 0;
+        for (int ray = 0; ray < count; ray++)
+        {
+            if (fabsf(fast[ray] - slow[ray]) > 0.01f)
+            {
+                mismatches++;
+            }
+        }
+
+        printf("  %3d tank(s), %4d circle(s): grid %7.2f Mrays/s, slow %7.2f Mrays/s, %5.1fx", tanks, scene.count,
+               1e-6 / grid, 1e-6 / brute, brute / grid);
+        if (mismatches > 0)
+        {
+            printf(" %d MISMATCH(ES)", mismatches);
+            mismatched = true;
+        }
+        printf("\n");
+
+        free(slow);
+        free(fast);
+    }
+
+    return mismatched ? EXIT_FAILURE : EXIT_SUCCESS;
+}
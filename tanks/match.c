@@ -0,0 +1,452 @@
+#include "match.h"
+#include "raymath.h"
+
+#include <math.h>
+
+// The bots start somewhere in the cells of a grid that covers the arena, one bot per cell so that they're spread out. The seed
+// shuffles the cells, moves each bot around within its cell, and says which way it faces, so every seed gives a different layout.
+#define SPAWN_COLUMNS 13
+#define SPAWN_ROWS 7
+#define SPAWN_POINTS (SPAWN_COLUMNS * SPAWN_ROWS)
+#define SPAWN_JITTER 0.6f     // How much of its cell, across and down, a bot can start anywhere in.
+#define SPAWN_CLEARANCE 64.0f // How far a bot has to start from the players.
+
+MatchRules GetDefaultMatchRules(void)
+{
+    return (MatchRules){.maxRotationSpeed = 2.0f,
+                        .tankAccel = 0.05f,
+                        .maxSpeed = 2.0f,
+                        .maxReverseSpeed = -1.0f,
+                        .shotSpeed = 6.0f,
+                        .shotDuration = 90};
+}
+
+Vector2 MoveInMatch(const Match* match, Position pos, Velocity vel)
+{
+    pos = Vector2Add(pos, vel);
+
+    // Wrap the position around the play area.
+    if (pos.x >= match->width)
+    {
+        pos.x -= match->width;
+    }
+    if (pos.x < 0)
+    {
+        pos.x += match->width;
+    }
+    if (pos.y >= match->height)
+    {
+        pos.y -= match->height;
+    }
+    if (pos.y < 0)
+    {
+        pos.y += match->height;
+    }
+
+    return pos;
+}
+
+// Note something that happened during the update. There's always room, unless more shots were requested than there can be.
+static void AddMatchEvent(Match* match, MatchEventType type, int tank, int other)
+{
+    if (match->numEvents < MAX_MATCH_EVENTS)
+    {
+        match->events[match->numEvents++] = (MatchEvent){.type = type, .tank = tank, .other = other};
+    }
+}
+
+// Note how far a shot moved during the update, and for how much of the update it was moving.
+static void SetShotPath(Match* match, int index, Vector2 moved, float span)
+{
+    match->paths.moved[index] = moved;
+    match->paths.spans[index] = span;
+}
+
+// Copy the paths of the shots that are still alive into a batch, in order, ready to sweep the tanks against them.
+static void GatherShotPaths(Match* match)
+{
+    ShotPaths* paths = &match->paths;
+    paths->count = 0;
+    for (int i = 0; i < match->count * SHOTS_PER_TANK; i++)
+    {
+        if (match->shots[i].alive > 0)
+        {
+            const int n = paths->count++;
+            paths->shot[n] = i;
+            paths->x[n] = match->shots[i].pos.x;
+            paths->y[n] = match->shots[i].pos.y;
+            paths->dx[n] = paths->moved[i].x;
+            paths->dy[n] = paths->moved[i].y;
+            paths->span[n] = paths->spans[i];
+        }
+    }
+}
+
+// Sweep a tank along the path that it took during the update against the batch of shots along theirs, marking the shots that
+// came within radius of it at any point. Rather than only testing where everything ended up, which lets a fast shot jump straight
+// over a tank, this finds where each shot came closest to the tank, measured the shortest way round the arena. A shot that was
+// fired during the update is only compared with the part of the tank's path that was after it was fired. There are no early outs,
+// so the compiler can vectorise it.
+static void SweepShots(ShotPaths* paths, Position pos, Velocity moved, float width, float height, float radius)
+{
+    const float halfWidth = width / 2;
+    const float halfHeight = height / 2;
+    const float radius2 = radius * radius;
+    for (int i = 0; i < paths->count; i++)
+    {
+        // Where did the shot end up, relative to the tank?
+        float ex = paths->x[i] - pos.x;
+        float ey = paths->y[i] - pos.y;
+        ex = ex > halfWidth ? ex - width : (ex < -halfWidth ? ex + width : ex);
+        ey = ey > halfHeight ? ey - height : (ey < -halfHeight ? ey + height : ey);
+
+        // Where did it start relative to the tank, and how far along its relative path did it come closest?
+        const float mx = paths->dx[i] - moved.x * paths->span[i];
+        const float my = paths->dy[i] - moved.y * paths->span[i];
+        const float sx = ex - mx;
+        const float sy = ey - my;
+        const float t = fminf(fmaxf(-(sx * mx + sy * my) / fmaxf(mx * mx + my * my, 1e-6f), 0.0f), 1.0f);
+        const float cx = sx + t * mx;
+        const float cy = sy + t * my;
+        paths->hit[i] = cx * cx + cy * cy <= radius2;
+    }
+}
+
+static void CollideTankShot(Match* match, int tankIndex, int shotIndex)
+{
+    Tank* tank = &match->tanks[tankIndex];
+
+    // More than one of a tank's shots can hit in the same update, but only the first one destroys the tank.
+    if (tank->alive)
+    {
+        AddMatchEvent(match, MATCH_TANK_SHOT, tankIndex, shotIndex / SHOTS_PER_TANK);
+    }
+    tank->alive = false;
+    match->shots[shotIndex].alive = 0;
+}
+
+static void CollideTankTank(Match* match, int index1, int index2)
+{
+    Tank* tank1 = &match->tanks[index1];
+    Tank* tank2 = &match->tanks[index2];
+    if (!tank1->alive || !tank2->alive)
+    {
+        return;
+    }
+
+    if (CheckCollisionCircles(tank1->pos, TANK_COLLISION_RADIUS, tank2->pos, TANK_COLLISION_RADIUS))
+    {
+        tank1->alive = false;
+        tank2->alive = false;
+        AddMatchEvent(match, MATCH_TANKS_COLLIDED, index1, index2);
+    }
+}
+
+// Collide a tank with the other tanks' shots, sweeping it against all of them at once, then going through the ones that hit it.
+// The first tank whose shots hit it destroys it, and all of that tank's shots that hit it are stopped.
+static void CollideTankShots(Match* match, int tankIndex)
+{
+    const Tank* tank = &match->tanks[tankIndex];
+    if (!tank->alive)
+    {
+        return;
+    }
+
+    ShotPaths* paths = &match->paths;
+    SweepShots(paths, tank->pos, tank->vel, match->width, match->height, TANK_COLLISION_RADIUS + SHOT_COLLISION_RADIUS);
+    int hitBy = -1;
+    for (int i = 0; i < paths->count; i++)
+    {
+        const int shot = paths->shot[i];
+        const int owner = shot / SHOTS_PER_TANK;
+        if (paths->hit[i] && owner != tankIndex && match->shots[shot].alive > 0 && (tank->alive || owner == hitBy))
+        {
+            hitBy = owner;
+            CollideTankShot(match, tankIndex, shot);
+        }
+    }
+}
+
+static void UpdateTank(Match* match, Tank* tank, const TankControls* controls)
+{
+    if (!tank->alive)
+    {
+        return;
+    }
+
+    const MatchRules* rules = &match->rules;
+
+    // Rotate the tank.
+    tank->heading += controls->turn * rules->maxRotationSpeed;
+
+    // Accelerate the tank.
+    if (controls->thrust)
+    {
+        tank->speed += rules->tankAccel;
+        tank->speed = fminf(rules->maxSpeed, tank->speed);
+    }
+    else if (controls->reverse)
+    {
+        tank->speed -= rules->tankAccel;
+        tank->speed = fmaxf(rules->maxReverseSpeed, tank->speed);
+    }
+    else
+    {
+        tank->speed *= 0.9f;
+    }
+
+    // The tank's velocity is in its direction of travel.
+    tank->vel.x = cosf((tank->heading - 90) * DEG2RAD) * tank->speed;
+    tank->vel.y = sinf((tank->heading - 90) * DEG2RAD) * tank->speed;
+
+    // Rotate the gun.
+    tank->gunHeading += controls->gun * rules->maxRotationSpeed;
+
+    // Move the tank.
+    tank->pos = MoveInMatch(match, tank->pos, tank->vel);
+}
+
+// Fire a shot from a tank that has just moved. The fraction says how far through the fixed update the fire button was pressed,
+// so the shot starts from where the tank was at that moment and has travelled for the rest of the update.
+static void FireShot(Match* match, int index, float fraction)
+{
+    const Tank* tank = &match->tanks[index];
+    if (!tank->alive)
+    {
+        return;
+    }
+
+    const int baseStart = index * SHOTS_PER_TANK;
+    const int baseEnd = baseStart + SHOTS_PER_TANK;
+    for (int i = baseStart; i < baseEnd; i++)
+    {
+        if (match->shots[i].alive == 0)
+        {
+            Shot* shot = &match->shots[i];
+            shot->alive = match->rules.shotDuration - 1;
+            shot->heading = tank->heading + tank->gunHeading;
+            Vector2 angle = {cosf((shot->heading - 90) * DEG2RAD), sinf((shot->heading - 90) * DEG2RAD)};
+            shot->vel = Vector2Add(Vector2Scale(angle, match->rules.shotSpeed), tank->vel);
+            const Position firedFrom = MoveInMatch(match, tank->pos, Vector2Scale(tank->vel, fraction - 1.0f));
+            shot->pos = MoveInMatch(match, Vector2Add(firedFrom, Vector2Scale(angle, TANK_SCALE)),
+                                    Vector2Scale(shot->vel, 1.0f - fraction));
+            SetShotPath(match, i, Vector2Scale(shot->vel, 1.0f - fraction), 1.0f - fraction);
+            AddMatchEvent(match, MATCH_SHOT_FIRED, index, -1);
+            break;
+        }
+    }
+}
+
+static void UpdateShot(Match* match, int index)
+{
+    Shot* shot = &match->shots[index];
+    if (shot->alive == 0)
+    {
+        SetShotPath(match, index, (Vector2){0, 0}, 0.0f);
+        return;
+    }
+    shot->pos = MoveInMatch(match, shot->pos, shot->vel);
+    --(shot->alive);
+    SetShotPath(match, index, shot->vel, 1.0f);
+}
+
+// Let each tank see the other tanks and all of the shots, including its own.
+static void UpdateLidar(Match* match)
+{
+    LidarScene* scene = &match->lidar;
+    BeginLidarScene(scene, match->width, match->height);
+    for (int i = 0; i < match->count; i++)
+    {
+        if (match->tanks[i].alive)
+        {
+            AddLidarCircle(scene, match->tanks[i].pos, TANK_COLLISION_RADIUS, i);
+        }
+    }
+    for (int i = 0; i < MAX_SHOTS; i++)
+    {
+        if (match->shots[i].alive > 0)
+        {
+            AddLidarCircle(scene, match->shots[i].pos, SHOT_COLLISION_RADIUS, LIDAR_NOBODY);
+        }
+    }
+    EndLidarScene(scene);
+
+    for (int i = 0; i < match->count; i++)
+    {
+        Tank* tank = &match->tanks[i];
+        if (tank->alive)
+        {
+            ScanLidar(scene, tank->pos, tank->heading, i, tank->lidar);
+        }
+    }
+}
+
+// A small generator of our own, like the bots', so that the same seed always places the bots in the same way.
+static unsigned int NextSpawnRandom(unsigned int* state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+// Get a random number in [0, 1).
+static float NextSpawnFraction(unsigned int* state)
+{
+    return (float)(NextSpawnRandom(state) & 0xffff) / 65536.0f;
+}
+
+// Find somewhere for each bot to start, away from the players, who must already have been placed, and which way it faces. The
+// seed shuffles the grid's cells, so the bots' slots don't always get the same places relative to each other.
+static void PlaceBots(Match* match, int players, unsigned int seed)
+{
+    // Mix the seed up a little, so that neighbouring seeds don't start off with similar numbers.
+    unsigned int random = seed * 2654435761u + 1u;
+    NextSpawnRandom(&random);
+
+    int cells[SPAWN_POINTS];
+    for (int i = 0; i < SPAWN_POINTS; i++)
+    {
+        cells[i] = i;
+    }
+    for (int i = SPAWN_POINTS - 1; i > 0; i--)
+    {
+        const int j = (int)(NextSpawnRandom(&random) % (unsigned int)(i + 1));
+        const int cell = cells[i];
+        cells[i] = cells[j];
+        cells[j] = cell;
+    }
+
+    int next = players;
+    for (int point = 0; point < SPAWN_POINTS && next < match->count; point++)
+    {
+        const int cell = cells[point];
+        const float across = 0.5f + SPAWN_JITTER * (NextSpawnFraction(&random) - 0.5f);
+        const float down = 0.5f + SPAWN_JITTER * (NextSpawnFraction(&random) - 0.5f);
+        const float heading = 360.0f * NextSpawnFraction(&random);
+        const Vector2 start = {((float)(cell % SPAWN_COLUMNS) + across) * match->width / SPAWN_COLUMNS,
+                               ((float)(cell / SPAWN_COLUMNS) + down) * match->height / SPAWN_ROWS};
+        bool clear = true;
+        for (int i = 0; i < players; i++)
+        {
+            clear = clear && Vector2Distance(start, match->tanks[i].pos) >= SPAWN_CLEARANCE;
+        }
+        if (clear)
+        {
+            match->tanks[next].pos = start;
+            match->tanks[next].heading = heading;
+            match->tanks[next].alive = true;
+            ++next;
+        }
+    }
+}
+
+void InitMatch(Match* match, const MatchRules* rules, int count, int players, float width, float height, unsigned int seed)
+{
+    match->rules = *rules;
+    match->width = width;
+    match->height = height;
+    match->ticks = 0;
+    match->numEvents = 0;
+    match->count = count < MAX_TANKS ? count : MAX_TANKS;
+
+    for (int i = 0; i < MAX_TANKS; i++)
+    {
+        match->tanks[i].alive = false;
+    }
+
+    for (int i = 0; i < players; i++)
+    {
+        float angle = (float)i * (2 * 3.141592654f) / (float)players;
+        match->tanks[i].alive = true;
+        match->tanks[i].pos.x = width / 2.0f + cosf(angle) * height / 3;
+        match->tanks[i].pos.y = height / 2.0f + sinf(angle) * height / 3;
+    }
+    PlaceBots(match, players, seed);
+
+    for (int i = 0; i < match->count; i++)
+    {
+        // The players face the middle of the arena. The bots already face whichever way they were placed.
+        Tank* tank = &match->tanks[i];
+        if (i < players)
+        {
+            tank->heading = 180.0f + RAD2DEG * atan2f(height / 2.0f - tank->pos.y, width / 2.0f - tank->pos.x);
+        }
+        tank->gunHeading = 0.0f;
+        tank->speed = 0.0f;
+        tank->vel = (Vector2){0, 0};
+        for (int ray = 0; ray < LIDAR_RAYS; ray++)
+        {
+            tank->lidar[ray] = LIDAR_RANGE;
+        }
+    }
+
+    for (int i = 0; i < MAX_SHOTS; i++)
+    {
+        match->shots[i].alive = 0;
+    }
+}
+
+void UpdateMatch(Match* match, const TankControls* controls, const ShotRequest* requests, int numRequests)
+{
+    match->numEvents = 0;
+
+    for (int i = 0; i < match->count; i++)
+    {
+        UpdateTank(match, &match->tanks[i], &controls[i]);
+    }
+
+    for (int i = 0; i < MAX_SHOTS; i++)
+    {
+        UpdateShot(match, i);
+    }
+
+    for (int i = 0; i < numRequests; i++)
+    {
+        FireShot(match, requests[i].tank, requests[i].fraction);
+    }
+
+    // Collide each tank with the other tanks' shots.
+    GatherShotPaths(match);
+    for (int i = 0; i < match->count; i++)
+    {
+        CollideTankShots(match, i);
+    }
+
+    // Collide each tank with the other tanks.
+    for (int i = 0; i < match->count - 1; i++)
+    {
+        for (int j = i + 1; j < match->count; j++)
+        {
+            CollideTankTank(match, i, j);
+        }
+    }
+
+    UpdateLidar(match);
+    ++match->ticks;
+}
+
+int CountLivingTanks(const Match* match)
+{
+    int living = 0;
+    for (int i = 0; i < match->count; i++)
+    {
+        living += match->tanks[i].alive ? 1 : 0;
+    }
+    return living;
+}
+
+int GetMatchWinner(const Match* match)
+{
+    int winner = -1;
+    for (int i = 0; i < match->count; i++)
+    {
+        if (match->tanks[i].alive)
+        {
+            if (winner >= 0)
+            {
+                return -1;
+            }
+            winner = i;
+        }
+    }
+    return winner;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "lidar.h"
+#include "raylib.h"
+#include "tanks.h"
+
+#include <stdbool.h>
+
+#define TANK_SCALE 16.0f
+#define TANK_COLLISION_RADIUS TANK_SCALE
+#define SHOT_COLLISION_RADIUS (TANK_SCALE * 0.5f)
+
+#define SHOTS_PER_TANK 5
+#define MAX_SHOTS (SHOTS_PER_TANK * MAX_TANKS)
+#define MAX_SHOT_REQUESTS MAX_SHOTS
+#define MAX_MATCH_EVENTS (MAX_SHOT_REQUESTS + MAX_TANKS) // Every shot request can fire, and every tank can be destroyed.
+
+typedef Vector2 Position;
+typedef Vector2 Velocity;
+typedef float Heading;
+typedef float Speed;
+
+// The rules that a match is played by. They're in the match rather than being constants, so that the tournament runner can tune
+// them. Speeds are per fixed update, and angles are in degrees.
+typedef struct
+{
+    float maxRotationSpeed; // How quickly can a tank and its gun turn?
+    float tankAccel;        // How quickly does a tank speed up?
+    float maxSpeed;         // How fast can a tank go forwards?
+    float maxReverseSpeed;  // How fast can a tank go backwards? This is negative.
+    float shotSpeed;        // How fast does a shot leave the gun, relative to the tank?
+    int shotDuration;       // How many updates does a shot last?
+} MatchRules;
+
+typedef struct
+{
+    bool alive;
+    Position pos;
+    Velocity vel;
+    Heading heading;
+    Heading gunHeading;
+    Speed speed;
+    float lidar[LIDAR_RAYS]; // How far can this tank see along each of its lidar rays?
+} Tank;
+
+typedef struct
+{
+    int alive;
+    Position pos;
+    Velocity vel;
+    Heading heading;
+} Shot;
+
+// What a tank's driver wants it to do for one update, whether they're a player or a bot.
+typedef struct
+{
+    bool thrust;  // Go forwards?
+    bool reverse; // Go backwards?
+    float turn;   // Turn left (-1) or right (+1).
+    float gun;    // Turn the gun left (-1) or right (+1).
+} TankControls;
+
+// A shot to fire during an update.
+typedef struct
+{
+    int tank;       // Which tank fired it?
+    float fraction; // How far through the update was it fired?
+} ShotRequest;
+
+// Where the shots went during an update. The paths of the shots that are still alive are gathered into a batch, as a structure
+// of arrays, so that a tank can be swept against all of them at once. Each path ends where its shot is now, and goes back as far
+// as the shot moved, which takes less than a whole update for a shot that was fired part way through one.
+typedef struct
+{
+    Vector2 moved[MAX_SHOTS]; // How far did each shot move?
+    float spans[MAX_SHOTS];   // For how much of the update did each shot move? It's 1 unless it was fired during the update.
+    int count;                // How many paths are there in the batch?
+    int shot[MAX_SHOTS];      // Which shot is each path in the batch for?
+    float x[MAX_SHOTS];       // Where did each path end, across?
+    float y[MAX_SHOTS];       // Where did each path end, down?
+    float dx[MAX_SHOTS];      // How far across did each path go?
+    float dy[MAX_SHOTS];      // How far down did each path go?
+    float span[MAX_SHOTS];    // For how much of the update did each path go?
+    bool hit[MAX_SHOTS];      // Did each path pass close enough to the tank that was swept against the batch last?
+} ShotPaths;
+
+// Something that happened during an update that the match's owner might want to know about, e.g., to log it.
+typedef enum
+{
+    MATCH_SHOT_FIRED,     // A tank fired a shot.
+    MATCH_TANK_SHOT,      // A tank was destroyed by another tank's shot.
+    MATCH_TANKS_COLLIDED  // Two tanks ran into each other, destroying both.
+} MatchEventType;
+
+typedef struct
+{
+    MatchEventType type;
+    int tank;  // Which tank fired, was shot, or collided?
+    int other; // Which tank fired the shot, or was collided with, or -1 if there wasn't one?
+} MatchEvent;
+
+// Everything about a match between tanks on a wrapped arena, with no window and no globals, so that the playing screen can run one
+// and the tournament runner can run lots of them at once.
+typedef struct
+{
+    MatchRules rules;                    // What rules is the match played by?
+    float width;                         // How wide is the arena?
+    float height;                        // How tall is the arena?
+    int ticks;                           // How many updates have there been?
+    int count;                           // How many tanks are there?
+    Tank tanks[MAX_TANKS];               // The tanks. The players come first, then the bots.
+    Shot shots[MAX_SHOTS];               // The shots. Each tank has SHOTS_PER_TANK of its own.
+    LidarScene lidar;                    // What the tanks' lidar can see.
+    ShotPaths paths;                     // Where the shots went during the last update.
+    int numEvents;                       // How many things happened during the last update?
+    MatchEvent events[MAX_MATCH_EVENTS]; // What happened during the last update, in the order that it happened.
+} Match;
+
+// clang-format off
+
+MatchRules GetDefaultMatchRules(void);                               // Get the rules that the game is normally played by.
+int CountLivingTanks(const Match* match);                            // Count the tanks that are still alive.
+int GetMatchWinner(const Match* match);                              // Get the only tank left alive, or -1 if there isn't one.
+Vector2 MoveInMatch(const Match* match, Position pos, Velocity vel); // Move something, wrapping it around the arena.
+
+// Start a match with the given number of tanks, of which the first players are placed in a ring and the rest are bots. The seed
+// says where the bots start.
+void InitMatch(Match* match, const MatchRules* rules, int count, int players, float width, float height, unsigned int seed);
+
+// Run one fixed update, given each tank's controls and the shots to fire.
+void UpdateMatch(Match* match, const TankControls* controls, const ShotRequest* requests, int numRequests);
+
+// clang-format on
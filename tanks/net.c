@@ -0,0 +1,666 @@
+#include "net.h"
+#include "raymath.h"
+
+#include <math.h>
+#include <string.h>
+
+#define POSITION_STEPS (1 << NET_POSITION_BITS)
+#define MOVE_LIMIT (1 << (NET_MOVE_BITS - 1))
+#define VELOCITY_LIMIT ((1 << (NET_VELOCITY_BITS - 1)) - 1)
+#define VELOCITY_SCALE (VELOCITY_LIMIT / NET_MAX_VELOCITY)
+#define HEADING_STEPS (1 << NET_HEADING_BITS)
+
+// Writes bits to a packet, least significant first, remembering if any of them didn't fit.
+typedef struct
+{
+    unsigned char* data;
+    int capacity; // In bytes.
+    int bits;     // How many bits have been written?
+    bool overflowed;
+} NetWriter;
+
+// Reads bits from a packet, least significant first, remembering if it tried to read past the end.
+typedef struct
+{
+    const unsigned char* data;
+    int size; // In bytes.
+    int bits; // How many bits have been read?
+    bool failed;
+} NetReader;
+
+// Write the low count bits of a value, up to 32 of them.
+static void WriteBits(NetWriter* writer, unsigned int value, int count)
+{
+    if (writer->overflowed || writer->bits + count > writer->capacity * 8)
+    {
+        writer->overflowed = true;
+        return;
+    }
+    int written = 0;
+    while (written < count)
+    {
+        const int byte = writer->bits >> 3;
+        const int offset = writer->bits & 7;
+        const int n = 8 - offset < count - written ? 8 - offset : count - written;
+        if (offset == 0)
+        {
+            writer->data[byte] = 0;
+        }
+        writer->data[byte] |= (unsigned char)(((value >> written) & ((1u << n) - 1)) << offset);
+        writer->bits += n;
+        written += n;
+    }
+}
+
+static unsigned int ReadBits(NetReader* reader, int count)
+{
+    if (reader->failed || reader->bits + count > reader->size * 8)
+    {
+        reader->failed = true;
+        return 0;
+    }
+    unsigned int value = 0;
+    int read = 0;
+    while (read < count)
+    {
+        const int byte = reader->bits >> 3;
+        const int offset = reader->bits & 7;
+        const int n = 8 - offset < count - read ? 8 - offset : count - read;
+        value |= ((reader->data[byte] >> offset) & ((1u << n) - 1)) << read;
+        reader->bits += n;
+        read += n;
+    }
+    return value;
+}
+
+static void WriteSigned(NetWriter* writer, int value, int count)
+{
+    WriteBits(writer, (unsigned int)value, count);
+}
+
+static int ReadSigned(NetReader* reader, int count)
+{
+    const unsigned int value = ReadBits(reader, count);
+    const unsigned int sign = 1u << (count - 1);
+    return (value & sign) != 0 ? -1 - (int)(~value & (sign - 1)) : (int)value;
+}
+
+static void WriteBool(NetWriter* writer, bool value)
+{
+    WriteBits(writer, value ? 1 : 0, 1);
+}
+
+static bool ReadBool(NetReader* reader)
+{
+    return ReadBits(reader, 1) != 0;
+}
+
+static void WriteF32(NetWriter* writer, float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    WriteBits(writer, bits, 32);
+}
+
+static float ReadF32(NetReader* reader)
+{
+    const unsigned int bits = ReadBits(reader, 32);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Write a value in [-1, 1] as a signed byte.
+static void WriteAxis(NetWriter* writer, float value)
+{
+    const float clamped = value < -1.0f ? -1.0f : value > 1.0f ? 1.0f : value;
+    WriteSigned(writer, (int)(clamped * 127.0f), 8);
+}
+
+static float ReadAxis(NetReader* reader)
+{
+    return (float)ReadSigned(reader, 8) / 127.0f;
+}
+
+static NetWriter BeginMessage(unsigned char* packet, int capacity, NetMessageType type)
+{
+    NetWriter writer = {.data = packet, .capacity = capacity, .bits = 0, .overflowed = false};
+    WriteBits(&writer, NET_PROTOCOL, 16);
+    WriteBits(&writer, type, 8);
+    return writer;
+}
+
+static int EndMessage(const NetWriter* writer)
+{
+    return writer->overflowed ? 0 : (writer->bits + 7) / 8;
+}
+
+// Start reading a message of the given type, skipping its header.
+static NetReader BeginReading(const unsigned char* packet, int size, NetMessageType type)
+{
+    NetReader reader = {.data = packet, .size = size, .bits = 0, .failed = false};
+    const unsigned int protocol = ReadBits(&reader, 16);
+    const unsigned int messageType = ReadBits(&reader, 8);
+    reader.failed = reader.failed || protocol != NET_PROTOCOL || messageType != (unsigned int)type;
+    return reader;
+}
+
+// Has the reader read all of the message, and nothing more?
+static bool EndReading(const NetReader* reader)
+{
+    return !reader->failed && (reader->bits + 7) / 8 == reader->size;
+}
+
+// Positions are rounded down, so anything just off the top or left of the arena wraps to the other side.
+static unsigned short QuantisePosition(float value, float size)
+{
+    return (unsigned short)((int)floorf(value / size * POSITION_STEPS) & (POSITION_STEPS - 1));
+}
+
+// Positions come back from the middle of their steps.
+static float DequantisePosition(unsigned int value, float size)
+{
+    return ((float)value + 0.5f) * size / POSITION_STEPS;
+}
+
+static short QuantiseVelocity(float value)
+{
+    return (short)roundf(Clamp(value, -NET_MAX_VELOCITY, NET_MAX_VELOCITY) * VELOCITY_SCALE);
+}
+
+static float DequantiseVelocity(int value)
+{
+    return (float)value / VELOCITY_SCALE;
+}
+
+static unsigned short QuantiseHeading(float degrees)
+{
+    return (unsigned short)((int)floorf(degrees / 360.0f * HEADING_STEPS + 0.5f) & (HEADING_STEPS - 1));
+}
+
+static float DequantiseHeading(unsigned int value)
+{
+    return (float)value * 360.0f / HEADING_STEPS;
+}
+
+void TakeNetSnapshot(const Match* match, int tick, NetSnapshot* snapshot)
+{
+    snapshot->tick = tick;
+    snapshot->count = match->count;
+    for (int i = 0; i < match->count; i++)
+    {
+        const Tank* tank = &match->tanks[i];
+        snapshot->tanks[i] = tank->alive ? (NetTank){.alive = true,
+                                                     .x = QuantisePosition(tank->pos.x, match->width),
+                                                     .y = QuantisePosition(tank->pos.y, match->height),
+                                                     .vx = QuantiseVelocity(tank->vel.x),
+                                                     .vy = QuantiseVelocity(tank->vel.y),
+                                                     .heading = QuantiseHeading(tank->heading),
+                                                     .gunHeading = QuantiseHeading(tank->gunHeading)}
+                                         : (NetTank){.alive = false};
+    }
+    for (int i = 0; i < match->count * SHOTS_PER_TANK; i++)
+    {
+        const Shot* shot = &match->shots[i];
+        snapshot->shots[i] = shot->alive > 0 ? (NetShot){.alive = true,
+                                                         .x = QuantisePosition(shot->pos.x, match->width),
+                                                         .y = QuantisePosition(shot->pos.y, match->height),
+                                                         .vx = QuantiseVelocity(shot->vel.x),
+                                                         .vy = QuantiseVelocity(shot->vel.y),
+                                                         .heading = QuantiseHeading(shot->heading)}
+                                             : (NetShot){.alive = false};
+    }
+}
+
+void ApplyNetSnapshot(const NetSnapshot* snapshot, Match* match)
+{
+    match->ticks = snapshot->tick;
+    match->count = snapshot->count;
+    for (int i = 0; i < snapshot->count; i++)
+    {
+        const NetTank* from = &snapshot->tanks[i];
+        Tank* tank = &match->tanks[i];
+        tank->alive = from->alive;
+        tank->pos = (Vector2){DequantisePosition(from->x, match->width), DequantisePosition(from->y, match->height)};
+        tank->vel = (Vector2){DequantiseVelocity(from->vx), DequantiseVelocity(from->vy)};
+        tank->heading = DequantiseHeading(from->heading);
+        tank->gunHeading = DequantiseHeading(from->gunHeading);
+        tank->speed = Vector2Length(tank->vel);
+    }
+    for (int i = 0; i < snapshot->count * SHOTS_PER_TANK; i++)
+    {
+        const NetShot* from = &snapshot->shots[i];
+        Shot* shot = &match->shots[i];
+
+        // The client doesn't know how long a shot has left, only that it's still going.
+        shot->alive = from->alive ? 1 : 0;
+        shot->pos = (Vector2){DequantisePosition(from->x, match->width), DequantisePosition(from->y, match->height)};
+        shot->vel = (Vector2){DequantiseVelocity(from->vx), DequantiseVelocity(from->vy)};
+        shot->heading = DequantiseHeading(from->heading);
+    }
+}
+
+void InitNetHistory(NetHistory* history)
+{
+    for (int i = 0; i < NET_HISTORY; i++)
+    {
+        history->snapshots[i].tick = NET_NO_BASELINE;
+    }
+}
+
+void StoreNetSnapshot(NetHistory* history, const NetSnapshot* snapshot)
+{
+    history->snapshots[snapshot->tick % NET_HISTORY] = *snapshot;
+}
+
+const NetSnapshot* FindNetSnapshot(const NetHistory* history, int tick)
+{
+    if (tick < 0)
+    {
+        return NULL;
+    }
+    const NetSnapshot* snapshot = &history->snapshots[tick % NET_HISTORY];
+    return snapshot->tick == tick ? snapshot : NULL;
+}
+
+// Is a quantised coordinate no more than extent steps after start, going round the arena?
+static bool IsWithin(unsigned int value, unsigned int start, unsigned int extent)
+{
+    return ((value - start) & (POSITION_STEPS - 1)) <= extent;
+}
+
+void CullNetSnapshot(NetSnapshot* snapshot, Rectangle view, float margin, float width, float height)
+{
+    // Anything that sees the whole arena sees everything.
+    const float steps = (float)POSITION_STEPS;
+    const float extentX = ceilf((view.width + 2.0f * margin) / width * steps);
+    const float extentY = ceilf((view.height + 2.0f * margin) / height * steps);
+    if (extentX >= steps && extentY >= steps)
+    {
+        return;
+    }
+
+    const unsigned int left = QuantisePosition(view.x - margin, width);
+    const unsigned int top = QuantisePosition(view.y - margin, height);
+    const unsigned int across = extentX < steps ? (unsigned int)extentX : POSITION_STEPS;
+    const unsigned int down = extentY < steps ? (unsigned int)extentY : POSITION_STEPS;
+    for (int i = 0; i < snapshot->count; i++)
+    {
+        NetTank* tank = &snapshot->tanks[i];
+        if (tank->alive && !(IsWithin(tank->x, left, across) && IsWithin(tank->y, top, down)))
+        {
+            *tank = (NetTank){.alive = false};
+        }
+    }
+    for (int i = 0; i < snapshot->count * SHOTS_PER_TANK; i++)
+    {
+        NetShot* shot = &snapshot->shots[i];
+        if (shot->alive && !(IsWithin(shot->x, left, across) && IsWithin(shot->y, top, down)))
+        {
+            *shot = (NetShot){.alive = false};
+        }
+    }
+}
+
+int WriteNetHello(unsigned char* packet, int capacity, int match)
+{
+    NetWriter writer = BeginMessage(packet, capacity, NET_HELLO);
+    WriteSigned(&writer, match, 32);
+    return EndMessage(&writer);
+}
+
+int WriteNetWelcome(unsigned char* packet, int capacity, const NetWelcome* welcome)
+{
+    NetWriter writer = BeginMessage(packet, capacity, NET_WELCOME);
+    WriteSigned(&writer, welcome->match, 32);
+    WriteSigned(&writer, welcome->tank, 8);
+    WriteF32(&writer, welcome->width);
+    WriteF32(&writer, welcome->height);
+    return EndMessage(&writer);
+}
+
+int WriteNetFull(unsigned char* packet, int capacity)
+{
+    NetWriter writer = BeginMessage(packet, capacity, NET_FULL);
+    return EndMessage(&writer);
+}
+
+int WriteNetInput(unsigned char* packet, int capacity, const NetInput* input)
+{
+    NetWriter writer = BeginMessage(packet, capacity, NET_INPUT);
+    WriteSigned(&writer, input->sequence, 32);
+    WriteSigned(&writer, input->ack, 32);
+    WriteBool(&writer, input->controls.thrust);
+    WriteBool(&writer, input->controls.reverse);
+    WriteBool(&writer, input->fire);
+    WriteBits(&writer, 0, 5);
+    WriteAxis(&writer, input->controls.turn);
+    WriteAxis(&writer, input->controls.gun);
+    return EndMessage(&writer);
+}
+
+int WriteNetBye(unsigned char* packet, int capacity)
+{
+    NetWriter writer = BeginMessage(packet, capacity, NET_BYE);
+    return EndMessage(&writer);
+}
+
+int WriteNetWatch(unsigned char* packet, int capacity, const NetWatch* watch)
+{
+    NetWriter writer = BeginMessage(packet, capacity, NET_WATCH);
+    WriteSigned(&writer, watch->match, 32);
+    WriteSigned(&writer, watch->ack, 32);
+    WriteF32(&writer, watch->view.x);
+    WriteF32(&writer, watch->view.y);
+    WriteF32(&writer, watch->view.width);
+    WriteF32(&writer, watch->view.height);
+    return EndMessage(&writer);
+}
+
+static bool HasTankChanged(const NetTank* tank, const NetTank* before)
+{
+    if (tank->alive != before->alive)
+    {
+        return true;
+    }
+    return tank->alive && (tank->x != before->x || tank->y != before->y || tank->vx != before->vx || tank->vy != before->vy ||
+                           tank->heading != before->heading || tank->gunHeading != before->gunHeading);
+}
+
+static bool HasShotChanged(const NetShot* shot, const NetShot* before)
+{
+    if (shot->alive != before->alive)
+    {
+        return true;
+    }
+    return shot->alive && (shot->x != before->x || shot->y != before->y || shot->vx != before->vx || shot->vy != before->vy ||
+                           shot->heading != before->heading);
+}
+
+// Write a coordinate as a small move from the baseline's, the shortest way round the arena, if there's a baseline and it's close
+// enough. Otherwise write it in full.
+static void WriteCoordinate(NetWriter* writer, unsigned int value, bool hasBaseline, unsigned int baseline)
+{
+    if (hasBaseline)
+    {
+        int move = (int)((value - baseline) & (POSITION_STEPS - 1));
+        move = move >= POSITION_STEPS / 2 ? move - POSITION_STEPS : move;
+        const bool small = move >= -MOVE_LIMIT && move < MOVE_LIMIT;
+        WriteBool(writer, small);
+        if (small)
+        {
+            WriteSigned(writer, move, NET_MOVE_BITS);
+            return;
+        }
+    }
+    WriteBits(writer, value, NET_POSITION_BITS);
+}
+
+static unsigned short ReadCoordinate(NetReader* reader, bool hasBaseline, unsigned int baseline)
+{
+    if (hasBaseline && ReadBool(reader))
+    {
+        return (unsigned short)((baseline + (unsigned int)ReadSigned(reader, NET_MOVE_BITS)) & (POSITION_STEPS - 1));
+    }
+    return (unsigned short)ReadBits(reader, NET_POSITION_BITS);
+}
+
+// Write a velocity, or just a bit to say that it's the same as the baseline's.
+static void WriteVelocity(NetWriter* writer, int vx, int vy, bool hasBaseline, int baselineX, int baselineY)
+{
+    if (hasBaseline)
+    {
+        const bool same = vx == baselineX && vy == baselineY;
+        WriteBool(writer, same);
+        if (same)
+        {
+            return;
+        }
+    }
+    WriteSigned(writer, vx, NET_VELOCITY_BITS);
+    WriteSigned(writer, vy, NET_VELOCITY_BITS);
+}
+
+static void ReadVelocity(NetReader* reader, short* vx, short* vy, bool hasBaseline, int baselineX, int baselineY)
+{
+    if (hasBaseline && ReadBool(reader))
+    {
+        *vx = (short)baselineX;
+        *vy = (short)baselineY;
+        return;
+    }
+    *vx = (short)ReadSigned(reader, NET_VELOCITY_BITS);
+    *vy = (short)ReadSigned(reader, NET_VELOCITY_BITS);
+}
+
+// Write a heading, or just a bit to say that it's the same as the baseline's.
+static void WriteHeading(NetWriter* writer, unsigned int value, bool hasBaseline, unsigned int baseline)
+{
+    if (hasBaseline)
+    {
+        WriteBool(writer, value == baseline);
+        if (value == baseline)
+        {
+            return;
+        }
+    }
+    WriteBits(writer, value, NET_HEADING_BITS);
+}
+
+static unsigned short ReadHeading(NetReader* reader, bool hasBaseline, unsigned int baseline)
+{
+    if (hasBaseline && ReadBool(reader))
+    {
+        return (unsigned short)baseline;
+    }
+    return (unsigned short)ReadBits(reader, NET_HEADING_BITS);
+}
+
+// A tank that's alive is written relative to the baseline's, if that was alive too.
+static void WriteTank(NetWriter* writer, const NetTank* tank, const NetTank* before)
+{
+    WriteBool(writer, tank->alive);
+    if (tank->alive)
+    {
+        const bool delta = before->alive;
+        WriteCoordinate(writer, tank->x, delta, before->x);
+        WriteCoordinate(writer, tank->y, delta, before->y);
+        WriteVelocity(writer, tank->vx, tank->vy, delta, before->vx, before->vy);
+        WriteHeading(writer, tank->heading, delta, before->heading);
+        WriteHeading(writer, tank->gunHeading, delta, before->gunHeading);
+    }
+}
+
+static void ReadTank(NetReader* reader, NetTank* tank, const NetTank* before)
+{
+    *tank = (NetTank){.alive = ReadBool(reader)};
+    if (tank->alive)
+    {
+        const bool delta = before->alive;
+        tank->x = ReadCoordinate(reader, delta, before->x);
+        tank->y = ReadCoordinate(reader, delta, before->y);
+        ReadVelocity(reader, &tank->vx, &tank->vy, delta, before->vx, before->vy);
+        tank->heading = ReadHeading(reader, delta, before->heading);
+        tank->gunHeading = ReadHeading(reader, delta, before->gunHeading);
+    }
+}
+
+static void WriteShot(NetWriter* writer, const NetShot* shot, const NetShot* before)
+{
+    WriteBool(writer, shot->alive);
+    if (shot->alive)
+    {
+        const bool delta = before->alive;
+        WriteCoordinate(writer, shot->x, delta, before->x);
+        WriteCoordinate(writer, shot->y, delta, before->y);
+        WriteVelocity(writer, shot->vx, shot->vy, delta, before->vx, before->vy);
+        WriteHeading(writer, shot->heading, delta, before->heading);
+    }
+}
+
+static void ReadShot(NetReader* reader, NetShot* shot, const NetShot* before)
+{
+    *shot = (NetShot){.alive = ReadBool(reader)};
+    if (shot->alive)
+    {
+        const bool delta = before->alive;
+        shot->x = ReadCoordinate(reader, delta, before->x);
+        shot->y = ReadCoordinate(reader, delta, before->y);
+        ReadVelocity(reader, &shot->vx, &shot->vy, delta, before->vx, before->vy);
+        shot->heading = ReadHeading(reader, delta, before->heading);
+    }
+}
+
+// A snapshot is a header followed by the tanks, then the shots. Each tank or shot has a bit to say whether it has changed since
+// the baseline, and the ones that have are written relative to the baseline's. Without a baseline, they've all changed, so there
+// are no bits to say so.
+int WriteNetSnapshot(unsigned char* packet, int capacity, const NetSnapshot* snapshot, const NetSnapshot* baseline)
+{
+    static const NetTank noTank = {.alive = false};
+    static const NetShot noShot = {.alive = false};
+
+    if (baseline != NULL && baseline->count != snapshot->count)
+    {
+        baseline = NULL;
+    }
+
+    NetWriter writer = BeginMessage(packet, capacity, NET_SNAPSHOT);
+    WriteSigned(&writer, snapshot->tick, 32);
+    WriteSigned(&writer, baseline != NULL ? baseline->tick : NET_NO_BASELINE, 32);
+    WriteBits(&writer, (unsigned int)snapshot->count, 8);
+
+    for (int i = 0; i < snapshot->count; i++)
+    {
+        const NetTank* before = baseline != NULL ? &baseline->tanks[i] : &noTank;
+        const bool changed = baseline == NULL || HasTankChanged(&snapshot->tanks[i], before);
+        if (baseline != NULL)
+        {
+            WriteBool(&writer, changed);
+        }
+        if (changed)
+        {
+            WriteTank(&writer, &snapshot->tanks[i], before);
+        }
+    }
+
+    for (int i = 0; i < snapshot->count * SHOTS_PER_TANK; i++)
+    {
+        const NetShot* before = baseline != NULL ? &baseline->shots[i] : &noShot;
+        const bool changed = baseline == NULL || HasShotChanged(&snapshot->shots[i], before);
+        if (baseline != NULL)
+        {
+            WriteBool(&writer, changed);
+        }
+        if (changed)
+        {
+            WriteShot(&writer, &snapshot->shots[i], before);
+        }
+    }
+
+    return EndMessage(&writer);
+}
+
+NetMessageType GetNetMessageType(const unsigned char* packet, int size)
+{
+    if (size < 3 || ((unsigned int)packet[0] | ((unsigned int)packet[1] << 8)) != NET_PROTOCOL)
+    {
+        return NET_INVALID;
+    }
+    const unsigned int type = packet[2];
+    return type > NET_INVALID && type <= NET_WATCH ? (NetMessageType)type : NET_INVALID;
+}
+
+bool ReadNetHello(const unsigned char* packet, int size, int* match)
+{
+    NetReader reader = BeginReading(packet, size, NET_HELLO);
+    *match = ReadSigned(&reader, 32);
+    return EndReading(&reader);
+}
+
+bool ReadNetWelcome(const unsigned char* packet, int size, NetWelcome* welcome)
+{
+    NetReader reader = BeginReading(packet, size, NET_WELCOME);
+    welcome->match = ReadSigned(&reader, 32);
+    welcome->tank = ReadSigned(&reader, 8);
+    welcome->width = ReadF32(&reader);
+    welcome->height = ReadF32(&reader);
+    return EndReading(&reader);
+}
+
+bool ReadNetInput(const unsigned char* packet, int size, NetInput* input)
+{
+    NetReader reader = BeginReading(packet, size, NET_INPUT);
+    input->sequence = ReadSigned(&reader, 32);
+    input->ack = ReadSigned(&reader, 32);
+    input->controls.thrust = ReadBool(&reader);
+    input->controls.reverse = ReadBool(&reader);
+    input->fire = ReadBool(&reader);
+    ReadBits(&reader, 5);
+    input->controls.turn = ReadAxis(&reader);
+    input->controls.gun = ReadAxis(&reader);
+    return EndReading(&reader);
+}
+
+bool ReadNetWatch(const unsigned char* packet, int size, NetWatch* watch)
+{
+    NetReader reader = BeginReading(packet, size, NET_WATCH);
+    watch->match = ReadSigned(&reader, 32);
+    watch->ack = ReadSigned(&reader, 32);
+    watch->view.x = ReadF32(&reader);
+    watch->view.y = ReadF32(&reader);
+    watch->view.width = ReadF32(&reader);
+    watch->view.height = ReadF32(&reader);
+    return EndReading(&reader);
+}
+
+int GetNetSnapshotBaseline(const unsigned char* packet, int size)
+{
+    NetReader reader = BeginReading(packet, size, NET_SNAPSHOT);
+    ReadSigned(&reader, 32);
+    const int baseline = ReadSigned(&reader, 32);
+    return reader.failed ? NET_NO_BASELINE : baseline;
+}
+
+bool ReadNetSnapshot(const unsigned char* packet, int size, const NetSnapshot* baseline, NetSnapshot* snapshot)
+{
+    static const NetTank noTank = {.alive = false};
+    static const NetShot noShot = {.alive = false};
+
+    NetReader reader = BeginReading(packet, size, NET_SNAPSHOT);
+    snapshot->tick = ReadSigned(&reader, 32);
+    const int baselineTick = ReadSigned(&reader, 32);
+    snapshot->count = (int)ReadBits(&reader, 8);
+    if (reader.failed || snapshot->count > MAX_TANKS || (baselineTick == NET_NO_BASELINE) != (baseline == NULL) ||
+        (baseline != NULL && (baseline->tick != baselineTick || baseline->count != snapshot->count)))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < snapshot->count; i++)
+    {
+        const NetTank* before = baseline != NULL ? &baseline->tanks[i] : &noTank;
+        if (baseline == NULL || ReadBool(&reader))
+        {
+            ReadTank(&reader, &snapshot->tanks[i], before);
+        }
+        else
+        {
+            snapshot->tanks[i] = *before;
+        }
+    }
+
+    for (int i = 0; i < snapshot->count * SHOTS_PER_TANK; i++)
+    {
+        const NetShot* before = baseline != NULL ? &baseline->shots[i] : &noShot;
+        if (baseline == NULL || ReadBool(&reader))
+        {
+            ReadShot(&reader, &snapshot->shots[i], before);
+        }
+        else
+        {
+            snapshot->shots[i] = *before;
+        }
+    }
+
+    return EndReading(&reader);
+}
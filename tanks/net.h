@@ -0,0 +1,154 @@
+#pragma once
+
+#include "match.h"
+#include "raylib.h"
+#include "tanks.h"
+
+#include <stdbool.h>
+
+// The tanks protocol, for a server that runs matches and clients that drive tanks in them over UDP.
+//
+//   client -> server  HELLO      which match the client wants to join, or -1 for any
+//   server -> client  WELCOME    which match and tank the client has, and the size of the arena
+//   server -> client  FULL       there's no room
+//   client -> server  INPUT      the client's controls, and the last snapshot that it received
+//   server -> client  SNAPSHOT   the match, as a delta from the last snapshot that the client said it received
+//   client -> server  BYE        the client is leaving
+//   client -> server  WATCH      which match a spectator wants to watch, the part of the arena that it can see, and the last
+//                                snapshot that it received
+//
+// A spectator doesn't say hello. It sends WATCH until it's welcomed, without a tank, and every time that it receives a snapshot.
+// Its snapshots only have the tanks and shots that are in or near the part of the arena that it can see, which in a big arena is
+// a fraction of them.
+//
+// Every packet starts with NET_PROTOCOL and a message type. Everything is packed into bits, least significant first, and most
+// messages happen to be whole bytes.
+//
+// Snapshots are quantised. Positions are fractions of the arena's size, so they wrap for free, velocities are fixed point, and
+// headings are fractions of a turn. Each tank or shot has a bit that says whether it has changed since the baseline, and for those
+// that have, each field is sent in full or, if it's close to the baseline's, as a small change.
+#define NET_PROTOCOL 0x4b54 // "TK"
+#define NET_DEFAULT_PORT 27960
+#define NET_MAX_PACKET 16384 // Big enough for a full snapshot of a match with MAX_TANKS tanks, each with all of its shots.
+#define NET_HISTORY 16       // How many snapshots are kept to be delta-encoded against.
+#define NET_POSITION_BITS 14 // How many bits there are in each coordinate of a position.
+#define NET_MOVE_BITS 10     // How many bits there are in each coordinate of a small move from the baseline's position.
+#define NET_VELOCITY_BITS 12 // How many bits there are in each component of a velocity, including the sign.
+#define NET_MAX_VELOCITY 16.0f
+#define NET_HEADING_BITS 10
+#define NET_ANY_MATCH -1
+#define NET_NO_BASELINE -1
+#define NET_NO_TANK -1
+
+typedef enum
+{
+    NET_INVALID,
+    NET_HELLO,
+    NET_WELCOME,
+    NET_FULL,
+    NET_INPUT,
+    NET_SNAPSHOT,
+    NET_BYE,
+    NET_WATCH
+} NetMessageType;
+
+// Where a client has been put.
+typedef struct
+{
+    int match;    // Which match is the client in?
+    int tank;     // Which tank does it drive, or NET_NO_TANK for a spectator?
+    float width;  // How wide is the arena?
+    float height; // How tall is the arena?
+} NetWelcome;
+
+// What a client wants its tank to do.
+typedef struct
+{
+    int sequence;          // Counts up with each input, so that the server can ignore inputs that arrive out of order.
+    int ack;               // The tick of the last snapshot that the client received, or NET_NO_BASELINE.
+    TankControls controls; // What the tank should do.
+    bool fire;             // Should the tank fire?
+} NetInput;
+
+// What a spectator wants to see.
+typedef struct
+{
+    int match;      // Which match does it want to watch?
+    int ack;        // The tick of the last snapshot that it received, or NET_NO_BASELINE.
+    Rectangle view; // Which part of the arena can it see? It can go off the right and the bottom, and wrap round.
+} NetWatch;
+
+// What a client sees of a tank, quantised.
+typedef struct
+{
+    bool alive;
+    unsigned short x;          // NET_POSITION_BITS.
+    unsigned short y;          // NET_POSITION_BITS.
+    short vx;                  // NET_VELOCITY_BITS.
+    short vy;                  // NET_VELOCITY_BITS.
+    unsigned short heading;    // NET_HEADING_BITS.
+    unsigned short gunHeading; // NET_HEADING_BITS.
+} NetTank;
+
+// What a client sees of a shot, quantised.
+typedef struct
+{
+    bool alive;
+    unsigned short x;       // NET_POSITION_BITS.
+    unsigned short y;       // NET_POSITION_BITS.
+    short vx;               // NET_VELOCITY_BITS.
+    short vy;               // NET_VELOCITY_BITS.
+    unsigned short heading; // NET_HEADING_BITS.
+} NetShot;
+
+// What a client sees of a match at the end of a tick. It's quantised when it's taken, so the server's copy of a snapshot is
+// exactly the same as the client's, and deltas between them are exact.
+typedef struct
+{
+    int tick;                 // Which tick is this? Snapshots are delta-encoded against earlier ticks, so it never goes back.
+    int count;                // How many tanks are there?
+    NetTank tanks[MAX_TANKS]; // The tanks.
+    NetShot shots[MAX_SHOTS]; // The shots, SHOTS_PER_TANK to a tank.
+} NetSnapshot;
+
+// The last NET_HISTORY snapshots, by tick.
+typedef struct
+{
+    NetSnapshot snapshots[NET_HISTORY];
+} NetHistory;
+
+// clang-format off
+
+// Snapshots.
+void TakeNetSnapshot(const Match* match, int tick, NetSnapshot* snapshot);      // Take a quantised snapshot of a match.
+void ApplyNetSnapshot(const NetSnapshot* snapshot, Match* match);               // Make a match look like a snapshot, as far as it can.
+void InitNetHistory(NetHistory* history);                                       // Empty a history.
+void StoreNetSnapshot(NetHistory* history, const NetSnapshot* snapshot);        // Add a snapshot to a history, replacing an old one.
+const NetSnapshot* FindNetSnapshot(const NetHistory* history, int tick);        // Find a snapshot in a history, or NULL if it has gone.
+
+// Leave out the tanks and shots that aren't within margin of a view of an arena of the given size, as if they weren't there.
+void CullNetSnapshot(NetSnapshot* snapshot, Rectangle view, float margin, float width, float height);
+
+// Writing messages. Each returns the size of the packet, or 0 if it didn't fit.
+int WriteNetHello(unsigned char* packet, int capacity, int match);
+int WriteNetWelcome(unsigned char* packet, int capacity, const NetWelcome* welcome);
+int WriteNetFull(unsigned char* packet, int capacity);
+int WriteNetInput(unsigned char* packet, int capacity, const NetInput* input);
+int WriteNetBye(unsigned char* packet, int capacity);
+int WriteNetWatch(unsigned char* packet, int capacity, const NetWatch* watch);
+
+// Write a snapshot as a delta from a baseline that the client has, or in full if the baseline is NULL.
+int WriteNetSnapshot(unsigned char* packet, int capacity, const NetSnapshot* snapshot, const NetSnapshot* baseline);
+
+// Reading messages. Each returns false if the packet is malformed.
+NetMessageType GetNetMessageType(const unsigned char* packet, int size);       // Get a packet's type, or NET_INVALID.
+bool ReadNetHello(const unsigned char* packet, int size, int* match);
+bool ReadNetWelcome(const unsigned char* packet, int size, NetWelcome* welcome);
+bool ReadNetInput(const unsigned char* packet, int size, NetInput* input);
+bool ReadNetWatch(const unsigned char* packet, int size, NetWatch* watch);
+int GetNetSnapshotBaseline(const unsigned char* packet, int size);             // Get the tick that a snapshot is a delta from.
+
+// Read a snapshot, given the baseline that it's a delta from, which must be NULL if it's a full snapshot.
+bool ReadNetSnapshot(const unsigned char* packet, int size, const NetSnapshot* baseline, NetSnapshot* snapshot);
+
+// clang-format on
@@ -0,0 +1,289 @@
+// Measures how big the tanks' snapshots are, and checks that they survive being sent, without opening a window.
+//
+// Usage: net_bench [ticks]
+//
+// For 4 and then 64 tanks, bots play for the given number of ticks, starting a new match whenever there's at most one tank left.
+// Every tick's snapshot is written in full, then as a delta from the snapshot a few ticks before, as if that was the last one that
+// the client acknowledged. Each is read back and checked against the original, which it must match exactly, and what the client
+// would see is checked against the match itself, which it must match to within the quantisation.
+//
+// The arena grows with the number of tanks, as it does on the server, so 64 tanks are in an arena four times the size of the
+// screen. Each tick is also culled to what a spectator with a screen-sized view that follows the first tank could see, and written
+// as a delta from what the spectator was sent the tick before.
+//
+// Each tick also goes into a kill-cam replay. Its oldest tick is read back, which means decoding from a keyframe, then its latest,
+// which has to match the match to within the quantisation.
+//
+// It reports the average bytes per tick for one client, alongside what it would take to send every tank and shot as floats, and
+// how long writing and reading take. It fails if anything didn't match.
+
+#define BDR_BENCH_IMPLEMENTATION
+#include "ai.h"
+#include "bdr/bench.h"
+#include "match.h"
+#include "net.h"
+#include "replay.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_WIDTH 1280.0f
+#define ARENA_HEIGHT 720.0f
+#define VIEW_MARGIN (4 * TANK_SCALE)
+#define UPDATE_FPS 50
+#define DEFAULT_TICKS 5000
+#define NUM_LAGS (sizeof(ackLags) / sizeof(ackLags[0]))
+#define BOT_GROUPS ((MAX_TANKS + MAX_BOTS - 1) / MAX_BOTS)
+
+static const int tankCounts[] = {4, 64};
+static const int ackLags[] = {1, 4}; // How many ticks old is the client's last acknowledged snapshot?
+
+static Match match;
+static Match view;
+static Bots bots[BOT_GROUPS]; // There can be more tanks than bots, so they're driven by as many groups of bots as it takes.
+static NetHistory history;
+static NetHistory seenHistory; // What the spectator was sent.
+static NetSnapshot decoded;
+static Replay replay;
+static unsigned char packet[NET_MAX_PACKET];
+
+static bool IsSameTank(const NetTank* a, const NetTank* b)
+{
+    return a->alive == b->alive && (!a->alive || (a->x == b->x && a->y == b->y && a->vx == b->vx && a->vy == b->vy &&
+                                                  a->heading == b->heading && a->gunHeading == b->gunHeading));
+}
+
+static bool IsSameShot(const NetShot* a, const NetShot* b)
+{
+    return a->alive == b->alive &&
+           (!a->alive || (a->x == b->x && a->y == b->y && a->vx == b->vx && a->vy == b->vy && a->heading == b->heading));
+}
+
+static bool IsSameSnapshot(const NetSnapshot* a, const NetSnapshot* b)
+{
+    bool same = a->tick == b->tick && a->count == b->count;
+    for (int i = 0; same && i < a->count; i++)
+    {
+        same = IsSameTank(&a->tanks[i], &b->tanks[i]);
+    }
+    for (int i = 0; same && i < a->count * SHOTS_PER_TANK; i++)
+    {
+        same = IsSameShot(&a->shots[i], &b->shots[i]);
+    }
+    return same;
+}
+
+// How far apart are two coordinates, the shortest way round the arena?
+static float WrappedError(float a, float b, float size)
+{
+    const float error = fabsf(a - b);
+    return fminf(error, size - error);
+}
+
+static float HeadingError(float a, float b)
+{
+    return WrappedError(fmodf(fmodf(a, 360.0f) + 360.0f, 360.0f), fmodf(fmodf(b, 360.0f) + 360.0f, 360.0f), 360.0f);
+}
+
+// Check that what the client sees is within the quantisation of the match.
+static bool IsCloseEnough(const Match* seen, const Match* actual)
+{
+    const float positionError = 0.5f * fmaxf(actual->width, actual->height) / (1 << NET_POSITION_BITS) + 1e-3f;
+    const float velocityError = 0.5f * NET_MAX_VELOCITY / ((1 << (NET_VELOCITY_BITS - 1)) - 1) + 1e-4f;
+    const float headingError = 0.5f * 360.0f / (1 << NET_HEADING_BITS) + 1e-3f;
+    bool close = true;
+    for (int i = 0; i < actual->count; i++)
+    {
+        const Tank* a = &seen->tanks[i];
+        const Tank* b = &actual->tanks[i];
+        close = close && a->alive == b->alive;
+        if (b->alive)
+        {
+            close = close && WrappedError(a->pos.x, b->pos.x, actual->width) <= positionError &&
+                    WrappedError(a->pos.y, b->pos.y, actual->height) <= positionError &&
+                    fabsf(a->vel.x - b->vel.x) <= velocityError && fabsf(a->vel.y - b->vel.y) <= velocityError &&
+                    HeadingError(a->heading, b->heading) <= headingError &&
+                    HeadingError(a->gunHeading, b->gunHeading) <= headingError;
+        }
+    }
+    for (int i = 0; i < actual->count * SHOTS_PER_TANK; i++)
+    {
+        const Shot* a = &seen->shots[i];
+        const Shot* b = &actual->shots[i];
+        close = close && (a->alive > 0) == (b->alive > 0);
+        if (b->alive > 0)
+        {
+            close = close && WrappedError(a->pos.x, b->pos.x, actual->width) <= positionError &&
+                    WrappedError(a->pos.y, b->pos.y, actual->height) <= positionError &&
+                    fabsf(a->vel.x - b->vel.x) <= velocityError && fabsf(a->vel.y - b->vel.y) <= velocityError &&
+                    HeadingError(a->heading, b->heading) <= headingError;
+        }
+    }
+    return close;
+}
+
+// How big would a snapshot be if every tank and shot that's alive was sent as floats, with a byte to say whether it's alive?
+static int GetFloatSize(const Match* m)
+{
+    int size = 12;
+    for (int i = 0; i < m->count; i++)
+    {
+        size += m->tanks[i].alive ? 1 + 6 * 4 : 1;
+    }
+    for (int i = 0; i < m->count * SHOTS_PER_TANK; i++)
+    {
+        size += m->shots[i].alive > 0 ? 1 + 5 * 4 : 1;
+    }
+    return size;
+}
+
+static void StartMatch(int tanks, unsigned int seed)
+{
+    const MatchRules rules = GetDefaultMatchRules();
+    const float scale = tanks > MAX_PLAYERS ? sqrtf((float)tanks / MAX_PLAYERS) : 1.0f;
+    InitMatch(&match, &rules, tanks, 0, ARENA_WIDTH * scale, ARENA_HEIGHT * scale, seed);
+    for (int group = 0; group < BOT_GROUPS; group++)
+    {
+        const int first = group * MAX_BOTS;
+        const int count = tanks - first;
+        InitBots(&bots[group], count > 0 ? count : 0, first, seed + 1 + (unsigned int)group);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    const int ticks = argc > 1 ? atoi(argv[1]) : DEFAULT_TICKS;
+    if (argc > 2 || ticks <= NET_HISTORY)
+    {
+        fprintf(stderr, "Usage: %s [ticks (more than %d)]\n", argv[0], NET_HISTORY);
+        return EXIT_FAILURE;
+    }
+
+    bool mismatched = false;
+    printf("Bytes per tick for one client, averaged over %d ticks\n", ticks);
+    for (size_t c = 0; c < sizeof(tankCounts) / sizeof(tankCounts[0]); c++)
+    {
+        const int tanks = tankCounts[c];
+        unsigned int seed = 0;
+        StartMatch(tanks, seed);
+        InitNetHistory(&history);
+        InitNetHistory(&seenHistory);
+        view.width = match.width;
+        view.height = match.height;
+        InitReplay(&replay);
+
+        long long floatBytes = 0;
+        long long fullBytes = 0;
+        long long deltaBytes[NUM_LAGS] = {0};
+        int deltas[NUM_LAGS] = {0};
+        long long seenBytes = 0;
+        Vector2 camera = {match.width / 2, match.height / 2};
+        double writeTime = 0.0;
+        double readTime = 0.0;
+        int encodings = 0;
+        double replayTime = 0.0;
+        int mismatches = 0;
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            TankControls controls[MAX_TANKS];
+            ShotRequest requests[MAX_SHOT_REQUESTS];
+            int numRequests = 0;
+            for (int group = 0; group < BOT_GROUPS; group++)
+            {
+                DecideBots(&bots[group], &match);
+                numRequests += GetBotControls(&bots[group], controls, requests + numRequests);
+            }
+            UpdateMatch(&match, controls, requests, numRequests);
+            if (CountLivingTanks(&match) <= 1)
+            {
+                StartMatch(tanks, ++seed);
+            }
+
+            NetSnapshot* snapshot = &history.snapshots[tick % NET_HISTORY];
+            TakeNetSnapshot(&match, tick, snapshot);
+            floatBytes += GetFloatSize(&match);
+
+            // Write it in full, then as deltas. Deltas can only be taken once there's a baseline to take them from.
+            for (int lag = -1; lag < (int)NUM_LAGS; lag++)
+            {
+                const NetSnapshot* baseline = lag < 0 ? NULL : FindNetSnapshot(&history, tick - ackLags[lag]);
+                if (lag >= 0 && baseline == NULL)
+                {
+                    continue;
+                }
+
+                const double writeStart = GetBenchTime();
+                const int size = WriteNetSnapshot(packet, sizeof(packet), snapshot, baseline);
+                const double readStart = GetBenchTime();
+                const bool read = ReadNetSnapshot(packet, size, baseline, &decoded);
+                readTime += GetBenchTime() - readStart;
+                writeTime += readStart - writeStart;
+                ++encodings;
+
+                ApplyNetSnapshot(&decoded, &view);
+                if (size == 0 || !read || !IsSameSnapshot(&decoded, snapshot) || !IsCloseEnough(&view, &match))
+                {
+                    ++mismatches;
+                }
+                if (lag < 0)
+                {
+                    fullBytes += size;
+                }
+                else
+                {
+                    deltaBytes[lag] += size;
+                    ++deltas[lag];
+                }
+            }
+
+            // Cull it to what the spectator can see, then write it as a delta from what the spectator was sent the tick before.
+            camera = match.tanks[0].alive ? match.tanks[0].pos : camera;
+            const Rectangle seenArea = {fmodf(camera.x - ARENA_WIDTH / 2 + match.width, match.width),
+                                        fmodf(camera.y - ARENA_HEIGHT / 2 + match.height, match.height), ARENA_WIDTH, ARENA_HEIGHT};
+            NetSnapshot* seen = &seenHistory.snapshots[tick % NET_HISTORY];
+            *seen = *snapshot;
+            CullNetSnapshot(seen, seenArea, VIEW_MARGIN, match.width, match.height);
+            const NetSnapshot* seenBaseline = FindNetSnapshot(&seenHistory, tick - 1);
+            const int seenSize = WriteNetSnapshot(packet, sizeof(packet), seen, seenBaseline);
+            if (seenSize == 0 || !ReadNetSnapshot(packet, seenSize, seenBaseline, &decoded) || !IsSameSnapshot(&decoded, seen))
+            {
+                ++mismatches;
+            }
+            seenBytes += seenSize;
+
+            // Record it, then read back the oldest tick and the latest one.
+            int first;
+            int last;
+            RecordReplay(&replay, &match);
+            const double replayStart = GetBenchTime();
+            const bool replayed = GetReplayTicks(&replay, &first, &last) && ReadReplay(&replay, first, &view) &&
+                                  ReadReplay(&replay, last, &view);
+            replayTime += GetBenchTime() - replayStart;
+            if (!replayed || last != match.ticks || !IsCloseEnough(&view, &match))
+            {
+                ++mismatches;
+            }
+        }
+
+        printf("%2d tanks: floats %.0f B, full %.0f B", tanks, (double)floatBytes / ticks, (double)fullBytes / ticks);
+        for (size_t lag = 0; lag < NUM_LAGS; lag++)
+        {
+            printf(", delta from %d tick(s) ago %.0f B", ackLags[lag], (double)deltaBytes[lag] / deltas[lag]);
+        }
+        printf(", spectator %.0f B", (double)seenBytes / ticks);
+        printf(", write %.2f us, read %.2f us", 1e6 * writeTime / encodings, 1e6 * readTime / encodings);
+        if (mismatches > 0)
+        {
+            printf(" %d MISMATCH(ES)", mismatches);
+            mismatched = true;
+        }
+        printf("\n");
+        printf("          replay keeps %d ticks in %.1f KB, reading the oldest then the latest takes %.1f us\n", replay.count,
+               GetReplaySize(&replay) / 1024.0, 1e6 * replayTime / ticks);
+        printf("          %d clients at %d Hz with deltas from %d tick(s) ago: %.1f KB/s\n", tanks, UPDATE_FPS, ackLags[0],
+               (double)deltaBytes[0] / deltas[0] * tanks * UPDATE_FPS / 1024.0);
+    }
+
+    return mismatched ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -1,157 +1,63 @@
+#include "ai.h"
+#include "bdr/latency.h"
+#include "bdr/loop.h"
+#include "bdr/scaling.h"
+#include "draw.h"
+#include "events.h"
+#include "lidar.h"
+#include "match.h"
 #include "raylib.h"
 #include "raymath.h"
+#include "replay.h"
 #include "tanks.h"
 
 #include <stdio.h>
 
-#define TANK_SCALE 16.0f
-#define TANK_OVERLAP (2 * TANK_SCALE)
-#define MAX_ROTATION_SPEED 2.0f
-#define TANK_ACCEL 0.05f
-#define MAX_SPEED 2.0f
-#define MAX_REVERSE_SPEED -1.0f
-#define SHOT_SPEED 6.0f
-#define SHOT_DURATION 90
-#define TANK_COLLISION_RADIUS TANK_SCALE
-#define SHOT_COLLISION_RADIUS (TANK_SCALE * 0.5f)
+#define MAX_FIRE_EVENTS MAX_SHOT_REQUESTS
 
-#define SHOTS_PER_PLAYER 5
-#define MAX_SHOTS (SHOTS_PER_PLAYER * MAX_PLAYERS)
-
-#define MAX_LINES 12
-
-typedef Vector2 Position;
-typedef Vector2 Velocity;
-typedef float Heading;
-typedef float Speed;
+#define KILL_CAM_BEFORE 100   // How many ticks before the last kill the kill cam starts.
+#define KILL_CAM_AFTER 25     // How many ticks after the last kill the kill cam stops, if the match has got that far.
+#define KILL_CAM_SPEED 0.25   // How many ticks the kill cam plays in each fixed update.
+#define REWIND_SPEED 2        // How many ticks each fixed update rewinds or fast forwards by when paused.
 
 typedef enum
 {
     PLAYING,
     PAUSED,
+    REPLAYING,
     CANCELLED
 } PlayingState;
 
-// TODO: lidar
+// A fire button press, waiting for the fixed update that it belongs to.
 typedef struct
 {
-    bool alive;
-    int player;
-    Position pos;
-    Velocity vel;
-    Heading heading;
-    Heading gunHeading;
-    Speed speed;
-    ControllerId controller;
-    int index;
-} Tank;
+    double time;    // When was it pressed (physics time)?
+    double sampled; // When was it sampled (input sample time), for latency tracking?
+    int tank;       // Which tank fired?
+} FireEvent;
 
-typedef struct
-{
-    int alive;
-    Position pos;
-    Velocity vel;
-    Heading heading;
-} Shot;
+static Match match;
+static ControllerId tankControllers[MAX_TANKS]; // Which controller drives each tank?
+static double lastInputTimes[MAX_TANKS];       // When did each tank last act on an input event from its controller?
 
-// Types of draw command.
-typedef enum
-{
-    END,  // Indicates the last command.
-    MOVE, // Move to a given position.
-    LINE  // Draw a line from the current position to the given position. If there is no current position, start from the origin.
-} CommandType;
+static FireEvent fireEvents[MAX_FIRE_EVENTS];
+static int numFireEvents = 0;
 
-// A draw command.
-typedef struct
-{
-    CommandType type;
-    Vector2 pos;
-} Command;
-
-static Tank tanks[MAX_PLAYERS];
-static int numPlayers = 0;
-
-static Shot shots[MAX_PLAYERS * SHOTS_PER_PLAYER];
-
-static Color tankColours[MAX_PLAYERS];
-
-// Shot appearance (+x is right, +y is down).
-const Vector2 shotLines[] = {{0, -0.25f}, {0, 0.25f}};
-
-// Tank appearances (+x is right, +y is down). Currently they're all identical.
-const Command tankCommands[][MAX_LINES] = {
-        // Tank 0.
-        {{MOVE, {-0.67f, -1}},
-         {LINE, {0.67f, -1}},
-         {LINE, {1.0f, -0.67f}},
-         {LINE, {1, 1}},
-         {LINE, {-1, 1}},
-         {LINE, {-1, -0.67f}},
-         {LINE, {-0.67f, -1}},
-         {END, {0, 0}}},
-        // Tank 1.
-        {{MOVE, {-0.67f, -1}},
-         {LINE, {0.67f, -1}},
-         {LINE, {1.0f, -0.67f}},
-         {LINE, {1, 1}},
-         {LINE, {-1, 1}},
-         {LINE, {-1, -0.67f}},
-         {LINE, {-0.67f, -1}},
-         {END, {0, 0}}},
-        // Tank 2.
-        {{MOVE, {-0.67f, -1}},
-         {LINE, {0.67f, -1}},
-         {LINE, {1.0f, -0.67f}},
-         {LINE, {1, 1}},
-         {LINE, {-1, 1}},
-         {LINE, {-1, -0.67f}},
-         {LINE, {-0.67f, -1}},
-         {END, {0, 0}}},
-        // Tank 3.
-        {{MOVE, {-0.67f, -1}},
-         {LINE, {0.67f, -1}},
-         {LINE, {1.0f, -0.67f}},
-         {LINE, {1, 1}},
-         {LINE, {-1, 1}},
-         {LINE, {-1, -0.67f}},
-         {LINE, {-0.67f, -1}},
-         {END, {0, 0}}},
-};
-
-// Gun appearances. Currently they're all identical.
-const Command gunCommands[][MAX_LINES] = {
-        // Gun 0.
-        {{MOVE, {-0.125f, -1}},
-         {LINE, {0.125f, -1}},
-         {LINE, {0.125f, 0.125f}},
-         {LINE, {-0.125f, 0.125f}},
-         {LINE, {-0.125f, -1}},
-         {END, {0, 0}}},
-        // Gun 1.
-        {{MOVE, {-0.125f, -1}},
-         {LINE, {0.125f, -1}},
-         {LINE, {0.125f, 0.125f}},
-         {LINE, {-0.125f, 0.125f}},
-         {LINE, {-0.125f, -1}},
-         {END, {0, 0}}},
-        // Gun 2.
-        {{MOVE, {-0.125f, -1}},
-         {LINE, {0.125f, -1}},
-         {LINE, {0.125f, 0.125f}},
-         {LINE, {-0.125f, 0.125f}},
-         {LINE, {-0.125f, -1}},
-         {END, {0, 0}}},
-        // Gun 3.
-        {{MOVE, {-0.125f, -1}},
-         {LINE, {0.125f, -1}},
-         {LINE, {0.125f, 0.125f}},
-         {LINE, {-0.125f, 0.125f}},
-         {LINE, {-0.125f, -1}},
-         {END, {0, 0}}},
-};
-
-static const char* pausedText = "Paused - Press [R] to resume";
+static bool showLidar = false;
+
+static Bots bots;
+
+static Replay replay;         // The last few seconds of the match.
+static Match replayed;        // What the match looked like at the replay's tick.
+static bool showReplayed;     // Is the replayed match drawn, rather than the match itself?
+static double replayTick;     // Which tick is being replayed? The kill cam's slow motion takes it part way between ticks.
+static int replayEnd;         // Which tick does the kill cam stop at?
+static int lastKill;          // Which tick was the last kill on, or -1 if there hasn't been one?
+static bool killCamRequested; // Does someone want to see the last kill again?
+static int rewinding;         // Is the replay being rewound (-1), fast forwarded (1), or neither (0)?
+
+static const char* pausedText = "Paused - Press [R] to resume, or hold [[] / []] to rewind";
+static const char* killCamText = "[K] Kill cam";
 
 static int screenWidth;
 static int screenHeight;
@@ -160,396 +66,134 @@ static bool pauseOrQuitRequested;
 static bool resumeRequested;
 static PlayingState state;
 
-static bool IsControllerThrustDown(int controller)
-{
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_GAMEPAD2:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_GAMEPAD3:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_GAMEPAD4:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_RIGHT_FACE_DOWN);
-    case CONTROLLER_KEYBOARD1:
-        return IsKeyDown(KEY_W);
-    case CONTROLLER_KEYBOARD2:
-        return IsKeyDown(KEY_UP);
-    default:
-        return false;
-    }
-}
-
-static bool IsControllerReverseDown(int controller)
-{
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT);
-    case CONTROLLER_GAMEPAD2:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT);
-    case CONTROLLER_GAMEPAD3:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT);
-    case CONTROLLER_GAMEPAD4:
-        return IsGamepadButtonDown(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_RIGHT_FACE_RIGHT);
-    case CONTROLLER_KEYBOARD1:
-        return IsKeyDown(KEY_S);
-    case CONTROLLER_KEYBOARD2:
-        return IsKeyDown(KEY_DOWN);
-    default:
-        return false;
-    }
-}
-
-static bool IsControllerFirePressed(int controller)
+// Get what a tank's controller wants it to do. Bots drive their controllers too, so there's no need to tell them apart.
+static TankControls ReadControls(int tank)
 {
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_GAMEPAD2:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_GAMEPAD3:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_GAMEPAD4:
-        return IsGamepadButtonPressed(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_RIGHT_FACE_LEFT);
-    case CONTROLLER_KEYBOARD1:
-        return IsKeyPressed(KEY_SPACE);
-    case CONTROLLER_KEYBOARD2:
-        return IsKeyPressed(KEY_ENTER) || IsKeyPressed(KEY_KP_ENTER);
-    default:
-        return false;
-    }
-}
+    const ControllerId controller = tankControllers[tank];
 
-static float GetControllerTurnRate(int controller)
-{
-    switch (controller)
+    // Let latency tracking know when we first act on a new input event.
+    const double eventTime = GetControllerEventTime(controller);
+    if (match.tanks[tank].alive && eventTime > lastInputTimes[tank])
     {
-    case CONTROLLER_GAMEPAD1:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER1, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_GAMEPAD2:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER2, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_GAMEPAD3:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER3, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_GAMEPAD4:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER4, GAMEPAD_AXIS_LEFT_X);
-    case CONTROLLER_KEYBOARD1:
-        return (IsKeyDown(KEY_D) ? 1.0f : 0.0f) - (IsKeyDown(KEY_A) ? 1.0f : 0.0f);
-    case CONTROLLER_KEYBOARD2:
-        return (IsKeyDown(KEY_RIGHT) ? 1.0f : 0.0f) - (IsKeyDown(KEY_LEFT) ? 1.0f : 0.0f);
-    default:
-        return 0.0f;
+        lastInputTimes[tank] = eventTime;
+        MarkInputConsumed(controller, eventTime, GetTime());
     }
-}
 
-static float GetGunTurnRate(int controller)
-{
-    switch (controller)
-    {
-    case CONTROLLER_GAMEPAD1:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER1, GAMEPAD_AXIS_RIGHT_X);
-    case CONTROLLER_GAMEPAD2:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER2, GAMEPAD_AXIS_RIGHT_X);
-    case CONTROLLER_GAMEPAD3:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER3, GAMEPAD_AXIS_RIGHT_X);
-    case CONTROLLER_GAMEPAD4:
-        return GetGamepadAxisMovement(GAMEPAD_PLAYER4, GAMEPAD_AXIS_RIGHT_X);
-    case CONTROLLER_KEYBOARD1:
-        return (IsKeyDown(KEY_E) ? 1.0f : 0.0f) - (IsKeyDown(KEY_Q) ? 1.0f : 0.0f);
-    case CONTROLLER_KEYBOARD2:
-        return (IsKeyDown(KEY_PERIOD) ? 1.0f : 0.0f) - (IsKeyDown(KEY_COMMA) ? 1.0f : 0.0f);
-    default:
-        return 0.0f;
-    }
+    return (TankControls){.thrust = IsControllerDown(controller, INPUT_THRUST),
+                          .reverse = IsControllerDown(controller, INPUT_REVERSE),
+                          .turn = GetControllerAxis(controller, INPUT_AXIS_TURN),
+                          .gun = GetControllerAxis(controller, INPUT_AXIS_GUN)};
 }
 
-static Vector2 Move(Position pos, Velocity vel)
+static void CheckForInput(int tank)
 {
-    pos = Vector2Add(pos, vel);
-
-    // Wrap the position around the play area.
-    if (pos.x >= (float)screenWidth)
-    {
-        pos.x -= (float)screenWidth;
-    }
-    if (pos.x < 0)
-    {
-        pos.x += (float)screenWidth;
-    }
-    if (pos.y >= (float)screenHeight)
-    {
-        pos.y -= (float)screenHeight;
-    }
-    if (pos.y < 0)
-    {
-        pos.y += (float)screenHeight;
-    }
-
-    return pos;
-}
-
-static void MoveTank(Tank* tank)
-{
-    tank->pos = Move(tank->pos, tank->vel);
-}
-
-static void MoveShot(Shot* shot)
-{
-    shot->pos = Move(shot->pos, shot->vel);
-}
-
-static void CollideTankShot(Tank* tank, Shot* shot)
-{
-    if (CheckCollisionCircles(tank->pos, TANK_COLLISION_RADIUS, shot->pos, SHOT_COLLISION_RADIUS))
-    {
-        tank->alive = false;
-        shot->alive = 0;
-    }
-}
-
-static void CollideTankTank(Tank* tank1, Tank* tank2)
-{
-    if (!tank1->alive || !tank2->alive)
+    if (!match.tanks[tank].alive)
     {
         return;
     }
 
-    if (CheckCollisionCircles(tank1->pos, TANK_COLLISION_RADIUS, tank2->pos, TANK_COLLISION_RADIUS))
+    // Let latency tracking know about a player's new input, if it drives the tank or fires. Only this tank can consume it.
+    const ControllerId controller = tankControllers[tank];
+    const bool fired = IsControllerPressed(controller, INPUT_FIRE);
+    if (!IsBotController(controller) && (fired || GetControllerEventTime(controller) == GetInputSampleTime()))
     {
-        tank1->alive = false;
-        tank2->alive = false;
+        MarkInputEvent(controller, GetInputSampleTime());
     }
-}
 
-static void CollideTankShots(Tank* tank, int start, int end)
-{
-    if (!tank->alive)
+    // Buffer the press with the physics time that it happened at, so that it is applied by the fixed update that it belongs to
+    // rather than by whichever one happens to come next.
+    if (fired && numFireEvents < MAX_FIRE_EVENTS)
     {
-        return;
-    }
-
-    for (int i = start; i != end; i++)
-    {
-        if (shots[i].alive > 0)
-        {
-            CollideTankShot(tank, &shots[i]);
-        }
+        fireEvents[numFireEvents].time = GetPhysicsTimeAt(GetInputSampleTime());
+        fireEvents[numFireEvents].sampled = GetInputSampleTime();
+        fireEvents[numFireEvents].tank = tank;
+        ++numFireEvents;
     }
 }
 
-static void UpdateTank(Tank* tank)
+// Turn the fire events from before the end of this fixed update into shots, and keep the rest for later. The fraction says how
+// far through the update the fire button was pressed, so the shot starts from where the tank was at that moment and has travelled
+// for the rest of the update.
+static int TakeFireEvents(ShotRequest* requests)
 {
-    if (!tank->alive)
+    const double start = GetPhysicsTime();
+    const double interval = GetUpdateInterval();
+    int numRequests = 0;
+    int remaining = 0;
+    for (int i = 0; i < numFireEvents; i++)
     {
-        return;
-    }
-
-    // Rotate the tank.
-    float axis = GetControllerTurnRate(tank->controller);
-    tank->heading += axis * MAX_ROTATION_SPEED;
-
-    // Accelerate the tank.
-    if (IsControllerThrustDown(tank->controller))
-    {
-        tank->speed += TANK_ACCEL;
-        tank->speed = fminf(MAX_SPEED, tank->speed);
-    }
-    else if (IsControllerReverseDown(tank->controller))
-    {
-        tank->speed -= TANK_ACCEL;
-        tank->speed = fmaxf(MAX_REVERSE_SPEED, tank->speed);
-    }
-    else
-    {
-        tank->speed *= 0.9f;
-    }
-
-    // The tank's velocity is in its direction of travel.
-    tank->vel.x = cosf((tank->heading - 90) * DEG2RAD) * tank->speed;
-    tank->vel.y = sinf((tank->heading - 90) * DEG2RAD) * tank->speed;
-
-    // Rotate the gun.
-    float gunAxis = GetGunTurnRate(tank->controller);
-    tank->gunHeading += gunAxis * MAX_ROTATION_SPEED;
-
-    // Move the tank.
-    MoveTank(tank);
-}
-
-static void CheckForFire(Tank* tank)
-{
-    if (!tank->alive)
-    {
-        return;
-    }
-
-    // Fire.
-    if (IsControllerFirePressed(tank->controller))
-    {
-        const int baseStart = tank->index * SHOTS_PER_PLAYER;
-        const int baseEnd = baseStart + SHOTS_PER_PLAYER;
-        for (int i = baseStart; i < baseEnd; i++)
+        const FireEvent event = fireEvents[i];
+        if (event.time < start + interval)
         {
-            if (shots[i].alive == 0)
+            if (match.tanks[event.tank].alive && !IsBotController(tankControllers[event.tank]))
             {
-                Shot* shot = &shots[i];
-                shot->alive = SHOT_DURATION;
-                shot->heading = tank->heading + tank->gunHeading;
-                Vector2 angle = {cosf((shot->heading - 90) * DEG2RAD), sinf((shot->heading - 90) * DEG2RAD)};
-                shot->pos = Vector2Add(tank->pos, Vector2Scale(angle, TANK_SCALE));
-                shot->vel = Vector2Add(Vector2Scale(angle, SHOT_SPEED), tank->vel);
-                break;
+                MarkInputConsumed(tankControllers[event.tank], event.sampled, GetTime());
             }
-        }
-    }
-}
 
-static void UpdateShot(Shot* shot)
-{
-    if (shot->alive == 0)
-    {
-        return;
-    }
-    MoveShot(shot);
-    --(shot->alive);
-}
-
-static void DrawCommands(const Command* commands, Vector2 pos, float heading, Color colour)
-{
-    Vector2 points[MAX_LINES];
-
-    Vector2 here = Vector2Add(Vector2Scale(Vector2Rotate((Vector2){0, 0}, heading), TANK_SCALE), pos);
-    int numPoints = 0;
-    for (int i = 0; commands[i].type != END; i++)
-    {
-        const Vector2 coord = Vector2Add(Vector2Scale(Vector2Rotate(commands[i].pos, heading), TANK_SCALE), pos);
-        if (commands[i].type == LINE)
-        {
-            if (numPoints == 0)
-            {
-                points[0] = here;
-                ++numPoints;
-            }
-            points[numPoints] = coord;
-            ++numPoints;
+            // Anything from before this update, e.g., because the frame took too long, is fired at the start of it.
+            const float fraction = (float)fmax(0.0, (event.time - start) / interval);
+            requests[numRequests++] = (ShotRequest){.tank = event.tank, .fraction = fraction};
         }
-        else if (commands[i].type == MOVE)
+        else
         {
-            if (numPoints > 0)
-            {
-                DrawLineStrip(points, numPoints, colour);
-                numPoints = 0;
-            }
+            fireEvents[remaining++] = event;
         }
-        here = coord;
-    }
-    if (numPoints > 0)
-    {
-        DrawLineStrip(points, numPoints, colour);
     }
+    numFireEvents = remaining;
+    return numRequests;
 }
 
-static void DrawTankAt(int tankType, Vector2 pos, float heading, float gunHeading, Color colour)
+// Let the bots decide what to do, all in one go, from what their tanks can see. Their decisions drive their controllers, and
+// their shots are queued for the start of this update.
+static void UpdateBots(void)
 {
-    DrawCommands(tankCommands[tankType], pos, heading, colour);
-    DrawCommands(gunCommands[tankType], pos, heading + gunHeading, colour);
-}
-
-static void DrawTank(const Tank* tank, double alpha)
-{
-    // Interpolate the tank's drawing position with its velocity to reduce stutter.
-    const Vector2 pos = Vector2Add(tank->pos, Vector2Scale(tank->vel, (float)alpha));
-
-    const float heading = tank->heading;
-    const float gunHeading = tank->gunHeading;
-
-    // Which edges of the play area does the tank overlap?
-    const bool overlapsTop = pos.y - TANK_OVERLAP < 0;                       // Going off the top of the screen.
-    const bool overlapsBottom = pos.y + TANK_OVERLAP >= (float)screenHeight; // Going off the bottom of the screen.
-    const bool overlapsLeft = pos.x - TANK_OVERLAP < 0;                      // Going off the left of the screen.
-    const bool overlapsRight = pos.x + TANK_OVERLAP >= (float)screenWidth;   // Going off the right of the screen.
-
-    const Color tankColour = tankColours[tank->index];
-    const int tankType = tank->index;
-
-    DrawTankAt(tankType, pos, heading, gunHeading, tankColour);
-
-    if (overlapsTop)
+    if (bots.count == 0)
     {
-        DrawTankAt(tankType, Vector2Add(pos, (Vector2){0, (float)screenHeight}), heading, gunHeading, tankColour);
-    }
-    if (overlapsBottom)
-    {
-        DrawTankAt(tankType, Vector2Add(pos, (Vector2){0, (float)-screenHeight}), heading, gunHeading, tankColour);
-    }
-    if (overlapsLeft)
-    {
-        DrawTankAt(tankType, Vector2Add(pos, (Vector2){(float)screenWidth, 0}), heading, gunHeading, tankColour);
-        if (overlapsTop)
-        {
-            DrawTankAt(tankType, Vector2Add(pos, (Vector2){(float)screenWidth, (float)screenHeight}), heading, gunHeading,
-                       tankColour);
-        }
-        else if (overlapsBottom)
-        {
-            DrawTankAt(tankType, Vector2Add(pos, (Vector2){(float)screenWidth, (float)-screenHeight}), heading, gunHeading,
-                       tankColour);
-        }
+        return;
     }
-    if (overlapsRight)
+
+    DecideBots(&bots, &match);
+    SetBotControllers(bots.count, bots.thrust, bots.reverse, bots.turn, bots.gun);
+
+    for (int i = 0; i < bots.count; i++)
     {
-        DrawTankAt(tankType, Vector2Add(pos, (Vector2){(float)-screenWidth, 0}), heading, gunHeading, tankColour);
-        if (overlapsTop)
-        {
-            DrawTankAt(tankType, Vector2Add(pos, (Vector2){(float)-screenWidth, (float)screenHeight}), heading, gunHeading,
-                       tankColour);
-        }
-        else if (overlapsBottom)
+        if (bots.fire[i] && numFireEvents < MAX_FIRE_EVENTS)
         {
-            DrawTankAt(tankType, Vector2Add(pos, (Vector2){(float)-screenWidth, (float)-screenHeight}), heading, gunHeading,
-                       tankColour);
+            fireEvents[numFireEvents].time = GetPhysicsTime();
+            fireEvents[numFireEvents].sampled = 0.0;
+            fireEvents[numFireEvents].tank = bots.tank[i];
+            ++numFireEvents;
         }
     }
 }
 
-static void DrawShotAt(Vector2 pos, float heading, Color colour)
+// Start the kill cam a little before the last kill, if the replay still goes back that far.
+static bool StartKillCam(void)
 {
-    Vector2 points[2];
-    for (int i = 0; i < 2; i++)
+    int first;
+    int last;
+    if (lastKill < 0 || !GetReplayTicks(&replay, &first, &last) || lastKill < first)
     {
-        points[i] = Vector2Add(Vector2Scale(Vector2Rotate(shotLines[i], heading), TANK_SCALE), pos);
+        return false;
     }
-    DrawLineStrip(points, 2, colour);
-}
-
-static void DrawShot(const Shot* shot, Color colour, double alpha)
-{
-    // Interpolate the shot's drawing position with its velocity to reduce stutter.
-    const Vector2 pos = Vector2Add(shot->pos, Vector2Scale(shot->vel, (float)alpha));
-
-    DrawShotAt(pos, shot->heading, colour);
+    replayTick = lastKill - KILL_CAM_BEFORE > first ? lastKill - KILL_CAM_BEFORE : first;
+    replayEnd = lastKill + KILL_CAM_AFTER < last ? lastKill + KILL_CAM_AFTER : last;
+    return ReadReplay(&replay, (int)replayTick, &replayed);
 }
 
-static void CheckKeyboard(KeyboardKey selectKey, KeyboardKey cancelKey)
+// Rewind or fast forward through the replay, without going past either end of it.
+static void Rewind(int direction)
 {
-    pauseOrQuitRequested = pauseOrQuitRequested || IsKeyReleased(selectKey);
-    resumeRequested = resumeRequested || IsKeyReleased(cancelKey);
-}
-
-static void CheckGamepad(GamepadNumber gamepad, GamepadButton selectButton, GamepadButton cancelButton)
-{
-    if (!IsGamepadAvailable(gamepad))
+    int first;
+    int last;
+    if (direction != 0 && GetReplayTicks(&replay, &first, &last))
     {
-        return;
+        replayTick = Clamp((float)(replayTick + direction * REWIND_SPEED), (float)first, (float)last);
+        showReplayed = (int)replayTick != last && ReadReplay(&replay, (int)replayTick, &replayed);
     }
-
-    pauseOrQuitRequested = pauseOrQuitRequested || IsGamepadButtonReleased(gamepad, selectButton);
-    resumeRequested = resumeRequested || IsGamepadButtonReleased(gamepad, cancelButton);
 }
 
-void InitPlayingScreen(int players, const ControllerId* controllers)
+void InitPlayingScreen(int count, const ControllerId* controllers)
 {
     screenWidth = GetScreenWidth();
     screenHeight = GetScreenHeight();
@@ -558,38 +202,36 @@ void InitPlayingScreen(int players, const ControllerId* controllers)
     pauseOrQuitRequested = false;
     resumeRequested = false;
 
-    tankColours[0] = GREEN;
-    tankColours[1] = YELLOW;
-    tankColours[2] = PINK;
-    tankColours[3] = SKYBLUE;
-
-    for (int i = 0; i < MAX_PLAYERS; i++)
+    // The players come first, then the bots.
+    int players = 0;
+    while (players < count && !IsBotController(controllers[players]))
     {
-        tanks[i].alive = false;
-        tanks[i].index = i;
+        ++players;
     }
+    const MatchRules rules = GetDefaultMatchRules();
+    InitMatch(&match, &rules, count, players, (float)screenWidth, (float)screenHeight, 0);
+    InitMatch(&replayed, &rules, count, players, (float)screenWidth, (float)screenHeight, 0);
+    InitBots(&bots, match.count - players, players, 1);
+    InitReplay(&replay);
+    LogMatchStarted(&match, players);
+    showReplayed = false;
+    lastKill = -1;
+    killCamRequested = false;
+    rewinding = 0;
 
-    numPlayers = players;
-    for (int i = 0; i < players; i++)
+    for (int i = 0; i < match.count; i++)
     {
-        float angle = (float)i * (2 * 3.141592654f) / (float)numPlayers;
-        tanks[i].controller = controllers[i];
-        tanks[i].alive = true;
-        tanks[i].pos.x = (float)screenWidth / 2.0f + cosf(angle) * (float)screenHeight / 3;
-        tanks[i].pos.y = (float)screenHeight / 2.0f + sinf(angle) * (float)screenHeight / 3;
-        tanks[i].heading = 180.0f + RAD2DEG * atan2f((float)screenHeight / 2.0f - tanks[i].pos.y, (float)screenWidth / 2.0f - tanks[i].pos.x);
-        tanks[i].gunHeading = 0.0f;
-        tanks[i].vel = (Vector2){0, 0};
-    }
-
-    for (int i = 0; i < MAX_SHOTS; i++)
-    {
-        shots[i].alive = false;
+        tankControllers[i] = controllers[i];
+        lastInputTimes[i] = GetControllerEventTime(controllers[i]);
     }
+    numFireEvents = 0;
+    CancelInputEvent();
 }
 
 void FinishPlayingScreen(void)
 {
+    LogMatchEnded(&match);
+    CancelInputEvent();
 }
 
 void UpdatePlayingScreen(void)
@@ -601,6 +243,17 @@ void UpdatePlayingScreen(void)
         {
             pauseOrQuitRequested = false;
             state = PAUSED;
+            numFireEvents = 0;
+            CancelInputEvent();
+            replayTick = match.ticks;
+            LogPause(&match, true);
+        }
+        else if (killCamRequested && StartKillCam())
+        {
+            state = REPLAYING;
+            showReplayed = true;
+            numFireEvents = 0;
+            CancelInputEvent();
         }
     }
     else if (state == PAUSED)
@@ -612,43 +265,51 @@ void UpdatePlayingScreen(void)
         }
         else if (resumeRequested)
         {
+            // Rewinding only looks back, so the match carries on from where it was paused.
             resumeRequested = false;
             state = PLAYING;
+            showReplayed = false;
+            LogPause(&match, false);
+        }
+        else
+        {
+            Rewind(rewinding);
         }
     }
-
-    // Only update the game state when playing.
-    if (state == PLAYING)
+    else if (state == REPLAYING)
     {
-        for (int i = 0; i < numPlayers; i++)
+        // Pausing skips the rest of the kill cam.
+        replayTick += KILL_CAM_SPEED;
+        if (pauseOrQuitRequested || replayTick > replayEnd || !ReadReplay(&replay, (int)replayTick, &replayed))
         {
-            UpdateTank(&tanks[i]);
+            pauseOrQuitRequested = false;
+            state = PLAYING;
+            showReplayed = false;
         }
+    }
+    killCamRequested = false;
 
-        for (int i = 0; i < MAX_SHOTS; i++)
-        {
-            UpdateShot(&shots[i]);
-        }
+    // Only update the game state when playing.
+    if (state == PLAYING)
+    {
+        UpdateBots();
 
-        // Collide each player with the other players' shots.
-        for (int i = 0; i < numPlayers; i++)
+        TankControls controls[MAX_TANKS];
+        for (int i = 0; i < match.count; i++)
         {
-            for (int j = 0; j < numPlayers; j++)
-            {
-                if (j != i)
-                {
-                    CollideTankShots(&tanks[i], j * SHOTS_PER_PLAYER, j * SHOTS_PER_PLAYER + SHOTS_PER_PLAYER);
-                }
-            }
+            controls[i] = ReadControls(i);
         }
-
-        // Collide each player with the other players.
-        for (int i = 0; i < numPlayers - 1; i++)
+        ShotRequest requests[MAX_FIRE_EVENTS];
+        const int numRequests = TakeFireEvents(requests);
+        const int living = CountLivingTanks(&match);
+        UpdateMatch(&match, controls, requests, numRequests);
+        RecordReplay(&replay, &match);
+        LogMatchEvents(&match);
+        if (CountLivingTanks(&match) < living)
         {
-            for (int j = i + 1; j < numPlayers; j++)
-            {
-                CollideTankTank(&tanks[i], &tanks[j]);
-            }
+            // If it was a player's tank then it will never act on the input that we're waiting for, so stop waiting.
+            lastKill = match.ticks;
+            CancelInputEvent();
         }
     }
 }
@@ -656,40 +317,42 @@ void UpdatePlayingScreen(void)
 void DrawPlayingScreen(double alpha)
 {
     BeginDrawing();
+    BeginScaledDrawing();
 
     ClearBackground(BLACK);
-    DrawText("PLAYING", 4, 4, 20, RAYWHITE);
+    DrawText(state == REPLAYING ? "KILL CAM" : showReplayed ? "REWOUND" : "PLAYING", 4, 4, 20, RAYWHITE);
     if (state == PAUSED)
     {
         int width = MeasureText(pausedText, 20);
         DrawText(pausedText, (screenWidth - width) / 2, 7 * screenHeight / 8, 20, RAYWHITE);
     }
+    else if (state == PLAYING && lastKill >= 0)
+    {
+        DrawText(killCamText, screenWidth - MeasureText(killCamText, 20) - 4, 4, 20, RAYWHITE);
+    }
 
     if (state == PAUSED)
     {
         alpha = 0.0;
     }
-
-    // Draw the tanks.
-    for (int i = 0; i < numPlayers; i++)
+    else if (state == REPLAYING)
     {
-        if (tanks[i].alive)
-        {
-            DrawTank(&tanks[i], alpha);
-        }
+        // The kill cam is in slow motion, so it's part way between ticks, and it moves on more slowly between fixed updates.
+        alpha = replayTick - (int)replayTick + alpha * KILL_CAM_SPEED;
     }
 
-    // Draw the shots.
-    for (int i = 0; i < numPlayers * SHOTS_PER_PLAYER; i++)
+    // Draw the tanks and shots, and what the tanks can see. The arena is the screen, so it's drawn from its top left corner. The
+    // replay only has what the tanks looked like, not what they could see.
+    const Vector2 origin = {0, 0};
+    DrawMatch(showReplayed ? &replayed : &match, origin, alpha);
+    if (showLidar && !showReplayed)
     {
-        const Shot* shot = &shots[i];
-        if (shot->alive > 0)
-        {
-            Color colour = tankColours[i / SHOTS_PER_PLAYER];
-            DrawShot(shot, colour, alpha);
-        }
+        DrawMatchLidar(&match, origin, alpha);
     }
 
+    // Diagnostics are drawn at full resolution.
+    EndScaledDrawing();
+    DrawLatencyHistograms(4, 32);
     DrawFPS(screenWidth / 2 - 16, screenHeight - 24);
 
     EndDrawing();
@@ -698,17 +361,24 @@ void DrawPlayingScreen(double alpha)
 void CheckTriggersPlayingScreen(void)
 {
     // Check for player(s) choosing to pause / resume / quit.
-    CheckKeyboard(KEY_ESCAPE, KEY_R);
-    CheckGamepad(GAMEPAD_PLAYER1, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
-    CheckGamepad(GAMEPAD_PLAYER2, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
-    CheckGamepad(GAMEPAD_PLAYER3, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
-    CheckGamepad(GAMEPAD_PLAYER4, GAMEPAD_BUTTON_MIDDLE_RIGHT, GAMEPAD_BUTTON_MIDDLE_LEFT);
+    pauseOrQuitRequested = pauseOrQuitRequested || IsAnyControllerReleased(INPUT_PAUSE);
+    resumeRequested = resumeRequested || IsAnyControllerReleased(INPUT_RESUME);
+
+    // Toggle the lidar overlay.
+    if (IsKeyPressed(KEY_F7))
+    {
+        showLidar = !showLidar;
+    }
+
+    // Watch the last kill again, or rewind through the last few seconds while paused.
+    killCamRequested = killCamRequested || IsAnyControllerPressed(INPUT_KILL_CAM);
+    rewinding = IsAnyControllerDown(INPUT_FAST_FORWARD) - IsAnyControllerDown(INPUT_REWIND);
 
     if (state == PLAYING)
     {
-        for (int i = 0; i < numPlayers; i++)
+        for (int i = 0; i < match.count; i++)
         {
-            CheckForFire(&tanks[i]);
+            CheckForInput(i);
         }
     }
 }
@@ -717,3 +387,8 @@ bool IsCancelledPlayingScreen(void)
 {
     return state == CANCELLED;
 }
+
+const float* GetLidarDistances(int tank)
+{
+    return match.tanks[tank].lidar;
+}
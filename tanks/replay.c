@@ -0,0 +1,142 @@
+#include "replay.h"
+#include "match.h"
+#include "net.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+// Which frame is the nth oldest?
+static ReplayFrame* GetFrame(Replay* replay, int n)
+{
+    return &replay->frames[(replay->first + n) % REPLAY_MAX_FRAMES];
+}
+
+// Drop the oldest keyframe, and the deltas that depend on it.
+static void DropOldest(Replay* replay)
+{
+    do
+    {
+        replay->first = (replay->first + 1) % REPLAY_MAX_FRAMES;
+        --replay->count;
+    } while (replay->count > 0 && !GetFrame(replay, 0)->keyframe);
+}
+
+// Find where size bytes can go after the newest frame's, going back to the start of the ring if they won't fit before the end.
+// Returns -1 if they'd overwrite the oldest frame's bytes.
+static int FindRoom(Replay* replay, int size)
+{
+    if (replay->count == 0)
+    {
+        return 0;
+    }
+    const int tail = GetFrame(replay, 0)->offset;
+    const int head = replay->head;
+    if (tail < head)
+    {
+        // The frames don't wrap, so there's room after them, or before them.
+        if (head + size <= REPLAY_BUDGET)
+        {
+            return head;
+        }
+        return size <= tail ? 0 : -1;
+    }
+
+    // The frames wrap, so the only room is between the newest and the oldest.
+    return head + size <= tail ? head : -1;
+}
+
+void InitReplay(Replay* replay)
+{
+    replay->first = 0;
+    replay->count = 0;
+    replay->head = 0;
+    replay->latest.tick = NET_NO_BASELINE;
+    replay->decoded.tick = NET_NO_BASELINE;
+}
+
+void RecordReplay(Replay* replay, const Match* match)
+{
+    unsigned char packet[NET_MAX_PACKET];
+
+    // A tick is a keyframe if it's time for one, or if the tick before it is missing.
+    NetSnapshot snapshot;
+    TakeNetSnapshot(match, match->ticks, &snapshot);
+    const ReplayFrame* newest = replay->count > 0 ? GetFrame(replay, replay->count - 1) : NULL;
+    const bool keyframe = newest == NULL || newest->tick != snapshot.tick - 1 || snapshot.tick % REPLAY_KEYFRAME_INTERVAL == 0;
+    const int size = WriteNetSnapshot(packet, sizeof(packet), &snapshot, keyframe ? NULL : &replay->latest);
+
+    int at = FindRoom(replay, size);
+    while (replay->count == REPLAY_MAX_FRAMES || at < 0)
+    {
+        DropOldest(replay);
+        at = FindRoom(replay, size);
+    }
+
+    memcpy(&replay->bytes[at], packet, (size_t)size);
+    *GetFrame(replay, replay->count) = (ReplayFrame){.tick = snapshot.tick, .keyframe = keyframe, .offset = at, .size = size};
+    ++replay->count;
+    replay->head = at + size;
+    replay->latest = snapshot;
+}
+
+bool GetReplayTicks(const Replay* replay, int* first, int* last)
+{
+    if (replay->count == 0)
+    {
+        return false;
+    }
+    *first = replay->frames[replay->first].tick;
+    *last = replay->latest.tick;
+    return true;
+}
+
+int GetReplaySize(const Replay* replay)
+{
+    int size = 0;
+    for (int i = 0; i < replay->count; i++)
+    {
+        size += replay->frames[(replay->first + i) % REPLAY_MAX_FRAMES].size;
+    }
+    return size;
+}
+
+bool ReadReplay(Replay* replay, int tick, Match* match)
+{
+    // Find the tick, then the keyframe that it depends on.
+    int n = replay->count - 1;
+    while (n >= 0 && GetFrame(replay, n)->tick != tick)
+    {
+        --n;
+    }
+    if (n < 0)
+    {
+        return false;
+    }
+    int from = n;
+    while (from > 0 && !GetFrame(replay, from)->keyframe)
+    {
+        --from;
+    }
+
+    // Carry on from the tick that was read last if it's on the way, rather than going back to the keyframe.
+    const int keyframeTick = GetFrame(replay, from)->tick;
+    if (replay->decoded.tick >= keyframeTick && replay->decoded.tick <= tick)
+    {
+        from += replay->decoded.tick - keyframeTick + 1;
+    }
+    for (int i = from; i <= n; i++)
+    {
+        NetSnapshot next;
+        const ReplayFrame* frame = GetFrame(replay, i);
+        const NetSnapshot* baseline = frame->keyframe ? NULL : &replay->decoded;
+        if (!ReadNetSnapshot(&replay->bytes[frame->offset], frame->size, baseline, &next))
+        {
+            replay->decoded.tick = NET_NO_BASELINE;
+            return false;
+        }
+        replay->decoded = next;
+    }
+
+    ApplyNetSnapshot(&replay->decoded, match);
+    return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "match.h"
+#include "net.h"
+
+#include <stdbool.h>
+
+#define REPLAY_MAX_FRAMES 500       // The most ticks that a replay keeps, i.e., 10 seconds at 50 updates a second.
+#define REPLAY_BUDGET (256 * 1024)  // How many bytes of compressed ticks a replay can keep. It must hold a keyframe's worth.
+#define REPLAY_KEYFRAME_INTERVAL 25 // How many ticks there are from one keyframe to the next.
+
+// A compressed tick.
+typedef struct
+{
+    int tick;      // Which tick is it?
+    bool keyframe; // Is it written in full, rather than as a delta from the tick before?
+    int offset;    // Where do its bytes start?
+    int size;      // How many bytes are there?
+} ReplayFrame;
+
+// The last few seconds of a match, as a ring of ticks compressed like the network's snapshots. Every REPLAY_KEYFRAME_INTERVAL'th
+// tick is a keyframe, which is written in full, and the ticks in between are deltas from the tick before, so getting any tick
+// back takes one keyframe and the deltas after it. When the ring runs out of frames or bytes, it drops the oldest keyframe and
+// its deltas.
+typedef struct
+{
+    ReplayFrame frames[REPLAY_MAX_FRAMES]; // The frames, as a ring.
+    int first;                             // Which frame is the oldest?
+    int count;                             // How many frames are there?
+    int head;                              // Where do the next frame's bytes go?
+    NetSnapshot latest;                    // The latest tick, which the next one is a delta from.
+    NetSnapshot decoded;                   // The tick that was read last, so that reading the one after it only takes a delta.
+    unsigned char bytes[REPLAY_BUDGET];    // The frames' bytes, as a ring.
+} Replay;
+
+// clang-format off
+
+void InitReplay(Replay* replay);                                  // Empty a replay.
+void RecordReplay(Replay* replay, const Match* match);            // Add the match's latest tick, making room if it has to.
+bool GetReplayTicks(const Replay* replay, int* first, int* last); // Get the oldest and latest ticks, if there are any.
+int GetReplaySize(const Replay* replay);                          // Get how many bytes the replay's frames take.
+bool ReadReplay(Replay* replay, int tick, Match* match);          // Make a match look like it did at a tick, if the replay has it.
+
+// clang-format on
@@ -0,0 +1,674 @@
+// Runs tank matches for clients on this machine, without a window.
+//
+// Usage: tanks_server [port] [matches] [tanks per match] [seconds] [threads]
+//
+// The server is authoritative. It runs the same fixed update as the playing screen, at UPDATE_FPS, for every match that has
+// clients. Clients send their controls over UDP, and after each tick the server sends each client a snapshot of its match,
+// delta-encoded against the last snapshot that the client said it received.
+//
+// Each match keeps its own time, starting from when its first client joins, so the matches' ticks are spread across the frame
+// rather than all falling due at once. Whenever any are due, the main thread hands them to the worker pool, earliest first, and
+// whichever thread is free takes the next one. A tick is late if it finishes after the match's next tick was due, and a match that
+// falls more than a tick behind skips ahead rather than trying to catch up.
+//
+// A client's tank sits out the rest of a round if it joins part way through, and a new round starts when there's at most one tank
+// left. The arena grows with the number of tanks in a match, so that they're no more crowded than MAX_PLAYERS tanks on the screen.
+//
+// Spectators can watch a match without driving a tank. Each tells the server which part of the arena it can see, and its snapshots
+// only have what's in or near that part. They're delta-encoded against what the spectator was sent, rather than against the
+// match's own snapshots, so each spectator has its own history.
+// It runs on the given number of threads, or one per processor, until it has been up for the given number of seconds, or
+// forever if that's 0. Once a second it reports how long the ticks are taking and how many were late, and from that, roughly how
+// many matches like these it would have room for.
+
+#define BDR_BENCH_IMPLEMENTATION
+#define BDR_THREADS_IMPLEMENTATION
+#define BDR_UDP_IMPLEMENTATION
+#include "bdr/bench.h"
+#include "bdr/threads.h"
+#include "bdr/udp.h"
+#include "match.h"
+#include "net.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_WIDTH 1280.0f
+#define ARENA_HEIGHT 720.0f
+#define UPDATE_FPS 50
+#define TICK_INTERVAL (1.0 / UPDATE_FPS)
+#define MAX_CLIENTS 1024
+#define MAX_SPECTATORS 64
+#define VIEW_MARGIN (4 * TANK_SCALE) // How far outside its view a spectator is sent things, so that they don't pop in at the edges.
+#define CLIENT_TIMEOUT 2.0 // How long, in seconds, before a client that we haven't heard from is dropped.
+#define REPORT_INTERVAL 1.0
+#define DEFAULT_MATCHES 1
+#define DEFAULT_TANKS MAX_PLAYERS
+
+typedef struct
+{
+    bool connected;        // Is this client connected?
+    UdpAddress address;    // Where are its packets from?
+    int match;             // Which match is it in?
+    int tank;              // Which tank does it drive?
+    int sequence;          // What was the sequence number of its latest input?
+    int ack;               // What's the latest snapshot that it has received?
+    double lastHeard;      // When did we last hear from it?
+    TankControls controls; // What does it want its tank to do?
+    bool fire;             // Does it want to fire?
+} Client;
+
+typedef struct
+{
+    bool connected;     // Is this spectator connected?
+    UdpAddress address; // Where are its packets from?
+    int match;          // Which match is it watching?
+    int ack;            // What's the latest snapshot that it has received?
+    double lastHeard;   // When did we last hear from it?
+    Rectangle view;     // Which part of the arena can it see?
+    NetHistory history; // What it was sent, which is only what it could see.
+} Spectator;
+
+// What happened since the last report.
+typedef struct
+{
+    int ticks;          // How many ticks were there?
+    double busy;        // How long did they take?
+    double slowest;     // How long did the slowest one take?
+    int overruns;       // How many finished after the next tick was due?
+    double latest;      // How long after it was due did the latest tick finish?
+    int skipped;        // How many ticks were skipped because a match fell behind?
+    int packetsIn;      // How many packets arrived?
+    int packetsOut;     // How many packets were sent?
+    long long bytesOut; // How many bytes were sent?
+    int fullSnapshots;  // How many snapshots were sent in full?
+    int deltas;         // How many snapshots were sent as deltas?
+    int snapshotBytes;  // How many bytes of snapshots were sent?
+    int spectatorViews; // How many snapshots were sent to spectators?
+    int spectatorBytes; // How many bytes of snapshots were sent to spectators?
+} Stats;
+
+// A match, and what the server needs to run it. Only the thread that's ticking a match touches it, or its clients, so each match
+// keeps its own stats.
+typedef struct
+{
+    Match match;            // The match.
+    int clients[MAX_TANKS]; // Which client drives each tank, or -1.
+    int numClients;         // How many clients are there?
+    NetHistory history;     // The match's recent snapshots.
+    int tick;               // The number of the match's next tick. Snapshots are numbered by it, so it never goes back.
+    double nextTick;        // When is the next tick due?
+    Stats stats;            // What happened in this match since the last report.
+} HostedMatch;
+
+static UdpSocket udp;
+static MatchRules rules;
+static HostedMatch* hosted;
+static int numMatches;
+static int tanksPerMatch;
+static float arenaWidth;
+static float arenaHeight;
+static int* due; // The matches whose ticks are due, earliest first.
+static Client clients[MAX_CLIENTS];
+static Spectator spectators[MAX_SPECTATORS];
+static Stats stats; // What happened on the main thread since the last report.
+
+static unsigned char packet[NET_MAX_PACKET];
+
+static void Send(Stats* counts, UdpAddress to, const unsigned char* data, int size)
+{
+    if (size > 0 && SendUdp(udp, to, data, size))
+    {
+        ++counts->packetsOut;
+        counts->bytesOut += size;
+    }
+}
+
+// Start a new round, with a tank for each client.
+static void StartRound(HostedMatch* game)
+{
+    InitMatch(&game->match, &rules, tanksPerMatch, tanksPerMatch, arenaWidth, arenaHeight, 0);
+    for (int i = 0; i < tanksPerMatch; i++)
+    {
+        game->match.tanks[i].alive = game->clients[i] >= 0;
+    }
+}
+
+static int FindClient(UdpAddress address)
+{
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (clients[i].connected && IsSameUdpAddress(clients[i].address, address))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Find a match with a free tank, filling the matches in order.
+static int FindMatch(int wanted)
+{
+    const int first = wanted == NET_ANY_MATCH ? 0 : wanted;
+    const int last = wanted == NET_ANY_MATCH ? numMatches - 1 : wanted;
+    for (int i = first; i <= last && i >= 0 && i < numMatches; i++)
+    {
+        if (hosted[i].numClients < tanksPerMatch)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void Join(UdpAddress address, int wanted, double now)
+{
+    // The client may not have heard our welcome, so say it again.
+    int client = FindClient(address);
+    if (client < 0)
+    {
+        for (int i = 0; i < MAX_CLIENTS && client < 0; i++)
+        {
+            client = clients[i].connected ? -1 : i;
+        }
+        const int match = FindMatch(wanted);
+        if (client < 0 || match < 0)
+        {
+            Send(&stats, address, packet, WriteNetFull(packet, sizeof(packet)));
+            return;
+        }
+
+        // A match that nobody was in starts its clock again, so its first tick is due now.
+        HostedMatch* joined = &hosted[match];
+        if (joined->numClients == 0)
+        {
+            joined->nextTick = now;
+        }
+        int tank = 0;
+        while (joined->clients[tank] >= 0)
+        {
+            ++tank;
+        }
+        joined->clients[tank] = client;
+        ++joined->numClients;
+        clients[client] = (Client){.connected = true,
+                                   .address = address,
+                                   .match = match,
+                                   .tank = tank,
+                                   .sequence = -1,
+                                   .ack = NET_NO_BASELINE,
+                                   .lastHeard = now};
+        printf("Client %d joined match %d as tank %d\n", client, match, tank);
+    }
+
+    const NetWelcome welcome = {
+            .match = clients[client].match, .tank = clients[client].tank, .width = arenaWidth, .height = arenaHeight};
+    Send(&stats, address, packet, WriteNetWelcome(packet, sizeof(packet), &welcome));
+}
+
+static void Leave(int client, const char* why)
+{
+    Client* leaving = &clients[client];
+    HostedMatch* left = &hosted[leaving->match];
+    left->clients[leaving->tank] = -1;
+    left->match.tanks[leaving->tank].alive = false;
+    --left->numClients;
+    leaving->connected = false;
+    printf("Client %d %s match %d\n", client, why, leaving->match);
+}
+
+static int FindSpectator(UdpAddress address)
+{
+    for (int i = 0; i < MAX_SPECTATORS; i++)
+    {
+        if (spectators[i].connected && IsSameUdpAddress(spectators[i].address, address))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Views come from the network, so only take ones that start in the arena and aren't inside out.
+static bool IsValidView(Rectangle view)
+{
+    return view.x >= 0.0f && view.x < arenaWidth && view.y >= 0.0f && view.y < arenaHeight && view.width >= 0.0f &&
+           view.height >= 0.0f;
+}
+
+// Start or carry on watching a match, or switch to another one. A spectator that hasn't had a snapshot yet may not have heard our
+// welcome, so say it again.
+static void Watch(UdpAddress address, const NetWatch* watch, double now)
+{
+    const bool valid = watch->match >= 0 && watch->match < numMatches;
+    int spectator = FindSpectator(address);
+    if (spectator < 0)
+    {
+        for (int i = 0; i < MAX_SPECTATORS && spectator < 0; i++)
+        {
+            spectator = spectators[i].connected ? -1 : i;
+        }
+        if (spectator < 0 || !valid)
+        {
+            Send(&stats, address, packet, WriteNetFull(packet, sizeof(packet)));
+            return;
+        }
+        spectators[spectator] = (Spectator){.connected = true,
+                                            .address = address,
+                                            .match = watch->match,
+                                            .ack = NET_NO_BASELINE,
+                                            .view = {0.0f, 0.0f, arenaWidth, arenaHeight}};
+        InitNetHistory(&spectators[spectator].history);
+        printf("Spectator %d is watching match %d\n", spectator, watch->match);
+    }
+    else if (!valid)
+    {
+        // Tell the spectator that there's no such match. It carries on watching the one that it was watching.
+        Send(&stats, address, packet, WriteNetFull(packet, sizeof(packet)));
+        return;
+    }
+
+    Spectator* watching = &spectators[spectator];
+    watching->lastHeard = now;
+    if (IsValidView(watch->view))
+    {
+        watching->view = watch->view;
+    }
+    if (watch->match != watching->match)
+    {
+        // Nothing that the spectator has seen of the old match is a baseline for the new one, so start it again from a full
+        // snapshot, and welcome it to the new match so that it knows that it has switched.
+        printf("Spectator %d switched from match %d to match %d\n", spectator, watching->match, watch->match);
+        watching->match = watch->match;
+        watching->ack = NET_NO_BASELINE;
+        InitNetHistory(&watching->history);
+    }
+    else if (watch->ack > watching->ack && FindNetSnapshot(&watching->history, watch->ack) != NULL)
+    {
+        // Only take acks for snapshots that we sent it, as acks for the old match can still be on their way after a switch.
+        watching->ack = watch->ack;
+    }
+    if (watching->ack == NET_NO_BASELINE)
+    {
+        const NetWelcome welcome = {.match = watching->match, .tank = NET_NO_TANK, .width = arenaWidth, .height = arenaHeight};
+        Send(&stats, address, packet, WriteNetWelcome(packet, sizeof(packet), &welcome));
+    }
+}
+
+static void StopWatching(int spectator, const char* why)
+{
+    spectators[spectator].connected = false;
+    printf("Spectator %d %s match %d\n", spectator, why, spectators[spectator].match);
+}
+
+static void TakeInput(int client, const NetInput* input, double now)
+{
+    Client* from = &clients[client];
+    from->lastHeard = now;
+
+    // Inputs can arrive out of order, so only act on the latest.
+    if (input->sequence > from->sequence)
+    {
+        from->sequence = input->sequence;
+        from->controls = input->controls;
+        from->fire = from->fire || input->fire;
+    }
+    if (input->ack > from->ack && input->ack < hosted[from->match].tick)
+    {
+        from->ack = input->ack;
+    }
+}
+
+static void ReceivePackets(double now)
+{
+    static unsigned char received[NET_MAX_PACKET];
+    UdpAddress from;
+    int size;
+    while ((size = ReceiveUdp(udp, &from, received, sizeof(received))) > 0)
+    {
+        ++stats.packetsIn;
+        const NetMessageType type = GetNetMessageType(received, size);
+        const int client = type == NET_HELLO || type == NET_WATCH ? -1 : FindClient(from);
+        if (type == NET_HELLO)
+        {
+            int wanted;
+            if (ReadNetHello(received, size, &wanted))
+            {
+                Join(from, wanted, now);
+            }
+        }
+        else if (type == NET_INPUT && client >= 0)
+        {
+            NetInput input;
+            if (ReadNetInput(received, size, &input))
+            {
+                TakeInput(client, &input, now);
+            }
+        }
+        else if (type == NET_WATCH)
+        {
+            NetWatch watch;
+            if (ReadNetWatch(received, size, &watch))
+            {
+                Watch(from, &watch, now);
+            }
+        }
+        else if (type == NET_BYE && client >= 0)
+        {
+            Leave(client, "left");
+        }
+        else if (type == NET_BYE && FindSpectator(from) >= 0)
+        {
+            StopWatching(FindSpectator(from), "stopped watching");
+        }
+    }
+}
+
+static void DropSilentClients(double now)
+{
+    for (int i = 0; i < MAX_CLIENTS; i++)
+    {
+        if (clients[i].connected && now - clients[i].lastHeard > CLIENT_TIMEOUT)
+        {
+            Leave(i, "timed out of");
+        }
+    }
+    for (int i = 0; i < MAX_SPECTATORS; i++)
+    {
+        if (spectators[i].connected && now - spectators[i].lastHeard > CLIENT_TIMEOUT)
+        {
+            StopWatching(i, "timed out of");
+        }
+    }
+}
+
+// Run one tick of a match, then send each of its clients a snapshot, and each of its spectators what it can see of it.
+static void TickMatch(int index)
+{
+    unsigned char out[NET_MAX_PACKET];
+    HostedMatch* game = &hosted[index];
+
+    TankControls controls[MAX_TANKS];
+    ShotRequest requests[MAX_TANKS];
+    int numRequests = 0;
+    for (int i = 0; i < tanksPerMatch; i++)
+    {
+        Client* client = game->clients[i] >= 0 ? &clients[game->clients[i]] : NULL;
+        controls[i] = client != NULL ? client->controls : (TankControls){.thrust = false};
+        if (client != NULL && client->fire)
+        {
+            requests[numRequests++] = (ShotRequest){.tank = i, .fraction = 0.0f};
+            client->fire = false;
+        }
+    }
+    UpdateMatch(&game->match, controls, requests, numRequests);
+
+    // A round is over when there's at most one tank left, unless there's only one client, who gets to drive around on their own.
+    const int living = CountLivingTanks(&game->match);
+    if ((game->numClients > 1 && living <= 1) || living == 0)
+    {
+        StartRound(game);
+    }
+
+    NetSnapshot* snapshot = &game->history.snapshots[game->tick % NET_HISTORY];
+    TakeNetSnapshot(&game->match, game->tick, snapshot);
+    ++game->tick;
+    for (int i = 0; i < tanksPerMatch; i++)
+    {
+        if (game->clients[i] >= 0)
+        {
+            const Client* client = &clients[game->clients[i]];
+            const NetSnapshot* baseline = FindNetSnapshot(&game->history, client->ack);
+            const int size = WriteNetSnapshot(out, sizeof(out), snapshot, baseline);
+            game->stats.fullSnapshots += baseline == NULL ? 1 : 0;
+            game->stats.deltas += baseline != NULL ? 1 : 0;
+            game->stats.snapshotBytes += size;
+            Send(&game->stats, client->address, out, size);
+        }
+    }
+
+    for (int i = 0; i < MAX_SPECTATORS; i++)
+    {
+        Spectator* spectator = &spectators[i];
+        if (spectator->connected && spectator->match == index)
+        {
+            NetSnapshot* seen = &spectator->history.snapshots[snapshot->tick % NET_HISTORY];
+            *seen = *snapshot;
+            CullNetSnapshot(seen, spectator->view, VIEW_MARGIN, arenaWidth, arenaHeight);
+            const NetSnapshot* baseline = FindNetSnapshot(&spectator->history, spectator->ack);
+            const int size = WriteNetSnapshot(out, sizeof(out), seen, baseline);
+            ++game->stats.spectatorViews;
+            game->stats.spectatorBytes += size;
+            Send(&game->stats, spectator->address, out, size);
+        }
+    }
+}
+
+// Tick the due matches in [start, end), then work out when each one's next tick is due.
+static void TickDueMatches(void* data, int start, int end)
+{
+    (void)data;
+    for (int i = start; i < end; i++)
+    {
+        HostedMatch* game = &hosted[due[i]];
+        const double started = GetBenchTime();
+        TickMatch(due[i]);
+        const double finished = GetBenchTime();
+
+        Stats* counts = &game->stats;
+        const double tickTime = finished - started;
+        const double lateness = finished - game->nextTick;
+        ++counts->ticks;
+        counts->busy += tickTime;
+        counts->slowest = tickTime > counts->slowest ? tickTime : counts->slowest;
+        counts->overruns += lateness > TICK_INTERVAL ? 1 : 0;
+        counts->latest = lateness > counts->latest ? lateness : counts->latest;
+
+        // If the match has fallen more than a tick behind then don't try to catch up.
+        game->nextTick += TICK_INTERVAL;
+        if (finished - game->nextTick > TICK_INTERVAL)
+        {
+            const int behind = (int)((finished - game->nextTick) / TICK_INTERVAL);
+            counts->skipped += behind;
+            game->nextTick += behind * TICK_INTERVAL;
+        }
+    }
+}
+
+static int CompareDeadlines(const void* a, const void* b)
+{
+    const double first = hosted[*(const int*)a].nextTick;
+    const double second = hosted[*(const int*)b].nextTick;
+    return first < second ? -1 : first > second ? 1 : 0;
+}
+
+// Find the matches whose ticks are due, earliest first, and return how many there are. If there are none, then set when the
+// earliest one will be.
+static int FindDueMatches(double now, double* earliest)
+{
+    int count = 0;
+    *earliest = now + REPORT_INTERVAL;
+    for (int i = 0; i < numMatches; i++)
+    {
+        if (hosted[i].numClients > 0)
+        {
+            if (hosted[i].nextTick <= now)
+            {
+                due[count++] = i;
+            }
+            else if (hosted[i].nextTick < *earliest)
+            {
+                *earliest = hosted[i].nextTick;
+            }
+        }
+    }
+    qsort(due, (size_t)count, sizeof(due[0]), CompareDeadlines);
+    return count;
+}
+
+static void Report(double interval, int threads)
+{
+    // Gather up the matches' stats along with the main thread's.
+    Stats total = stats;
+    int activeMatches = 0;
+    int connected = 0;
+    for (int i = 0; i < numMatches; i++)
+    {
+        const Stats* counts = &hosted[i].stats;
+        total.ticks += counts->ticks;
+        total.busy += counts->busy;
+        total.slowest = counts->slowest > total.slowest ? counts->slowest : total.slowest;
+        total.overruns += counts->overruns;
+        total.latest = counts->latest > total.latest ? counts->latest : total.latest;
+        total.skipped += counts->skipped;
+        total.packetsOut += counts->packetsOut;
+        total.bytesOut += counts->bytesOut;
+        total.fullSnapshots += counts->fullSnapshots;
+        total.deltas += counts->deltas;
+        total.snapshotBytes += counts->snapshotBytes;
+        total.spectatorViews += counts->spectatorViews;
+        total.spectatorBytes += counts->spectatorBytes;
+        hosted[i].stats = (Stats){.ticks = 0};
+        activeMatches += hosted[i].numClients > 0 ? 1 : 0;
+        connected += hosted[i].numClients;
+    }
+
+    // How much of the threads' time went on ticks?
+    const double busy = total.busy / (interval * threads);
+    const int snapshots = total.fullSnapshots + total.deltas;
+    printf("%d client(s) in %d match(es) on %d thread(s): %.0f ticks/s, %.3f ms/tick (slowest %.3f ms), %.1f%% busy", connected,
+           activeMatches, threads, total.ticks / interval, total.ticks > 0 ? 1000.0 * total.busy / total.ticks : 0.0,
+           1000.0 * total.slowest, 100.0 * busy);
+    if (activeMatches > 0 && busy > 0.0)
+    {
+        printf(", room for about %d match(es)", (int)(activeMatches / busy));
+    }
+    printf("\n  %d late tick(s) (latest finished %.3f ms after it was due), %d skipped\n", total.overruns, 1000.0 * total.latest,
+           total.skipped);
+    printf("  in %.0f packets/s, out %.0f packets/s, %.1f KB/s, %.0f bytes/snapshot, %.1f%% deltas\n", total.packetsIn / interval,
+           total.packetsOut / interval, total.bytesOut / interval / 1024.0,
+           snapshots > 0 ? (double)total.snapshotBytes / snapshots : 0.0,
+           snapshots > 0 ? 100.0 * total.deltas / snapshots : 0.0);
+    int watching = 0;
+    for (int i = 0; i < MAX_SPECTATORS; i++)
+    {
+        watching += spectators[i].connected ? 1 : 0;
+    }
+    if (watching > 0)
+    {
+        printf("  %d spectator(s), %.0f bytes/snapshot of what they can see\n", watching,
+               total.spectatorViews > 0 ? (double)total.spectatorBytes / total.spectatorViews : 0.0);
+    }
+    stats = (Stats){.ticks = 0};
+}
+
+int main(int argc, char* argv[])
+{
+    int port = NET_DEFAULT_PORT;
+    numMatches = DEFAULT_MATCHES;
+    tanksPerMatch = DEFAULT_TANKS;
+    double seconds = 0.0;
+    int threads = GetProcessorCount();
+    if (argc > 1)
+    {
+        port = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        numMatches = atoi(argv[2]);
+    }
+    if (argc > 3)
+    {
+        tanksPerMatch = atoi(argv[3]);
+    }
+    if (argc > 4)
+    {
+        seconds = atof(argv[4]);
+    }
+    if (argc > 5)
+    {
+        threads = atoi(argv[5]);
+    }
+    if (argc > 6 || port <= 0 || port > 65535 || numMatches <= 0 || tanksPerMatch < 1 || tanksPerMatch > MAX_TANKS ||
+        seconds < 0.0 || threads < 1)
+    {
+        fprintf(stderr, "Usage: %s [port] [matches] [tanks per match (1-%d)] [seconds] [threads]\n", argv[0], MAX_TANKS);
+        return EXIT_FAILURE;
+    }
+
+    // The main thread ticks matches too, so it needs one fewer worker than there are threads.
+    const int workers = threads - 1 < BDR_THREADS_MAX_WORKERS ? threads - 1 : BDR_THREADS_MAX_WORKERS;
+    if (!InitWorkerPool(workers))
+    {
+        fprintf(stderr, "tanks_server: could only start %d of %d worker(s)\n", GetWorkerCount(), workers);
+    }
+    threads = GetWorkerCount() + 1;
+
+    hosted = malloc((size_t)numMatches * sizeof(HostedMatch));
+    due = malloc((size_t)numMatches * sizeof(int));
+    if (hosted == NULL || due == NULL)
+    {
+        fprintf(stderr, "tanks_server: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    if (!InitUdp() || !OpenUdpSocket(&udp, (unsigned short)port))
+    {
+        fprintf(stderr, "tanks_server: can't open UDP port %d\n", port);
+        return EXIT_FAILURE;
+    }
+
+    rules = GetDefaultMatchRules();
+    const float arenaScale = tanksPerMatch > MAX_PLAYERS ? sqrtf((float)tanksPerMatch / MAX_PLAYERS) : 1.0f;
+    arenaWidth = ARENA_WIDTH * arenaScale;
+    arenaHeight = ARENA_HEIGHT * arenaScale;
+    for (int i = 0; i < numMatches; i++)
+    {
+        for (int j = 0; j < MAX_TANKS; j++)
+        {
+            hosted[i].clients[j] = -1;
+        }
+        hosted[i].numClients = 0;
+        InitNetHistory(&hosted[i].history);
+        hosted[i].tick = 0;
+        hosted[i].nextTick = 0.0;
+        hosted[i].stats = (Stats){.ticks = 0};
+        StartRound(&hosted[i]);
+    }
+    printf("Hosting %d match(es) of up to %d tank(s) in a %.0fx%.0f arena on port %d, on %d thread(s)\n", numMatches, tanksPerMatch,
+           arenaWidth, arenaHeight, port, threads);
+
+    const double start = GetBenchTime();
+    double lastReport = start;
+    double now = start;
+    while (seconds == 0.0 || now - start < seconds)
+    {
+        // Handle packets, then tick whichever matches are due. If none are, wait for packets until the next one is.
+        ReceivePackets(now);
+        DropSilentClients(now);
+        double earliest;
+        const int numDue = FindDueMatches(now, &earliest);
+        if (numDue > 0)
+        {
+            ParallelFor(numDue, 1, TickDueMatches, NULL);
+        }
+        else
+        {
+            WaitForUdp(udp, earliest - now);
+        }
+
+        now = GetBenchTime();
+        if (now - lastReport >= REPORT_INTERVAL)
+        {
+            Report(now - lastReport, threads);
+            lastReport = now;
+        }
+    }
+
+    CloseWorkerPool();
+    CloseUdpSocket(&udp);
+    CloseUdp();
+    free(due);
+    free(hosted);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,269 @@
+// Watches a match on a server on this machine, in a window, without driving a tank.
+//
+// Usage: tanks_spectator [port] [match]
+//
+// The spectator tells the server which part of the arena it can see, and draws whatever the server sends it the same way as the
+// playing screen does. If the arena is bigger than the window, then the server only sends what's in or near the window, so a tank
+// can only be followed once it's in view. [Tab] follows the next tank in view, and the arrow keys look around.
+//
+// [N] and [P] switch to the next and previous matches. The server welcomes us to the new match if it's there, and tells us that
+// it's full if it isn't, in which case we carry on watching the one that we were watching.
+
+#define BDR_LOOP_IMPLEMENTATION
+#define BDR_UDP_IMPLEMENTATION
+#include "bdr/loop.h"
+#include "bdr/udp.h"
+#include "draw.h"
+#include "match.h"
+#include "net.h"
+#include "raylib.h"
+#include "raymath.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+#define RENDER_FPS 60
+#define WATCH_INTERVAL 0.5 // How long, in seconds, to go without a snapshot before telling the server what we want to watch again.
+#define LOOK_SPEED 16.0f   // How far the arrow keys move the view in each fixed update.
+
+static UdpSocket udp;
+static UdpAddress server;
+static int wanted;      // Which match do we want to watch?
+static int watching;    // Which match did the server welcome us to?
+static bool joined;     // Has the server welcomed us?
+static bool refused;    // Has the server told us that there's no room?
+static double lastSent; // When did we last tell the server what we want to watch?
+static int latest;      // The tick of the latest snapshot that we have, or NET_NO_BASELINE.
+static Match view;      // What we know of the match.
+static NetHistory history;
+static Vector2 camera;  // Which point in the arena is in the middle of the window?
+static int following;   // Which tank is the camera following, or NET_NO_TANK?
+
+static unsigned char packet[NET_MAX_PACKET];
+
+// Get where the window's top left corner is in the arena. If the arena fits in the window, then it's all in view.
+static Vector2 GetOrigin(void)
+{
+    const float width = (float)GetScreenWidth();
+    const float height = (float)GetScreenHeight();
+    return (Vector2){view.width > width ? fmodf(camera.x - width / 2 + view.width, view.width) : 0.0f,
+                     view.height > height ? fmodf(camera.y - height / 2 + view.height, view.height) : 0.0f};
+}
+
+static void SendWatch(void)
+{
+    const Vector2 origin = GetOrigin();
+    const NetWatch watch = {
+            .match = wanted,
+            .ack = latest,
+            .view = {origin.x, origin.y, fminf((float)GetScreenWidth(), view.width), fminf((float)GetScreenHeight(), view.height)}};
+    SendUdp(udp, server, packet, WriteNetWatch(packet, sizeof(packet), &watch));
+    lastSent = GetTime();
+}
+
+// Start watching the match that the server welcomed us to. If we were watching another one, then nothing that we had of it is any
+// use, and its ticks have nothing to do with the new one's.
+static void Join(const NetWelcome* welcome)
+{
+    joined = true;
+    wanted = welcome->match;
+    watching = welcome->match;
+    latest = NET_NO_BASELINE;
+    following = NET_NO_TANK;
+    InitNetHistory(&history);
+    const MatchRules rules = GetDefaultMatchRules();
+    InitMatch(&view, &rules, 0, 0, welcome->width, welcome->height, 0);
+    camera = (Vector2){welcome->width / 2, welcome->height / 2};
+}
+
+// Ask the server to switch us to another match.
+static void Switch(int match)
+{
+    if (match >= 0)
+    {
+        wanted = match;
+        SendWatch();
+    }
+}
+
+// Decode a snapshot, then tell the server that we have it, and what we can see now.
+static void TakeSnapshot(int size)
+{
+    static NetSnapshot snapshot;
+
+    const int baselineTick = GetNetSnapshotBaseline(packet, size);
+    const NetSnapshot* baseline = FindNetSnapshot(&history, baselineTick);
+    if ((baselineTick != NET_NO_BASELINE && baseline == NULL) || !ReadNetSnapshot(packet, size, baseline, &snapshot) ||
+        snapshot.tick <= latest)
+    {
+        return;
+    }
+    latest = snapshot.tick;
+    StoreNetSnapshot(&history, &snapshot);
+    ApplyNetSnapshot(&snapshot, &view);
+    SendWatch();
+}
+
+static void ReceivePackets(void)
+{
+    UdpAddress from;
+    int size;
+    while ((size = ReceiveUdp(udp, &from, packet, sizeof(packet))) > 0)
+    {
+        if (!IsSameUdpAddress(from, server))
+        {
+            continue;
+        }
+        const NetMessageType type = GetNetMessageType(packet, size);
+        NetWelcome welcome;
+        if (type == NET_WELCOME && ReadNetWelcome(packet, size, &welcome) && (!joined || welcome.match != watching))
+        {
+            Join(&welcome);
+        }
+        else if (type == NET_FULL && !joined)
+        {
+            refused = true;
+        }
+        else if (type == NET_FULL)
+        {
+            // The match that we asked for isn't there, so the server kept us on the one that we were watching.
+            wanted = watching;
+        }
+        else if (type == NET_SNAPSHOT && joined && wanted == watching)
+        {
+            TakeSnapshot(size);
+        }
+    }
+}
+
+// Follow the next tank after the one that we're following that's in view, if there is one.
+static void FollowNextTank(void)
+{
+    for (int i = 1; i <= view.count; i++)
+    {
+        const int tank = (following + i + view.count) % view.count;
+        if (view.tanks[tank].alive)
+        {
+            following = tank;
+            return;
+        }
+    }
+    following = NET_NO_TANK;
+}
+
+void FixedUpdate(void)
+{
+    ReceivePackets();
+
+    // Move the camera with the arrow keys, or with the tank that it's following.
+    const Vector2 look = {(float)(IsKeyDown(KEY_RIGHT) - IsKeyDown(KEY_LEFT)), (float)(IsKeyDown(KEY_DOWN) - IsKeyDown(KEY_UP))};
+    if (joined && (look.x != 0.0f || look.y != 0.0f))
+    {
+        following = NET_NO_TANK;
+        camera = MoveInMatch(&view, camera, Vector2Scale(look, LOOK_SPEED));
+    }
+    else if (following != NET_NO_TANK && view.tanks[following].alive)
+    {
+        camera = view.tanks[following].pos;
+    }
+
+    // Until the snapshots start, keep telling the server what we want to watch, as it or we may have missed something.
+    if (!refused && GetTime() - lastSent >= WATCH_INTERVAL)
+    {
+        SendWatch();
+    }
+}
+
+void Update(double elapsed)
+{
+    (void)elapsed;
+}
+
+void CheckTriggers(void)
+{
+    if (IsKeyPressed(KEY_TAB) && joined)
+    {
+        FollowNextTank();
+    }
+    if (IsKeyPressed(KEY_N) && joined)
+    {
+        Switch(watching + 1);
+    }
+    if (IsKeyPressed(KEY_P) && joined)
+    {
+        Switch(watching - 1);
+    }
+}
+
+void Draw(double alpha)
+{
+    BeginDrawing();
+    ClearBackground(BLACK);
+
+    if (joined)
+    {
+        DrawMatch(&view, GetOrigin(), alpha);
+        DrawText(wanted == watching ? TextFormat("SPECTATING MATCH %d", watching)
+                                    : TextFormat("SPECTATING MATCH %d, SWITCHING TO MATCH %d", watching, wanted),
+                 4, 4, 20, RAYWHITE);
+        const char* help = "[Tab] to follow a tank, arrow keys to look around, [N] / [P] for the next / previous match";
+        DrawText(help, (GetScreenWidth() - MeasureText(help, 20)) / 2, 7 * GetScreenHeight() / 8, 20, RAYWHITE);
+    }
+    else
+    {
+        DrawText(refused ? TextFormat("MATCH %d ISN'T THERE, OR HAS NO ROOM", wanted) : TextFormat("WAITING FOR MATCH %d", wanted),
+                 4, 4, 20, RAYWHITE);
+    }
+    DrawFPS(GetScreenWidth() / 2 - 16, GetScreenHeight() - 24);
+
+    EndDrawing();
+}
+
+int main(int argc, char* argv[])
+{
+    int port = NET_DEFAULT_PORT;
+    wanted = 0;
+    if (argc > 1)
+    {
+        port = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        wanted = atoi(argv[2]);
+    }
+    if (argc > 3 || port <= 0 || port > 65535 || wanted < 0)
+    {
+        fprintf(stderr, "Usage: %s [port] [match]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (!InitUdp() || !OpenUdpSocket(&udp, 0))
+    {
+        fprintf(stderr, "tanks_spectator: can't open a UDP socket\n");
+        return EXIT_FAILURE;
+    }
+    server = GetLoopbackAddress((unsigned short)port);
+    latest = NET_NO_BASELINE;
+    following = NET_NO_TANK;
+    InitNetHistory(&history);
+
+#if !defined(NO_MSAA)
+    SetConfigFlags(FLAG_MSAA_4X_HINT);
+#endif
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Tanks - Spectator");
+    SetTargetFPS(RENDER_FPS);
+    lastSent = -WATCH_INTERVAL;
+
+    RunMainLoop();
+
+    if (joined)
+    {
+        SendUdp(udp, server, packet, WriteNetBye(packet, sizeof(packet)));
+    }
+    CloseWindow();
+    CloseUdpSocket(&udp);
+    CloseUdp();
+    return EXIT_SUCCESS;
+}
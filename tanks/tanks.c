@@ -1,8 +1,20 @@
+#define BDR_EVENTLOG_IMPLEMENTATION
 #define BDR_LOOP_IMPLEMENTATION
 #define BDR_LOOP_SHOULD_QUIT ShouldQuit
+#define BDR_LATENCY_IMPLEMENTATION
+#define BDR_LAYERS_IMPLEMENTATION
+#define BDR_PACK_IMPLEMENTATION
+#define BDR_SCALING_IMPLEMENTATION
+#define BDR_UI_IMPLEMENTATION
 #include "tanks.h"
 
+#include "bdr/eventlog.h"
 #include "bdr/loop.h"
+#include "bdr/latency.h"
+#include "bdr/layers.h"
+#include "bdr/pack.h"
+#include "bdr/scaling.h"
+#include "bdr/ui.h"
 #include "raylib.h"
 
 #if defined(PLATFORM_WEB) || defined(EMSCRIPTEN)
@@ -19,6 +31,8 @@
 
 #define MAX_DELTA 0.1f
 
+#define EVENT_LOG_FILE "tanks_events.bin"
+
 #if defined(EMSCRIPTEN)
 #define CAP_FRAME_RATE 0
 #else
@@ -70,13 +84,18 @@ void FixedUpdate(void)
         {
             FinishControlsScreen();
             currentScreen = PLAYING;
-            ControllerId controllers[MAX_PLAYERS];
+            ControllerId controllers[MAX_TANKS];
             int numPlayers = GetNumberOfPlayers();
             for (int i = 0; i < numPlayers; i++)
             {
                 controllers[i] = GetControllerAssignment(i);
             }
-            InitPlayingScreen(numPlayers, controllers);
+            int numBots = GetNumberOfBots();
+            for (int i = 0; i < numBots; i++)
+            {
+                controllers[numPlayers + i] = (ControllerId)(CONTROLLER_AI + i);
+            }
+            InitPlayingScreen(numPlayers + numBots, controllers);
         }
         else if (IsCancelledControlsScreen())
         {
@@ -106,6 +125,9 @@ void Update(double elapsed)
 
 void CheckTriggers(void)
 {
+    // Sample every controller once, for the screens to use.
+    SampleControllers();
+
     if (IsKeyPressed(KEY_F11))
     {
         ToggleFullscreen();
@@ -117,6 +139,19 @@ void CheckTriggers(void)
         SetTargetFPS(renderFps);
     }
 
+    // Toggle input latency tracking. The histograms are shown on the playing screen, and logged when tracking is turned off.
+    if (IsKeyPressed(KEY_F9))
+    {
+        EnableLatencyTracking(!IsLatencyTrackingEnabled());
+    }
+
+    // Toggle dynamic resolution.
+    if (IsKeyPressed(KEY_F8))
+    {
+        EnableDynamicResolution(!IsDynamicResolutionEnabled());
+        SetRenderScale(1.0f);
+    }
+
     switch (currentScreen)
     {
     case MENU:
@@ -153,6 +188,9 @@ void Draw(double alpha)
         EndDrawing();
         break;
     }
+
+    // EndDrawing() has presented the frame.
+    MarkFramePresented(GetTime());
 }
 
 #if !defined(PLATFORM_WEB) && !defined(EMSCRIPTEN)
@@ -170,10 +208,33 @@ int main(void)
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Tanks");
     SetTargetFPS(renderFps);
     SetExitKey(0);
+    MountAssetPack("assets/assets.pak");
+
+    // Drop the resolution to keep up with the slow frame rate, whichever frame rate we're aiming for.
+    SetRenderScaleRange(0.5f, 1.0f);
+    SetFrameBudget(1.0 / SLOW_FPS);
+    EnableDynamicResolution(true);
+
+    // Log what happens in each match for analytics. There's no disk to keep the log on in a browser.
+#if !defined(PLATFORM_WEB) && !defined(EMSCRIPTEN)
+    if (!OpenEventLog(EVENT_LOG_FILE))
+    {
+        TraceLog(LOG_WARNING, "EVENTS: [%s] Can't open the event log", EVENT_LOG_FILE);
+    }
+#endif
+
     InitScreens();
 
     RunMainLoop();
 
+    if (GetDroppedEventCount() > 0)
+    {
+        TraceLog(LOG_WARNING, "EVENTS: %d events were dropped because the disk couldn't keep up", GetDroppedEventCount());
+    }
+    CloseEventLog();
+    EnableLatencyTracking(false);
+    UnmountAssetPack();
+    UnloadRenderScaling();
     CloseWindow();
 
     return 0;
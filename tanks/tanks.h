@@ -3,6 +3,12 @@
 #include <stdbool.h>
 
 #define MAX_PLAYERS 4
+#define MAX_BOTS 60
+#define MAX_TANKS (MAX_PLAYERS + MAX_BOTS)
+
+#define MAX_KEYBOARDS 2
+#define MAX_GAMEPADS 4
+#define MAX_CONTROLLERS (MAX_KEYBOARDS + MAX_GAMEPADS)
 
 // Gamepad number (as it seems to have vanished from raylib.h)
 typedef enum
@@ -21,11 +27,55 @@ typedef enum ControllerId
     CONTROLLER_GAMEPAD1,
     CONTROLLER_GAMEPAD2,
     CONTROLLER_GAMEPAD3,
-    CONTROLLER_GAMEPAD4
+    CONTROLLER_GAMEPAD4,
+    CONTROLLER_AI // The first bot's controller. Bot n is driven by CONTROLLER_AI + n.
 } ControllerId;
 
+// Actions that a controller can perform.
+typedef enum
+{
+    INPUT_THRUST,       // Accelerate.
+    INPUT_REVERSE,      // Brake / reverse.
+    INPUT_FIRE,         // Fire.
+    INPUT_START,        // Start from the menu.
+    INPUT_SELECT,       // Select / confirm a controller.
+    INPUT_BACK,         // Go back from a controller selection.
+    INPUT_PAUSE,        // Pause, or leave the current screen.
+    INPUT_RESUME,       // Resume after pausing.
+    INPUT_KILL_CAM,     // Watch the last kill again.
+    INPUT_REWIND,       // Rewind while paused.
+    INPUT_FAST_FORWARD, // Go forward again after rewinding.
+    INPUT_ADD_BOTS,     // Add bots to the next match.
+    INPUT_REMOVE_BOTS   // Remove bots from the next match.
+} InputAction;
+
+// Axes that a controller can drive.
+typedef enum
+{
+    INPUT_AXIS_TURN, // Turn left / right.
+    INPUT_AXIS_GUN,  // Turn the gun left / right.
+    INPUT_AXIS_COUNT
+} InputAxis;
+
 // clang-format off
 
+// Input. Every device is sampled once per frame into a per-controller state table that the screens query.
+void SampleControllers(void);                                   // Sample every input device. Call once per frame.
+bool IsControllerAvailable(ControllerId controller);            // Check if a controller is connected.
+bool IsControllerDown(ControllerId controller, InputAction action); // Check if a controller's action is held down.
+bool IsControllerPressed(ControllerId controller, InputAction action); // Check if a controller's action went down this frame.
+bool IsControllerReleased(ControllerId controller, InputAction action); // Check if a controller's action went up this frame.
+bool IsAnyControllerDown(InputAction action);                   // Check if any controller's action is held down.
+bool IsAnyControllerPressed(InputAction action);                // Check if any controller's action went down this frame.
+bool IsAnyControllerReleased(InputAction action);               // Check if any controller's action went up this frame.
+float GetControllerAxis(ControllerId controller, InputAxis axis); // Get the position of a controller's axis.
+double GetInputSampleTime(void);                                // Get the time at which the controllers were last sampled.
+double GetControllerEventTime(ControllerId controller);         // Get the sample time of a controller's last driving input.
+bool IsBotController(ControllerId controller);                  // Check if a controller is driven by a bot.
+
+// Drive the first count bots' controllers from their decisions, all in one go.
+void SetBotControllers(int count, const bool* thrust, const bool* reverse, const float* turn, const float* gun);
+
 // Menu screen.
 void InitMenuScreen(void);                                      // Initialise the menu screen.
 void FinishMenuScreen(void);                                    // Tear down the menu screen.
@@ -45,13 +95,15 @@ bool IsCancelledControlsScreen(void);                           // Check if the
 bool IsStartedControlsScreen(void);                             // Check if the controls screen is ready for the game to start.
 ControllerId GetControllerAssignment(int player);               // Get the controller assigned to the given player.
 int GetNumberOfPlayers(void);                                   // Get the number of players.
+int GetNumberOfBots(void);                                      // Get the number of bots to add to the players.
 
 // Playing screen.
-void InitPlayingScreen(int players, const ControllerId* controllers); // Initialise the playing screen.
+void InitPlayingScreen(int count, const ControllerId* controllers); // Initialise the playing screen with a tank per controller.
 void FinishPlayingScreen(void);                                 // Tear down the playing screen.
 void UpdatePlayingScreen(void);                                 // Update the playing screen.
 void DrawPlayingScreen(double alpha);                           // Draw the playing screen.
 void CheckTriggersPlayingScreen(void);                          // Allow the playing screen to handle edge-triggered events.
 bool IsCancelledPlayingScreen(void);                            // Check if the playing screen is cancelled.
+const float* GetLidarDistances(int tank);                       // Get how far a tank can see along each of its lidar rays.
 
 // clang-format on
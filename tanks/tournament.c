@@ -0,0 +1,271 @@
+// Plays bot-only tank matches without a window, one match per thread at a time, on every processor.
+//
+// Usage: tournament [matches] [tanks] [shot speed]
+//
+// Every match has the same number of bots, who start in different places in each match. A match is over when there's one tank
+// left, or none, or when it has gone on for MATCH_SECONDS, which counts as a draw. Each match is seeded by its number, so the
+// results don't depend on how many workers there are, and the same command line always gives the same results. That means a rule,
+// e.g., the shot speed, can be changed from the command line and the results compared.
+//
+// Matches vary a lot in length, so rather than each thread being handed its share of them up front, each thread takes the next
+// match whenever it finishes one. A match is played in a scratch match and bots from a small pool, with one of each per thread.
+//
+// It reports how often each starting slot wins, how long matches last, how many shots hit, how many ticks were simulated per
+// second, and how much of the time the threads were busy.
+
+#define BDR_BENCH_IMPLEMENTATION
+#define BDR_THREADS_IMPLEMENTATION
+#include "ai.h"
+#include "bdr/bench.h"
+#include "bdr/sync.h"
+#include "bdr/threads.h"
+#include "match.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ARENA_WIDTH 1280.0f
+#define ARENA_HEIGHT 720.0f
+#define UPDATE_FPS 50
+#define MATCH_SECONDS 300
+#define MATCH_TICKS (MATCH_SECONDS * UPDATE_FPS)
+#define DEFAULT_MATCHES 1000
+#define DEFAULT_TANKS 8
+#define SLOTS_PER_LINE 8
+
+// How a match went.
+typedef struct
+{
+    int winner;  // Which tank won, or -1 for a draw.
+    int ticks;   // How many updates did the match last?
+    int shots;   // How many shots were fired?
+    int hits;    // How many of them destroyed a tank?
+    double time; // How long did it take to play?
+} MatchResult;
+
+// Somewhere to play a match. There's one per thread, and a thread takes one from the pool for each match that it plays.
+typedef struct
+{
+    Match match;
+    Bots bots;
+} Scratch;
+
+// What the threads share. Each match has its own result, and a scratch is only used by one thread at a time, so nothing is
+// written by more than one thread, apart from the list of spare scratches, which the lock protects.
+typedef struct
+{
+    MatchRules rules;     // The rules that every match is played by.
+    int tanks;            // How many tanks are there in each match?
+    int matches;          // How many matches are there?
+    int threads;          // How many matches are played at once?
+    Scratch* scratches;   // Somewhere for each thread to play.
+    int* spare;           // Which scratches aren't in use?
+    int numSpare;         // How many of them are there?
+    MatchResult* results; // How each match went.
+#if defined(BDR_SYNC_WIN32) || defined(BDR_SYNC_PTHREADS)
+    BdrLock lock;         // Protects the spare scratches.
+#endif
+} Tournament;
+
+static void LockScratches(Tournament* tournament)
+{
+#if defined(BDR_SYNC_WIN32)
+    AcquireSRWLockExclusive(&tournament->lock);
+#elif defined(BDR_SYNC_PTHREADS)
+    pthread_mutex_lock(&tournament->lock);
+#else
+    (void)tournament;
+#endif
+}
+
+static void UnlockScratches(Tournament* tournament)
+{
+#if defined(BDR_SYNC_WIN32)
+    ReleaseSRWLockExclusive(&tournament->lock);
+#elif defined(BDR_SYNC_PTHREADS)
+    pthread_mutex_unlock(&tournament->lock);
+#else
+    (void)tournament;
+#endif
+}
+
+// There are as many scratches as threads, and each thread gives its scratch back before it takes another, so there's always one.
+static Scratch* TakeScratch(Tournament* tournament)
+{
+    LockScratches(tournament);
+    Scratch* scratch = &tournament->scratches[tournament->spare[--tournament->numSpare]];
+    UnlockScratches(tournament);
+    return scratch;
+}
+
+static void GiveBackScratch(Tournament* tournament, const Scratch* scratch)
+{
+    LockScratches(tournament);
+    tournament->spare[tournament->numSpare++] = (int)(scratch - tournament->scratches);
+    UnlockScratches(tournament);
+}
+
+static void PlayMatch(const Tournament* tournament, int index, Match* match, Bots* bots, MatchResult* result)
+{
+    InitMatch(match, &tournament->rules, tournament->tanks, 0, ARENA_WIDTH, ARENA_HEIGHT, (unsigned int)index);
+    InitBots(bots, tournament->tanks, 0, (unsigned int)index + 1);
+    result->shots = 0;
+    result->hits = 0;
+    while (CountLivingTanks(match) > 1 && match->ticks < MATCH_TICKS)
+    {
+        TankControls controls[MAX_TANKS];
+        ShotRequest requests[MAX_SHOT_REQUESTS];
+        DecideBots(bots, match);
+        const int numRequests = GetBotControls(bots, controls, requests);
+        UpdateMatch(match, controls, requests, numRequests);
+        for (int i = 0; i < match->numEvents; i++)
+        {
+            result->shots += match->events[i].type == MATCH_SHOT_FIRED ? 1 : 0;
+            result->hits += match->events[i].type == MATCH_TANK_SHOT ? 1 : 0;
+        }
+    }
+    result->winner = GetMatchWinner(match);
+    result->ticks = match->ticks;
+}
+
+static void PlayMatches(void* data, int start, int end)
+{
+    Tournament* tournament = data;
+    Scratch* scratch = TakeScratch(tournament);
+    for (int i = start; i < end; i++)
+    {
+        const double startTime = GetBenchTime();
+        PlayMatch(tournament, i, &scratch->match, &scratch->bots, &tournament->results[i]);
+        tournament->results[i].time = GetBenchTime() - startTime;
+    }
+    GiveBackScratch(tournament, scratch);
+}
+
+static int CompareInts(const void* a, const void* b)
+{
+    const int x = *(const int*)a;
+    const int y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char* argv[])
+{
+    Tournament tournament = {.rules = GetDefaultMatchRules(), .matches = DEFAULT_MATCHES, .tanks = DEFAULT_TANKS};
+    if (argc > 1)
+    {
+        tournament.matches = atoi(argv[1]);
+    }
+    if (argc > 2)
+    {
+        tournament.tanks = atoi(argv[2]);
+    }
+    if (argc > 3)
+    {
+        tournament.rules.shotSpeed = (float)atof(argv[3]);
+    }
+    if (argc > 4 || tournament.matches <= 0 || tournament.tanks < 2 || tournament.tanks > MAX_BOTS ||
+        tournament.rules.shotSpeed <= 0.0f)
+    {
+        fprintf(stderr, "Usage: %s [matches] [tanks (2-%d)] [shot speed]\n", argv[0], MAX_BOTS);
+        return EXIT_FAILURE;
+    }
+
+    int workers = GetProcessorCount() - 1;
+    if (workers > BDR_THREADS_MAX_WORKERS)
+    {
+        workers = BDR_THREADS_MAX_WORKERS;
+    }
+    if (!InitWorkerPool(workers))
+    {
+        fprintf(stderr, "tournament: could only start %d of %d worker(s)\n", GetWorkerCount(), workers);
+    }
+    tournament.threads = GetWorkerCount() + 1;
+
+    tournament.scratches = malloc((size_t)tournament.threads * sizeof(Scratch));
+    tournament.spare = malloc((size_t)tournament.threads * sizeof(int));
+    tournament.results = malloc((size_t)tournament.matches * sizeof(MatchResult));
+    int* ticks = malloc((size_t)tournament.matches * sizeof(int));
+    if (tournament.scratches == NULL || tournament.spare == NULL || tournament.results == NULL || ticks == NULL)
+    {
+        fprintf(stderr, "tournament: out of memory\n");
+        return EXIT_FAILURE;
+    }
+    for (tournament.numSpare = 0; tournament.numSpare < tournament.threads; tournament.numSpare++)
+    {
+        tournament.spare[tournament.numSpare] = tournament.numSpare;
+    }
+#if defined(BDR_SYNC_WIN32)
+    InitializeSRWLock(&tournament.lock);
+#elif defined(BDR_SYNC_PTHREADS)
+    pthread_mutex_init(&tournament.lock, NULL);
+#endif
+
+    printf("%d match(es) of %d tank(s), shot speed %.2f, on %d thread(s)\n", tournament.matches, tournament.tanks,
+           tournament.rules.shotSpeed, tournament.threads);
+    const double start = GetBenchTime();
+    ParallelFor(tournament.matches, 1, PlayMatches, &tournament);
+    const double elapsed = GetBenchTime() - start;
+    CloseWorkerPool();
+#if defined(BDR_SYNC_PTHREADS)
+    pthread_mutex_destroy(&tournament.lock);
+#endif
+
+    // Tally the results.
+    int wins[MAX_TANKS] = {0};
+    int draws = 0;
+    int timeouts = 0;
+    long long totalTicks = 0;
+    long long shots = 0;
+    long long hits = 0;
+    double busy = 0.0;
+    double slowest = 0.0;
+    for (int i = 0; i < tournament.matches; i++)
+    {
+        const MatchResult* result = &tournament.results[i];
+        if (result->winner >= 0)
+        {
+            ++wins[result->winner];
+        }
+        else
+        {
+            ++draws;
+            timeouts += result->ticks >= MATCH_TICKS ? 1 : 0;
+        }
+        ticks[i] = result->ticks;
+        totalTicks += result->ticks;
+        shots += result->shots;
+        hits += result->hits;
+        busy += result->time;
+        slowest = result->time > slowest ? result->time : slowest;
+    }
+    qsort(ticks, (size_t)tournament.matches, sizeof(int), CompareInts);
+
+    const double percent = 100.0 / tournament.matches;
+    printf("\nWins by starting slot\n");
+    for (int slot = 0; slot < tournament.tanks; slot++)
+    {
+        printf("  %2d: %5.1f%%%s", slot, wins[slot] * percent, (slot + 1) % SLOTS_PER_LINE == 0 ? "\n" : "");
+    }
+    printf("%s  Draws: %.1f%% (%.1f%% timed out)\n", tournament.tanks % SLOTS_PER_LINE == 0 ? "" : "\n", draws * percent,
+           timeouts * percent);
+
+    printf("\nMatch length\n");
+    printf("  mean %.1f s, median %.1f s, 95th percentile %.1f s, longest %.1f s\n",
+           (double)totalTicks / tournament.matches / UPDATE_FPS, (double)ticks[tournament.matches / 2] / UPDATE_FPS,
+           (double)ticks[tournament.matches * 95 / 100] / UPDATE_FPS, (double)ticks[tournament.matches - 1] / UPDATE_FPS);
+
+    printf("\nShots\n");
+    printf("  %.1f fired per match, %.1f%% hit\n", (double)shots / tournament.matches, shots > 0 ? 100.0 * hits / shots : 0.0);
+
+    printf("\nThroughput\n");
+    printf("  %.3f s, %.0f ticks/s, %.0f tank ticks/s, %.1f matches/s\n", elapsed, (double)totalTicks / elapsed,
+           (double)totalTicks * tournament.tanks / elapsed, tournament.matches / elapsed);
+    printf("  %d thread(s) busy for %.1f%% of the time, slowest match %.3f s\n", tournament.threads,
+           100.0 * busy / (elapsed * tournament.threads), slowest);
+
+    free(ticks);
+    free(tournament.results);
+    free(tournament.spare);
+    free(tournament.scratches);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,168 @@
+// Builds an asset pack for bdr/pack.h from a list of files.
+//
+// Usage: mkpack <output.pak> <prefix> <file>...
+//
+// Each file is stored under its prefix + file name, e.g., "assets/" + "Mecha.ttf" gives "assets/Mecha.ttf", so that games can
+// ask for an asset by the same path that they would use to load it from disk.
+
+#include "bdr/pack.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    char name[BDR_PACK_NAME_SIZE];
+    const char* path;
+    unsigned int offset;
+    unsigned int size;
+} Entry;
+
+static const char* BaseName(const char* path)
+{
+    const char* base = path;
+    for (const char* p = path; *p != '\0'; p++)
+    {
+        if (*p == '/' || *p == '\\')
+        {
+            base = p + 1;
+        }
+    }
+    return base;
+}
+
+static int CompareEntries(const void* a, const void* b)
+{
+    return strcmp(((const Entry*)a)->name, ((const Entry*)b)->name);
+}
+
+static void WriteU32(FILE* f, unsigned int value)
+{
+    const unsigned char bytes[4] = {(unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16),
+                                    (unsigned char)(value >> 24)};
+    fwrite(bytes, 1, sizeof(bytes), f);
+}
+
+static void WritePadding(FILE* f, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        fputc(0, f);
+    }
+}
+
+static unsigned int AlignUp(unsigned int value)
+{
+    return (value + BDR_PACK_ALIGNMENT - 1) & ~(unsigned int)(BDR_PACK_ALIGNMENT - 1);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        fprintf(stderr, "Usage: %s <output.pak> <prefix> <file>...\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char* output = argv[1];
+    const char* prefix = argv[2];
+    const int count = argc - 3;
+
+    Entry* entries = calloc((size_t)(count > 0 ? count : 1), sizeof(Entry));
+    if (entries == NULL)
+    {
+        fprintf(stderr, "mkpack: out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    // Work out the name and size of each entry.
+    for (int i = 0; i < count; i++)
+    {
+        Entry* entry = &entries[i];
+        entry->path = argv[i + 3];
+        if (snprintf(entry->name, sizeof(entry->name), "%s%s", prefix, BaseName(entry->path)) >= (int)sizeof(entry->name))
+        {
+            fprintf(stderr, "mkpack: name too long for %s\n", entry->path);
+            return EXIT_FAILURE;
+        }
+
+        FILE* in = fopen(entry->path, "rb");
+        if (in == NULL || fseek(in, 0, SEEK_END) != 0)
+        {
+            fprintf(stderr, "mkpack: cannot read %s\n", entry->path);
+            return EXIT_FAILURE;
+        }
+        entry->size = (unsigned int)ftell(in);
+        fclose(in);
+    }
+
+    // Sort the index so that it can be binary searched, then lay out the data.
+    qsort(entries, (size_t)count, sizeof(Entry), CompareEntries);
+    unsigned int offset = AlignUp(BDR_PACK_HEADER_SIZE + (unsigned int)count * BDR_PACK_ENTRY_SIZE);
+    for (int i = 0; i < count; i++)
+    {
+        if (i > 0 && strcmp(entries[i - 1].name, entries[i].name) == 0)
+        {
+            fprintf(stderr, "mkpack: duplicate entry %s\n", entries[i].name);
+            return EXIT_FAILURE;
+        }
+        entries[i].offset = offset;
+        offset = AlignUp(offset + entries[i].size);
+    }
+
+    FILE* out = fopen(output, "wb");
+    if (out == NULL)
+    {
+        fprintf(stderr, "mkpack: cannot write %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    // Header.
+    fwrite(BDR_PACK_MAGIC, 1, 4, out);
+    WriteU32(out, BDR_PACK_VERSION);
+    WriteU32(out, (unsigned int)count);
+    WriteU32(out, 0);
+
+    // Index.
+    for (int i = 0; i < count; i++)
+    {
+        fwrite(entries[i].name, 1, BDR_PACK_NAME_SIZE, out);
+        WriteU32(out, entries[i].offset);
+        WriteU32(out, entries[i].size);
+    }
+
+    // Data.
+    unsigned int written = BDR_PACK_HEADER_SIZE + (unsigned int)count * BDR_PACK_ENTRY_SIZE;
+    for (int i = 0; i < count; i++)
+    {
+        WritePadding(out, entries[i].offset - written);
+        written = entries[i].offset;
+
+        FILE* in = fopen(entries[i].path, "rb");
+        if (in == NULL)
+        {
+            fprintf(stderr, "mkpack: cannot read %s\n", entries[i].path);
+            return EXIT_FAILURE;
+        }
+        char buffer[4096];
+        size_t n;
+        while ((n = fread(buffer, 1, sizeof(buffer), in)) > 0)
+        {
+            fwrite(buffer, 1, n, out);
+            written += (unsigned int)n;
+        }
+        fclose(in);
+    }
+
+    if (fclose(out) != 0)
+    {
+        fprintf(stderr, "mkpack: failed to write %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    printf("mkpack: wrote %d assets to %s (%u bytes)\n", count, output, written);
+    free(entries);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#include "car.h"
+#include "raymath.h"
+
+#include <math.h>
+
+void InitCar(Car* car, float z)
+{
+    car->z = z;
+    car->x = 0.0f;
+    car->speed = 0.0f;
+    car->vx = 0.0f;
+    car->onRoad = true;
+}
+
+// How sharply the road bends at the middle segment, in world units per segment per segment. Positive bends to the right.
+float GetTrackCurvature(const TrackSegment road[3])
+{
+    return road[2].offset - 2 * road[1].offset + road[0].offset;
+}
+
+// Move the car on by one fixed update. The road is the segments behind, under and ahead of the car.
+void UpdateCar(Car* car, const CarControls* controls, const TrackSegment road[3], int length, float dt)
+{
+    // Speed up, slow down, or brake.
+    if (controls->brake)
+    {
+        car->speed -= CAR_BRAKING * dt;
+    }
+    else
+    {
+        car->speed += (CAR_ACCELERATION * controls->throttle - CAR_DRAG * (1.0f - controls->throttle)) * dt;
+    }
+
+    // The grass slows it down, but doesn't stop it.
+    if (!car->onRoad && car->speed > CAR_OFF_ROAD_SPEED)
+    {
+        car->speed = fmaxf(car->speed - CAR_OFF_ROAD_DRAG * dt, CAR_OFF_ROAD_SPEED);
+    }
+    car->speed = Clamp(car->speed, 0.0f, CAR_MAX_SPEED);
+
+    // Steering works better the faster it goes, but bends push it outwards with the square of its speed.
+    const float grip = car->speed / CAR_MAX_SPEED;
+    const float drift = -GetTrackCurvature(road) * car->speed * car->speed * CAR_CENTRIFUGAL;
+    car->vx = Clamp(controls->steer, -1.0f, 1.0f) * CAR_STEERING * grip + drift;
+    car->x = Clamp(car->x + car->vx * dt, -CAR_MAX_X, CAR_MAX_X);
+    car->onRoad = fabsf(car->x) <= road[1].width;
+
+    car->z += car->speed * dt;
+    if (car->z >= (float)length)
+    {
+        car->z -= (float)length;
+    }
+}
+
+// Drive flat out, steering back towards the centre line against the drift.
+CarControls GetAutopilotControls(const Car* car, const TrackSegment road[3])
+{
+    CarControls controls = {.steer = 0.0f, .throttle = 1.0f, .brake = false};
+    if (car->speed > 0.0f)
+    {
+        const float drift = -GetTrackCurvature(road) * car->speed * car->speed * CAR_CENTRIFUGAL;
+        const float wanted = -2.0f * car->x;
+        controls.steer = Clamp((wanted - drift) / (CAR_STEERING * car->speed / CAR_MAX_SPEED), -1.0f, 1.0f);
+    }
+    return controls;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "track.h"
+
+#include <stdbool.h>
+
+#define CAR_MAX_SPEED 60.0f      // Top speed on the road, in segments per second.
+#define CAR_OFF_ROAD_SPEED 15.0f // Top speed off the road.
+#define CAR_ACCELERATION 12.0f   // How quickly the car speeds up, in segments per second per second.
+#define CAR_BRAKING 40.0f        // How quickly the brakes slow it down.
+#define CAR_DRAG 4.0f            // How quickly it slows down when coasting.
+#define CAR_OFF_ROAD_DRAG 30.0f  // How quickly the grass slows it down to CAR_OFF_ROAD_SPEED.
+#define CAR_STEERING 3000.0f     // How quickly it moves across the road at top speed, in world units per second.
+#define CAR_CENTRIFUGAL 0.5f     // How strongly bends push it towards their outside.
+#define CAR_MAX_X 4000.0f        // How far from the centre line it can go.
+
+// How the car is being driven. Steering is -1 for full left to 1 for full right, and throttle is 0 to 1.
+typedef struct
+{
+    float steer;
+    float throttle;
+    bool brake;
+} CarControls;
+
+// A car on the track. Its x is relative to the centre line, so it follows the road unless it's steered or pushed off it.
+typedef struct
+{
+    float z;     // How far around the lap is it, in segments?
+    float x;     // How far left or right of the centre line is it, in world units? Negative is left.
+    float speed; // How fast is it going along the track, in segments per second?
+    float vx;    // How fast is it moving across the track, in world units per second?
+    bool onRoad; // Is it on the road?
+} Car;
+
+void InitCar(Car* car, float z);
+void UpdateCar(Car* car, const CarControls* controls, const TrackSegment road[3], int length, float dt);
+CarControls GetAutopilotControls(const Car* car, const TrackSegment road[3]);
+float GetTrackCurvature(const TrackSegment road[3]);
@@ -0,0 +1,211 @@
+#include "geometry.h"
+
+#include "bdr/threads.h"
+#include "raymath.h"
+
+#include <string.h>
+
+// Everything is drawn from one texture atlas, including the road, which uses a white texel, so it all goes into one batch.
+const Vector2 whiteTexel = {(ATLAS_SIZE - 8) / (float)ATLAS_SIZE, (ATLAS_SIZE - 8) / (float)ATLAS_SIZE};
+
+// Levels of detail for sprites.
+typedef enum
+{
+    LOD_NEAR,
+    LOD_FAR,
+    LOD_COUNT
+} SpriteLod;
+
+// Where each sprite is in the atlas, for each level of detail.
+static const Rectangle spriteSources[LOD_COUNT][OBJECT_COUNT] = {
+        // Near.
+        {{0, 0, 0, 0}, {0, 0, 64, 128}, {64, 0, 16, 64}, {128, 0, 64, 96}},
+        // Far.
+        {{0, 0, 0, 0}, {0, 128, 16, 32}, {16, 128, 4, 16}, {32, 128, 16, 24}}};
+
+// Where the car sprite is in the atlas, for each level of detail. It's white, so that it can be tinted.
+static const Rectangle carSources[LOD_COUNT] = {{192, 0, 64, 40}, {48, 128, 16, 10}};
+
+// How big each sprite is, in world units.
+static const Vector2 spriteSizes[OBJECT_COUNT] = {{0, 0}, {700, 1400}, {100, 400}, {500, 750}};
+
+static const TrackSegment* GetSegment(const TrackView* view, int index)
+{
+    return &view->segments[index & view->mask];
+}
+
+static void AddVertex(TrackVertex** v, Vector2 pos, Vector2 uv, Color colour)
+{
+    *(*v)++ = (TrackVertex){pos, uv, colour};
+}
+
+// Add a quad as two triangles, wound the same way as DrawTriangle() expects.
+static void AddQuad(TrackVertex** v, Vector2 tl, Vector2 tr, Vector2 br, Vector2 bl, Color color)
+{
+    AddVertex(v, tl, whiteTexel, color);
+    AddVertex(v, bl, whiteTexel, color);
+    AddVertex(v, tr, whiteTexel, color);
+    AddVertex(v, tr, whiteTexel, color);
+    AddVertex(v, bl, whiteTexel, color);
+    AddVertex(v, br, whiteTexel, color);
+}
+
+// Add a sprite from the atlas.
+static void AddSprite(TrackVertex** v, Rectangle dest, Rectangle source, Color tint)
+{
+    const float left = source.x / ATLAS_SIZE;
+    const float right = (source.x + source.width) / ATLAS_SIZE;
+    const float top = source.y / ATLAS_SIZE;
+    const float bottom = (source.y + source.height) / ATLAS_SIZE;
+    const Vector2 tl = {dest.x, dest.y};
+    const Vector2 tr = {dest.x + dest.width, dest.y};
+    const Vector2 br = {dest.x + dest.width, dest.y + dest.height};
+    const Vector2 bl = {dest.x, dest.y + dest.height};
+    AddVertex(v, tl, (Vector2){left, top}, tint);
+    AddVertex(v, bl, (Vector2){left, bottom}, tint);
+    AddVertex(v, tr, (Vector2){right, top}, tint);
+    AddVertex(v, tr, (Vector2){right, top}, tint);
+    AddVertex(v, bl, (Vector2){left, bottom}, tint);
+    AddVertex(v, br, (Vector2){right, bottom}, tint);
+}
+
+// Project the near edges of segments [start + 1, end + 1) in batches. Each one only depends on its own segment.
+static void ProjectTrackSegments(void* data, int start, int end)
+{
+    TrackView* view = data;
+    float x[PROJECT_BATCH];
+    float y[PROJECT_BATCH];
+    for (int first = start + 1; first <= end; first += PROJECT_BATCH)
+    {
+        const int count = end + 1 - first < PROJECT_BATCH ? end + 1 - first : PROJECT_BATCH;
+        for (int i = 0; i < count; i++)
+        {
+            const TrackSegment* segment = GetSegment(view, view->base + first + i);
+            x[i] = segment->offset;
+            y[i] = segment->height;
+        }
+        ComputePseudoScales(&view->camera, (float)first, 1.0f, count, &view->scales[first]);
+        ProjectPseudoPoints(&view->camera, count, &view->scales[first], x, y, &view->screenX[first], &view->screenY[first]);
+    }
+}
+
+// Build the geometry for segments [start + 1, end + 1) into their slots. A segment's road runs from the near edge of the segment
+// behind it to its own near edge, so all of the segments must have been projected first.
+static void BuildTrackSegments(void* data, int start, int end)
+{
+    TrackView* view = data;
+    const PseudoCamera* camera = &view->camera;
+    for (int s = start + 1; s <= end; s++)
+    {
+        const int slot = view->drawDistance - s;
+        TrackVertex* first = &view->slots[slot * SEGMENT_VERTICES];
+        TrackVertex* v = first;
+
+        const TrackSegment* segment = GetSegment(view, view->base + s);
+        const float x = view->screenX[s];
+        const float y = view->screenY[s];
+        const float scale = view->scales[s];
+        if (s != view->drawDistance)
+        {
+            const TrackSegment* behind = GetSegment(view, view->base + s + 1);
+            const float fx = view->screenX[s + 1];
+            const float fy = view->screenY[s + 1];
+            const float fw = GetPseudoSize(camera, view->scales[s + 1], behind->width);
+            const float fwi = fw * 0.875f;
+            const float w = GetPseudoSize(camera, scale, segment->width);
+            const float wi = w * 0.875f;
+            const Vector2 tl = {fx - fw, fy};
+            const Vector2 tr = {fx + fw, fy};
+            const Vector2 tli = {fx - fwi, fy - 1};
+            const Vector2 tri = {fx + fwi, fy - 1};
+            const Vector2 bl = {x - w, y};
+            const Vector2 br = {x + w, y};
+            const Vector2 bli = {x - wi, y};
+            const Vector2 bri = {x + wi, y};
+            const bool j = (view->base + s) % view->length % 10 < 5;
+            AddQuad(&v, tl, tli, bli, bl, j ? WHITE : RED);
+            AddQuad(&v, tri, tr, br, bri, j ? WHITE : RED);
+            AddQuad(&v, tli, tri, bri, bli, j ? DARKGRAY : GRAY);
+        }
+
+        // Add the segment's sprite after its road, so that the road in front of it, including any hills, is drawn over it.
+        if (segment->object != OBJECT_NONE && s <= SPRITE_DRAW_DISTANCE)
+        {
+            const Vector2 size = spriteSizes[segment->object];
+            const float sw = GetPseudoSize(camera, scale, size.x);
+            const float sh = GetPseudoSize(camera, scale, size.y);
+            if (sh >= 1.0f)
+            {
+                const float sx = x + GetPseudoSize(camera, scale, segment->objectX * segment->width);
+                const SpriteLod lod = s > SPRITE_LOD_DISTANCE ? LOD_FAR : LOD_NEAR;
+                AddSprite(&v, (Rectangle){sx - sw / 2, y - sh, sw, sh}, spriteSources[lod][segment->object], WHITE);
+            }
+        }
+
+        view->slotCounts[slot] = (int)(v - first);
+    }
+}
+
+// Build the sprites for cars [start, end) into their slots. A car is somewhere between the near edges of two segments, so it's
+// placed on the road between them.
+static void BuildTrackCars(void* data, int start, int end)
+{
+    TrackView* view = data;
+    const PseudoCamera* camera = &view->camera;
+    for (int i = start; i < end; i++)
+    {
+        const TrackCar* car = &view->cars[i];
+        TrackVertex* first = &view->carSlots[i * SPRITE_VERTICES];
+        TrackVertex* v = first;
+
+        const int s = (int)car->distance;
+        const float t = car->distance - (float)s;
+        const float scale = GetPseudoScale(camera, car->distance);
+        const float w = GetPseudoSize(camera, scale, CAR_WIDTH);
+        const float h = GetPseudoSize(camera, scale, CAR_HEIGHT);
+        if (h >= 1.0f)
+        {
+            const float x = Lerp(view->screenX[s], view->screenX[s + 1], t) + GetPseudoSize(camera, scale, car->x);
+            const float y = Lerp(view->screenY[s], view->screenY[s + 1], t);
+            const SpriteLod lod = s > SPRITE_LOD_DISTANCE ? LOD_FAR : LOD_NEAR;
+            AddSprite(&v, (Rectangle){x - w / 2, y - h, w, h}, carSources[lod], car->tint);
+        }
+
+        view->carSlotCounts[i] = (int)(v - first);
+    }
+}
+
+int BuildTrackGeometry(TrackView* view, TrackVertex* vertices, int* sprites)
+{
+    ParallelFor(view->drawDistance, SEGMENT_GRAIN, ProjectTrackSegments, view);
+    ParallelFor(view->drawDistance, SEGMENT_GRAIN, BuildTrackSegments, view);
+    ParallelFor(view->carCount, SEGMENT_GRAIN, BuildTrackCars, view);
+
+    // Merge the slots in order, furthest first, so that nearer segments are drawn over further ones. Each car goes in after the
+    // segment that it's on.
+    int count = 0;
+    int car = view->carCount - 1;
+    *sprites = 0;
+    view->carsDrawn = 0;
+    for (int slot = 0; slot < view->drawDistance; slot++)
+    {
+        const int n = view->slotCounts[slot];
+        memcpy(&vertices[count], &view->slots[slot * SEGMENT_VERTICES], (size_t)n * sizeof(TrackVertex));
+        count += n;
+        if (n % ROAD_VERTICES == SPRITE_VERTICES)
+        {
+            ++*sprites;
+        }
+
+        const int s = view->drawDistance - slot;
+        for (; car >= 0 && (int)view->cars[car].distance >= s; car--)
+        {
+            const int m = view->carSlotCounts[car];
+            memcpy(&vertices[count], &view->carSlots[car * SPRITE_VERTICES], (size_t)m * sizeof(TrackVertex));
+            count += m;
+            view->carsDrawn += m / SPRITE_VERTICES;
+        }
+    }
+
+    return count;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "bdr/camera.h"
+#include "raylib.h"
+#include "track.h"
+
+#define ATLAS_SIZE 256
+#define SPRITE_DRAW_DISTANCE 200 // Sprites further away than this many segments aren't drawn.
+#define SPRITE_LOD_DISTANCE 60   // Sprites further away than this many segments are drawn with less detail.
+#define CAR_WIDTH 800.0f         // How wide a car is, in world units.
+#define CAR_HEIGHT 500.0f        // How tall a car is, in world units.
+
+#define ROAD_VERTICES 18                                   // Two kerbs and the road, as two triangles each.
+#define SPRITE_VERTICES 6                                  // A sprite, as two triangles.
+#define SEGMENT_VERTICES (ROAD_VERTICES + SPRITE_VERTICES) // The most vertices that a segment can add to the track mesh.
+#define SEGMENT_GRAIN 64                                   // How many segments a worker takes at a time.
+#define PROJECT_BATCH 64                                   // How many segments are projected together.
+
+// A vertex in the track mesh.
+typedef struct
+{
+    Vector2 pos;
+    Vector2 uv;
+    Color colour;
+} TrackVertex;
+
+// A car that the camera can see.
+typedef struct
+{
+    float distance; // How far in front of the camera's segment is it, in segments? At least 1, and less than the draw distance.
+    float x;        // How far left or right of the centre line is it, in world units?
+    Color tint;     // What colour is it?
+} TrackCar;
+
+// What the camera can see, and where to put the geometry for it.
+//
+// The segments' near edges are projected in batches. Then each segment is built into its own slot of vertices, so segments can be
+// built in any order on any thread. The slots are then copied into the track mesh from the furthest to the nearest, so the mesh is
+// the same however many threads built it.
+typedef struct
+{
+    const TrackSegment* segments; // A ring buffer of segments, keyed by their index on the track.
+    int mask;                     // The ring buffer's size - 1. Its size must be a power of two.
+    int base;                     // The index of the segment that the camera is on.
+    PseudoCamera camera;          // The camera. Its z is relative to the base segment, and is in segments.
+    int length;                   // How many segments are there in a lap?
+    int drawDistance;             // How many segments can the camera see?
+    float* scales;                // The scale of each segment, indexed by distance. Needs drawDistance + 1 entries.
+    float* screenX;               // Where the centre of the road is at each segment's near edge. The same size as scales.
+    float* screenY;               // Where the road is at each segment's near edge. The same size as scales.
+    TrackVertex* slots;           // Vertices for each segment, furthest first. Needs drawDistance * SEGMENT_VERTICES entries.
+    int* slotCounts;              // How many vertices each segment added. Needs drawDistance entries.
+    const TrackCar* cars;         // The cars in view, nearest first.
+    int carCount;                 // How many cars are in view?
+    TrackVertex* carSlots;        // Vertices for each car. Needs carCount * SPRITE_VERTICES entries.
+    int* carSlotCounts;           // How many vertices each car added. Needs carCount entries.
+    int carsDrawn;                // How many cars were big enough to draw?
+} TrackView;
+
+extern const Vector2 whiteTexel;
+
+// Build the track mesh for a view, splitting the work between the worker pool. Returns the number of vertices, which is at most
+// drawDistance * SEGMENT_VERTICES + carCount * SPRITE_VERTICES.
+int BuildTrackGeometry(TrackView* view, TrackVertex* vertices, int* sprites);
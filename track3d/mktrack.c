@@ -0,0 +1,73 @@
+// Builds a track file for track3d.
+//
+// Usage: mktrack <output.trk> [segments]
+//
+// The track is the same one that track3d generates when it doesn't have a track file, but it can be made as long as you like.
+
+#include "track.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static void WriteU32(FILE* f, unsigned int value)
+{
+    const unsigned char bytes[4] = {(unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16),
+                                    (unsigned char)(value >> 24)};
+    fwrite(bytes, 1, sizeof(bytes), f);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "Usage: %s <output.trk> [segments]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const char* output = argv[1];
+    const int length = argc == 3 ? atoi(argv[2]) : TRACK_DEFAULT_LENGTH;
+    if (length <= 0)
+    {
+        fprintf(stderr, "mktrack: invalid segment count %s\n", argv[2]);
+        return EXIT_FAILURE;
+    }
+
+    FILE* out = fopen(output, "wb");
+    if (out == NULL)
+    {
+        fprintf(stderr, "mktrack: cannot write %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    // Header.
+    fwrite(TRACK_MAGIC, 1, 4, out);
+    WriteU32(out, TRACK_VERSION);
+    WriteU32(out, (unsigned int)length);
+    WriteU32(out, 0);
+
+    // Segments.
+    for (int i = 0; i < length; i++)
+    {
+        TrackSegment segment;
+        unsigned char bytes[TRACK_SEGMENT_SIZE];
+        GenerateTrackSegment(i, length, &segment);
+        if (!EncodeTrackSegment(&segment, bytes))
+        {
+            fprintf(stderr, "mktrack: segment %d doesn't fit in a track file\n", i);
+            fclose(out);
+            remove(output);
+            return EXIT_FAILURE;
+        }
+        fwrite(bytes, 1, sizeof(bytes), out);
+    }
+
+    if (fclose(out) != 0)
+    {
+        fprintf(stderr, "mktrack: failed to write %s\n", output);
+        return EXIT_FAILURE;
+    }
+
+    printf("mktrack: wrote %d segments to %s\n", length, output);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+#include "track.h"
+#include "raylib.h"
+
+#include <math.h>
+#include <string.h>
+
+static unsigned int ReadU32(const unsigned char* bytes)
+{
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) | ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+}
+
+static int ReadS16(const unsigned char* bytes)
+{
+    const int value = (int)bytes[0] | ((int)bytes[1] << 8);
+    return value >= 0x8000 ? value - 0x10000 : value;
+}
+
+static int ReadU16(const unsigned char* bytes)
+{
+    return (int)bytes[0] | ((int)bytes[1] << 8);
+}
+
+static void WriteU16(unsigned char* bytes, int value)
+{
+    bytes[0] = (unsigned char)(value & 0xff);
+    bytes[1] = (unsigned char)((value >> 8) & 0xff);
+}
+
+static void WriteS16(unsigned char* bytes, int value)
+{
+    WriteU16(bytes, value);
+}
+
+// Round a value to the nearest whole number in [min, max], and note whether it was already in range.
+static int Quantise(float value, int min, int max, bool* inRange)
+{
+    const float rounded = roundf(value);
+    if (!(rounded >= (float)min && rounded <= (float)max))
+    {
+        *inRange = false;
+        return rounded > (float)max ? max : min;
+    }
+    return (int)rounded;
+}
+
+bool OpenTrack(Track* track, const char* fileName)
+{
+    track->file = NULL;
+    track->length = TRACK_DEFAULT_LENGTH;
+    track->pageLoads = 0;
+    for (int i = 0; i < TRACK_PAGES; i++)
+    {
+        track->pages[i].index = -1;
+    }
+
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL)
+    {
+        TraceLog(LOG_WARNING, "TRACK: [%s] Failed to open track, generating one instead", fileName);
+        return false;
+    }
+
+    unsigned char header[TRACK_HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) || memcmp(header, TRACK_MAGIC, 4) != 0 ||
+        ReadU32(header + 4) != TRACK_VERSION || ReadU32(header + 8) == 0)
+    {
+        TraceLog(LOG_WARNING, "TRACK: [%s] Not a track file, generating one instead", fileName);
+        fclose(file);
+        return false;
+    }
+
+    track->file = file;
+    track->length = (int)ReadU32(header + 8);
+    TraceLog(LOG_INFO, "TRACK: [%s] Track opened successfully (%d segments)", fileName, track->length);
+
+    return true;
+}
+
+void CloseTrack(Track* track)
+{
+    if (track->file != NULL)
+    {
+        fclose(track->file);
+        track->file = NULL;
+    }
+}
+
+// Make sure that the given page is in memory, reading it from the file if it isn't.
+static const TrackPage* LoadTrackPage(Track* track, int index)
+{
+    TrackPage* page = &track->pages[index % TRACK_PAGES];
+    if (page->index == index)
+    {
+        return page;
+    }
+
+    const int first = index * TRACK_PAGE_SEGMENTS;
+    const int count = track->length - first < TRACK_PAGE_SEGMENTS ? track->length - first : TRACK_PAGE_SEGMENTS;
+    const long offset = TRACK_HEADER_SIZE + (long)first * TRACK_SEGMENT_SIZE;
+    const size_t size = (size_t)count * TRACK_SEGMENT_SIZE;
+    if (fseek(track->file, offset, SEEK_SET) != 0 || fread(page->data, 1, size, track->file) != size)
+    {
+        TraceLog(LOG_WARNING, "TRACK: Failed to read page %d", index);
+        memset(page->data, 0, sizeof(page->data));
+    }
+    page->index = index;
+    ++track->pageLoads;
+
+    return page;
+}
+
+void GetTrackSegment(Track* track, int index, TrackSegment* segment)
+{
+    index %= track->length;
+    if (track->file == NULL)
+    {
+        GenerateTrackSegment(index, track->length, segment);
+        return;
+    }
+
+    const TrackPage* page = LoadTrackPage(track, index / TRACK_PAGE_SEGMENTS);
+    DecodeTrackSegment(&page->data[(index % TRACK_PAGE_SEGMENTS) * TRACK_SEGMENT_SIZE], segment);
+}
+
+// The original track3d track: hills and bends that repeat a whole number of times per lap, with something beside the road every
+// eighth segment.
+void GenerateTrackSegment(int index, int length, TrackSegment* segment)
+{
+    const int hills = length / 63 > 0 ? length / 63 : 1;
+    const int bends = length / 315 > 0 ? length / 315 : 1;
+    const float lap = 2 * PI * (float)index / (float)length;
+    segment->offset = cosf(lap * (float)bends) * 1000;
+    segment->height = sinf(lap * (float)hills) * 500;
+    segment->width = 2000;
+    segment->object = index % 8 == 0 ? (RoadsideObject)(1 + (index / 8) % (OBJECT_COUNT - 1)) : OBJECT_NONE;
+    segment->objectX = (index / 8) % 2 == 0 ? -1.5f : 1.5f;
+}
+
+// Positions are stored to the nearest world unit, and object positions to the nearest 1/16th of a road width. Anything that doesn't
+// fit is clamped to the nearest value that does, and we return false so that the caller can refuse to write a track that isn't
+// what it asked for.
+bool EncodeTrackSegment(const TrackSegment* segment, unsigned char* bytes)
+{
+    bool inRange = (int)segment->object >= 0 && (int)segment->object < OBJECT_COUNT;
+    bytes[6] = (unsigned char)(inRange ? segment->object : OBJECT_NONE);
+    WriteS16(bytes + 0, Quantise(segment->offset, -32768, 32767, &inRange));
+    WriteS16(bytes + 2, Quantise(segment->height, -32768, 32767, &inRange));
+    WriteU16(bytes + 4, Quantise(segment->width, 0, 65535, &inRange));
+    bytes[7] = (unsigned char)(signed char)Quantise(segment->objectX * 16, -128, 127, &inRange);
+    return inRange;
+}
+
+void DecodeTrackSegment(const unsigned char* bytes, TrackSegment* segment)
+{
+    segment->offset = (float)ReadS16(bytes + 0);
+    segment->height = (float)ReadS16(bytes + 2);
+    segment->width = (float)ReadU16(bytes + 4);
+    segment->object = bytes[6] < OBJECT_COUNT ? (RoadsideObject)bytes[6] : OBJECT_NONE;
+    segment->objectX = (float)(signed char)bytes[7] / 16;
+}
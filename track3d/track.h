@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+
+// Track file layout. All integers are little-endian.
+//
+//   header    "BDRT", version (u32), segment count (u32), reserved (u32)
+//   segments  segment count * { offset (s16), height (s16), width (u16), object (u8), object position (s8) }
+//
+// A segment's offset is where the road's centre line is, i.e., the curvature up to that point has already been added up. That
+// means that any segment can be read on its own, so the track can be paged in from anywhere.
+#define TRACK_MAGIC "BDRT"
+#define TRACK_VERSION 1
+#define TRACK_HEADER_SIZE 16
+#define TRACK_SEGMENT_SIZE 8
+
+#define TRACK_PAGE_SEGMENTS 256 // Segments per page.
+#define TRACK_PAGES 4           // Pages held in memory. Enough to cover the draw distance, whatever the length of the track.
+#define TRACK_DEFAULT_LENGTH 8192
+
+// Things that can be placed beside the road.
+typedef enum
+{
+    OBJECT_NONE,
+    OBJECT_TREE,
+    OBJECT_POST,
+    OBJECT_SIGN,
+    OBJECT_COUNT
+} RoadsideObject;
+
+// A segment of the track, which only depends on where it is on the track, not on where the camera is.
+typedef struct
+{
+    float offset;          // How far left or right is the road?
+    float height;          // How high is the road?
+    float width;           // How wide is the road, from the centre line to the outside of the kerb?
+    RoadsideObject object; // What is beside the road?
+    float objectX;         // Where is it, in road widths from the centre line? Negative is left.
+} TrackSegment;
+
+// A page of segments, as read from the file.
+typedef struct
+{
+    int index; // Which page is this, or -1 if it's empty?
+    unsigned char data[TRACK_PAGE_SEGMENTS * TRACK_SEGMENT_SIZE];
+} TrackPage;
+
+// A track that is streamed from a file, a page at a time. Without a file, its segments are generated as they're needed.
+typedef struct
+{
+    FILE* file;                   // The track file, or NULL if the track is generated.
+    int length;                   // How many segments are there in a lap?
+    int pageLoads;                // How many pages have been read so far?
+    TrackPage pages[TRACK_PAGES]; // The pages in memory. Page n lives in slot n % TRACK_PAGES.
+} Track;
+
+bool OpenTrack(Track* track, const char* fileName);
+void CloseTrack(Track* track);
+void GetTrackSegment(Track* track, int index, TrackSegment* segment);
+void GenerateTrackSegment(int index, int length, TrackSegment* segment);
+bool EncodeTrackSegment(const TrackSegment* segment, unsigned char* bytes);
+void DecodeTrackSegment(const unsigned char* bytes, TrackSegment* segment);
@@ -0,0 +1,401 @@
+#define BDR_CAMERA_IMPLEMENTATION
+#define BDR_LAYERS_IMPLEMENTATION
+#define BDR_LOOP_IMPLEMENTATION
+#define BDR_SCALING_IMPLEMENTATION
+#define BDR_THREADS_IMPLEMENTATION
+#include "bdr/camera.h"
+#include "bdr/layers.h"
+#include "bdr/loop.h"
+#include "bdr/scaling.h"
+#include "bdr/threads.h"
+#include "car.h"
+#include "geometry.h"
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+#include "track.h"
+#include "traffic.h"
+
+#include <math.h>
+
+#define UPDATE_FPS 60
+
+#define SLOW_FPS 60
+#define FAST_FPS 240
+#define SCREEN_WIDTH 1280
+#define SCREEN_HEIGHT 720
+
+#define VIRTUAL_WIDTH (SCREEN_WIDTH / 2)
+#define VIRTUAL_HEIGHT (SCREEN_HEIGHT / 2)
+#define HALF_WIDTH (VIRTUAL_WIDTH / 2)
+#define HALF_HEIGHT (VIRTUAL_HEIGHT / 2)
+
+#define HORIZON (VIRTUAL_HEIGHT / 4)
+
+#define CAMERA_DEPTH 0.003f   // The scale at a distance of one segment.
+#define CAMERA_HEIGHT 1250.0f // How high the camera is, in world units.
+
+#define MAX_SEGMENTS 300
+#define SEGMENT_CACHE_SIZE 512                 // A power of two that's larger than MAX_SEGMENTS.
+#define MAX_VISIBLE_CARS 1024                  // The most cars that can be drawn.
+#define CAR_DRAW_DISTANCE SPRITE_DRAW_DISTANCE // Cars further away than this many segments aren't drawn.
+#define MAX_BATCH_VERTICES (3 * 1024)          // Small enough to fit into raylib's render batch on any platform.
+
+// Enough vertices for every segment, and every car in view.
+#define MAX_TRACK_VERTICES (SEGMENT_VERTICES * MAX_SEGMENTS + SPRITE_VERTICES * MAX_VISIBLE_CARS)
+
+#define DEFAULT_TRAFFIC 512
+#define TRAFFIC_STEP 256
+
+Track track;
+StaticLayer backgroundLayer; // The sky and the grass.
+
+Car car;
+bool autopilot = true; // Is the car driving itself?
+int renderFps = FAST_FPS;
+
+Traffic traffic;
+double trafficUpdateTime = 0.0; // How long the traffic takes to update, smoothed over recent updates.
+// Red, blue, yellow and purple.
+const Color trafficColours[TRAFFIC_TYPES] = {{230, 41, 55, 255}, {0, 121, 241, 255}, {253, 249, 0, 255}, {200, 122, 255, 255}};
+
+// A ring buffer of segments, keyed by their index on the track. Segments [cacheStart, cacheEnd) are in the cache.
+TrackSegment segmentCache[SEGMENT_CACHE_SIZE];
+int cacheStart = 0;
+int cacheEnd = 0;
+int segmentsComputed = 0;
+
+float segmentScales[MAX_SEGMENTS + 1];
+float segmentScreenX[MAX_SEGMENTS + 1];
+float segmentScreenY[MAX_SEGMENTS + 1];
+TrackVertex segmentSlots[SEGMENT_VERTICES * MAX_SEGMENTS];
+int segmentSlotCounts[MAX_SEGMENTS];
+TrackCar visibleCars[MAX_VISIBLE_CARS];
+TrackVertex carSlots[SPRITE_VERTICES * MAX_VISIBLE_CARS];
+int carSlotCounts[MAX_VISIBLE_CARS];
+int visibleCarCount = 0;
+TrackVertex trackVertices[MAX_TRACK_VERTICES];
+int trackVertexCount = 0;
+int trackDrawCalls = 0;
+int spritesDrawn = 0;
+
+// Everything is drawn from one texture atlas, so it all goes into one batch.
+Texture2D atlas;
+
+// Generate the sprite atlas. The far sprites are simpler versions of the near ones rather than scaled down copies of them.
+Texture2D GenerateAtlas(void)
+{
+    Image image = GenImageColor(ATLAS_SIZE, ATLAS_SIZE, BLANK);
+
+    // A white block for the road, big enough that filtering can't pull in its neighbours.
+    ImageDrawRectangle(&image, ATLAS_SIZE - 16, ATLAS_SIZE - 16, 16, 16, WHITE);
+
+    // Near sprites.
+    ImageDrawRectangle(&image, 26, 80, 12, 48, BROWN);
+    ImageDrawCircle(&image, 32, 64, 26, DARKGREEN);
+    ImageDrawCircle(&image, 32, 36, 22, GREEN);
+    ImageDrawCircle(&image, 32, 14, 13, LIME);
+    ImageDrawRectangle(&image, 64, 0, 16, 64, RAYWHITE);
+    ImageDrawRectangle(&image, 64, 8, 16, 8, RED);
+    ImageDrawRectangle(&image, 156, 48, 8, 48, GRAY);
+    ImageDrawRectangle(&image, 128, 0, 64, 48, DARKBLUE);
+    ImageDrawRectangle(&image, 132, 4, 56, 40, GOLD);
+    ImageDrawRectangle(&image, 140, 20, 40, 8, DARKBLUE);
+    ImageDrawRectangle(&image, 196, 30, 12, 10, BLACK);
+    ImageDrawRectangle(&image, 240, 30, 12, 10, BLACK);
+    ImageDrawRectangle(&image, 204, 0, 40, 14, WHITE);
+    ImageDrawRectangle(&image, 208, 3, 32, 9, DARKGRAY);
+    ImageDrawRectangle(&image, 192, 12, 64, 22, WHITE);
+    ImageDrawRectangle(&image, 196, 16, 10, 5, LIGHTGRAY);
+    ImageDrawRectangle(&image, 242, 16, 10, 5, LIGHTGRAY);
+
+    // Far sprites.
+    ImageDrawRectangle(&image, 6, 152, 4, 8, BROWN);
+    ImageDrawRectangle(&image, 0, 128, 16, 24, DARKGREEN);
+    ImageDrawRectangle(&image, 16, 128, 4, 16, RAYWHITE);
+    ImageDrawRectangle(&image, 38, 140, 4, 12, GRAY);
+    ImageDrawRectangle(&image, 32, 128, 16, 12, GOLD);
+    ImageDrawRectangle(&image, 49, 136, 3, 2, BLACK);
+    ImageDrawRectangle(&image, 60, 136, 3, 2, BLACK);
+    ImageDrawRectangle(&image, 51, 128, 10, 3, WHITE);
+    ImageDrawRectangle(&image, 48, 131, 16, 5, WHITE);
+
+    Texture2D texture = LoadTextureFromImage(image);
+    UnloadImage(image);
+
+    return texture;
+}
+
+// Make sure that segments first to last are in the cache, computing only the ones that weren't already there.
+void CacheSegments(int first, int last)
+{
+    if (first + track.length / 2 < cacheStart)
+    {
+        // The camera started the next lap. The cache can be kept if its segments stay in the same slots, otherwise it starts again.
+        cacheStart -= track.length;
+        cacheEnd -= track.length;
+        if (track.length % SEGMENT_CACHE_SIZE != 0)
+        {
+            cacheEnd = cacheStart;
+        }
+    }
+
+    if (first < cacheStart || first > cacheEnd)
+    {
+        // The camera jumped, so start again.
+        cacheEnd = first;
+    }
+    cacheStart = first;
+
+    segmentsComputed = 0;
+    for (; cacheEnd <= last; cacheEnd++)
+    {
+        GetTrackSegment(&track, cacheEnd, &segmentCache[cacheEnd & (SEGMENT_CACHE_SIZE - 1)]);
+        ++segmentsComputed;
+    }
+}
+
+// Submit the whole track mesh to the render batch. It's all triangles from the same texture, so it's drawn with a single draw call
+// unless it overflows the batch.
+void SubmitTrackMesh(void)
+{
+    trackDrawCalls = 1;
+    for (int start = 0; start < trackVertexCount; start += MAX_BATCH_VERTICES)
+    {
+        const int end = start + MAX_BATCH_VERTICES < trackVertexCount ? start + MAX_BATCH_VERTICES : trackVertexCount;
+        if (rlCheckRenderBatchLimit(end - start))
+        {
+            ++trackDrawCalls;
+        }
+        rlSetTexture(atlas.id);
+        rlBegin(RL_TRIANGLES);
+        for (int i = start; i < end; i++)
+        {
+            const TrackVertex* v = &trackVertices[i];
+            rlColor4ub(v->colour.r, v->colour.g, v->colour.b, v->colour.a);
+            rlTexCoord2f(v->uv.x, v->uv.y);
+            rlVertex2f(v->pos.x, v->pos.y);
+        }
+        rlEnd();
+        rlSetTexture(0);
+    }
+}
+
+// Get the segments behind, under and ahead of the car.
+void GetCarRoad(TrackSegment road[3])
+{
+    const int index = (int)car.z;
+    for (int i = 0; i < 3; i++)
+    {
+        GetTrackSegment(&track, (index + i - 1 + track.length) % track.length, &road[i]);
+    }
+}
+
+void FixedUpdate(void)
+{
+    TrackSegment road[3];
+    GetCarRoad(road);
+
+    CarControls controls;
+    if (autopilot)
+    {
+        controls = GetAutopilotControls(&car, road);
+    }
+    else
+    {
+        controls.steer = (IsKeyDown(KEY_RIGHT) ? 1.0f : 0.0f) - (IsKeyDown(KEY_LEFT) ? 1.0f : 0.0f);
+        controls.throttle = IsKeyDown(KEY_UP) ? 1.0f : 0.0f;
+        controls.brake = IsKeyDown(KEY_DOWN);
+    }
+    UpdateCar(&car, &controls, road, track.length, (float)GetUpdateInterval());
+
+    const double start = GetTime();
+    UpdateTraffic(&traffic, (float)GetUpdateInterval());
+    trafficUpdateTime += (GetTime() - start - trafficUpdateTime) * 0.05;
+}
+
+void Update(double elapsed)
+{
+    (void)elapsed;
+}
+
+void CheckTriggers(void)
+{
+    // Take the wheel from the autopilot, or give it back.
+    if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_RIGHT))
+    {
+        autopilot = false;
+    }
+    if (IsKeyPressed(KEY_SPACE))
+    {
+        autopilot = !autopilot;
+    }
+
+    if (IsKeyPressed(KEY_F10))
+    {
+        renderFps = (renderFps == FAST_FPS) ? SLOW_FPS : FAST_FPS;
+        SetTargetFPS(renderFps);
+    }
+
+    // Add or remove traffic.
+    if (IsKeyPressed(KEY_EQUAL) || IsKeyPressed(KEY_KP_ADD))
+    {
+        InitTraffic(&traffic, traffic.count + TRAFFIC_STEP, track.length);
+    }
+    if ((IsKeyPressed(KEY_MINUS) || IsKeyPressed(KEY_KP_SUBTRACT)) && traffic.count > 0)
+    {
+        InitTraffic(&traffic, traffic.count - TRAFFIC_STEP > 0 ? traffic.count - TRAFFIC_STEP : 0, track.length);
+    }
+
+    // Toggle dynamic resolution, going back to the original half resolution when it's off.
+    if (IsKeyPressed(KEY_F8))
+    {
+        EnableDynamicResolution(!IsDynamicResolutionEnabled());
+        SetRenderScale(0.5f);
+    }
+}
+
+// Find the cars between the given distances in front of the camera's segment, nearest first. Only the cars in that range are
+// looked at, and as the cars are sorted, they're found with a binary search.
+void FindVisibleCars(int base, float near, float far, float dt)
+{
+    visibleCarCount = 0;
+    const float length = (float)track.length;
+    for (float lap = 0.0f; lap <= length; lap += length)
+    {
+        // The range can run on into the next lap.
+        const float from = (float)base + near - lap;
+        const float to = (float)base + far - lap;
+        if (to < 0.0f)
+        {
+            break;
+        }
+        for (int i = FindTraffic(&traffic, from); i < traffic.count && traffic.z[i] < to; i++)
+        {
+            // Interpolate the car's position as we do the camera's. Cars that have moved out of range are left out.
+            const float distance = traffic.z[i] + traffic.speed[i] * dt + lap - (float)base;
+            if (distance < near || distance >= far || visibleCarCount == MAX_VISIBLE_CARS)
+            {
+                continue;
+            }
+
+            // Keep them in order, as interpolating them may have swapped neighbours.
+            int j = visibleCarCount++;
+            for (; j > 0 && visibleCars[j - 1].distance > distance; j--)
+            {
+                visibleCars[j] = visibleCars[j - 1];
+            }
+            visibleCars[j] = (TrackCar){distance, traffic.x[i], trafficColours[traffic.type[i]]};
+        }
+    }
+}
+
+void DrawTrack(Vector2 a, Vector2 b, double alpha)
+{
+    // The sky and grass never change, so they're drawn once and then copied. That also saves clearing the screen.
+    if (BeginStaticLayer(&backgroundLayer, VIRTUAL_WIDTH, VIRTUAL_HEIGHT))
+    {
+        DrawRectangleV(a, (Vector2){b.x - a.x, HORIZON}, SKYBLUE);
+        DrawRectangleV((Vector2){a.x, a.y + HORIZON}, (Vector2){b.x - a.x, b.y - a.y - HORIZON}, DARKGREEN);
+        EndStaticLayer(&backgroundLayer);
+    }
+
+    BeginDrawing();
+    BeginScaledDrawing();
+    DrawStaticLayer(&backgroundLayer, (Rectangle){a.x, a.y, b.x - a.x, b.y - a.y});
+
+    // Interpolate the camera's position with the car's velocity to reduce stutter.
+    const float dt = (float)(GetUpdateInterval() * alpha);
+    float cz = car.z + car.speed * dt;
+    if (cz >= (float)track.length)
+    {
+        cz -= (float)track.length;
+    }
+    const float cx = car.x + car.vx * dt;
+
+    // The camera is between two segments, so the segments are a fraction of a segment closer than their index suggests.
+    const int base = (int)cz;
+    const float fraction = cz - (float)base;
+    CacheSegments(base + 1, base + MAX_SEGMENTS);
+
+    // The car's x is relative to the centre line, so the camera follows the road's offset between the segments that it's on.
+    TrackSegment here;
+    GetTrackSegment(&track, base, &here);
+    const float cameraX = Lerp(here.offset, segmentCache[(base + 1) & (SEGMENT_CACHE_SIZE - 1)].offset, fraction) + cx;
+
+    // Only the cars that are close enough to see are drawn.
+    FindVisibleCars(base, 1.0f, CAR_DRAW_DISTANCE, dt);
+
+    // Project the segments and build their geometry on the worker pool. Heights are drawn at twice their scale, which makes the
+    // hills steeper.
+    const PseudoCamera camera = {.position = {cameraX, CAMERA_HEIGHT, fraction},
+                                 .centre = {a.x + HALF_WIDTH, a.y + HORIZON},
+                                 .pixels = {HALF_WIDTH, 2 * HALF_HEIGHT},
+                                 .depth = CAMERA_DEPTH};
+    TrackView view = {.segments = segmentCache,
+                      .mask = SEGMENT_CACHE_SIZE - 1,
+                      .base = base,
+                      .camera = camera,
+                      .length = track.length,
+                      .drawDistance = MAX_SEGMENTS,
+                      .scales = segmentScales,
+                      .screenX = segmentScreenX,
+                      .screenY = segmentScreenY,
+                      .slots = segmentSlots,
+                      .slotCounts = segmentSlotCounts,
+                      .cars = visibleCars,
+                      .carCount = visibleCarCount,
+                      .carSlots = carSlots,
+                      .carSlotCounts = carSlotCounts};
+    trackVertexCount = BuildTrackGeometry(&view, trackVertices, &spritesDrawn);
+    SubmitTrackMesh();
+    EndScaledDrawing();
+    DrawFPS(4, 4);
+    DrawText(TextFormat("%d triangles, %d draw call(s)", trackVertexCount / 3, trackDrawCalls), 4, 24, 20, LIME);
+    DrawText(TextFormat("%d new segment(s), %d page load(s)", segmentsComputed, track.pageLoads), 4, 44, 20, LIME);
+    DrawText(TextFormat("%d sprite(s), %d worker(s)", spritesDrawn, GetWorkerCount()), 4, 64, 20, LIME);
+    const char* dynamic = IsDynamicResolutionEnabled() ? " (dynamic)" : "";
+    DrawText(TextFormat("Render scale %.3f%s", GetRenderScale(), dynamic), 4, 84, 20, LIME);
+    const char* driver = autopilot ? "autopilot" : "player";
+    const char* surface = car.onRoad ? "" : ", off road";
+    DrawText(TextFormat("%.1f segments/s (%s%s)", car.speed, driver, surface), 4, 104, 20, LIME);
+    const double perCar = traffic.count > 0 ? trafficUpdateTime * 1e9 / traffic.count : 0.0;
+    DrawText(TextFormat("%d car(s), %d drawn, %.1f ns/car/update", traffic.count, view.carsDrawn, perCar), 4, 124, 20, LIME);
+    EndDrawing();
+}
+
+void Draw(double alpha)
+{
+    DrawTrack((Vector2){0, 0}, (Vector2){VIRTUAL_WIDTH, VIRTUAL_HEIGHT}, alpha);
+}
+
+int main()
+{
+    InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Racetrack");
+    SetTargetFPS(renderFps);
+    SetUpdateInterval(1.0 / UPDATE_FPS);
+
+    OpenTrack(&track, "assets/track.trk");
+    InitWorkerPool(-1);
+    atlas = GenerateAtlas();
+    InitStaticLayer(&backgroundLayer);
+    InitCar(&car, 0.0f);
+    InitTraffic(&traffic, DEFAULT_TRAFFIC, track.length);
+
+    // Draw at half resolution, or lower if we can't keep up.
+    SetScaledDrawingSize(VIRTUAL_WIDTH, VIRTUAL_HEIGHT);
+    SetRenderScaleRange(0.25f, 0.5f);
+    SetFrameBudget(1.0 / SLOW_FPS);
+    EnableDynamicResolution(true);
+
+    RunMainLoop();
+
+    UnloadRenderScaling();
+    UnloadStaticLayer(&backgroundLayer);
+    UnloadTexture(atlas);
+    CloseWorkerPool();
+    CloseTrack(&track);
+    CloseWindow();
+
+    return 0;
+}
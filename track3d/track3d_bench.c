@@ -0,0 +1,245 @@
+// Benchmarks track3d without opening a window.
+//
+// Usage: track3d_bench [frames]
+//
+// First it measures how geometry generation scales with the number of worker threads. For each draw distance, the same frames
+// are built with no workers, then with one more worker at a time up to one per spare processor. Every run's mesh is checked
+// against the one built without workers, because the merge must not depend on how the work was split up, and it fails if any of
+// them don't match.
+//
+// Then it drives the car on autopilot for the same length of time at different frame rates, on a simulated clock. The car must
+// end up in the same place whatever the frame rate, because its physics only runs in fixed updates.
+//
+// Finally it measures how much each AI car costs to update, for increasing amounts of traffic.
+
+#define BDR_BENCH_IMPLEMENTATION
+#define BDR_CAMERA_IMPLEMENTATION
+#define BDR_THREADS_IMPLEMENTATION
+#include "bdr/bench.h"
+#include "bdr/camera.h"
+#include "bdr/threads.h"
+#include "car.h"
+#include "geometry.h"
+#include "track.h"
+#include "traffic.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RING_SIZE 32768 // A power of two that's larger than the longest draw distance plus how far the camera moves.
+#define TRACK_LENGTH 65536
+#define DEFAULT_FRAMES 200
+
+#define UPDATE_FPS 60
+#define DRIVE_SECONDS 60
+#define DRIVE_DRAW_DISTANCE 300
+
+static const int drawDistances[] = {300, 1000, 4000, 16000};
+static const int renderFps[] = {30, 60, 144, 240};
+static const int trafficCounts[] = {256, 1024, 4096, 8192};
+
+static Traffic traffic;
+
+static TrackSegment segments[RING_SIZE];
+
+// The same camera as track3d's, for a 640x360 view.
+static PseudoCamera MakeCamera(float x, float fraction)
+{
+    return (PseudoCamera){.position = {x, 1250.0f, fraction}, .centre = {320, 90}, .pixels = {320, 360}, .depth = 0.003f};
+}
+
+// Build the given number of frames, moving the camera as track3d does. Returns the time per frame in seconds.
+static double BuildFrames(TrackView* view, int frames, TrackVertex* vertices, int* count)
+{
+    int sprites = 0;
+    float cz = 0.0f;
+    const double start = GetBenchTime();
+    for (int i = 0; i < frames; i++)
+    {
+        view->base = (int)cz;
+        view->camera = MakeCamera(0.0f, cz - (float)view->base);
+        *count = BuildTrackGeometry(view, vertices, &sprites);
+        cz += 0.5f;
+    }
+    return (GetBenchTime() - start) / frames;
+}
+
+static void GetCarRoad(const Car* car, TrackSegment road[3])
+{
+    const int index = (int)car->z;
+    for (int i = 0; i < 3; i++)
+    {
+        road[i] = segments[(index + i - 1 + TRACK_LENGTH) & (RING_SIZE - 1)];
+    }
+}
+
+// Drive for DRIVE_SECONDS at the given frame rate, running fixed updates the way bdr/loop.h does and building a frame after each
+// batch of them. Returns the time per frame in seconds.
+static double Drive(int fps, TrackView* view, TrackVertex* vertices, Car* car, int* updates)
+{
+    const double updateInterval = 1.0 / UPDATE_FPS;
+    const int frames = DRIVE_SECONDS * fps;
+    double accumulator = 0.0;
+    int sprites = 0;
+
+    InitCar(car, 0.0f);
+    *updates = 0;
+    const double start = GetBenchTime();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        accumulator += 1.0 / fps;
+        while (accumulator >= updateInterval)
+        {
+            TrackSegment road[3];
+            GetCarRoad(car, road);
+            const CarControls controls = GetAutopilotControls(car, road);
+            UpdateCar(car, &controls, road, TRACK_LENGTH, (float)updateInterval);
+            accumulator -= updateInterval;
+            ++*updates;
+        }
+
+        // Interpolate the camera, as track3d does.
+        const float dt = (float)accumulator;
+        const float cz = car->z + car->speed * dt;
+        view->base = (int)cz;
+        const float fraction = cz - (float)view->base;
+        const float here = segments[view->base & view->mask].offset;
+        const float next = segments[(view->base + 1) & view->mask].offset;
+        view->camera = MakeCamera(here + (next - here) * fraction + car->x + car->vx * dt, fraction);
+        BuildTrackGeometry(view, vertices, &sprites);
+    }
+    return (GetBenchTime() - start) / frames;
+}
+
+int main(int argc, char* argv[])
+{
+    const int frames = argc > 1 ? atoi(argv[1]) : DEFAULT_FRAMES;
+    if (frames <= 0 || argc > 2)
+    {
+        fprintf(stderr, "Usage: %s [frames]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    for (int i = 0; i < RING_SIZE; i++)
+    {
+        GenerateTrackSegment(i, TRACK_LENGTH, &segments[i]);
+    }
+
+    int maxWorkers = GetProcessorCount() - 1;
+    if (maxWorkers > BDR_THREADS_MAX_WORKERS)
+    {
+        maxWorkers = BDR_THREADS_MAX_WORKERS;
+    }
+    printf("%d processor(s), %d frame(s) per run\n", GetProcessorCount(), frames);
+    bool mismatched = false;
+
+    for (size_t d = 0; d < sizeof(drawDistances) / sizeof(drawDistances[0]); d++)
+    {
+        const int drawDistance = drawDistances[d];
+        const size_t maxVertices = (size_t)drawDistance * SEGMENT_VERTICES;
+        float* scales = malloc((size_t)(drawDistance + 1) * sizeof(float));
+        float* screenX = malloc((size_t)(drawDistance + 1) * sizeof(float));
+        float* screenY = malloc((size_t)(drawDistance + 1) * sizeof(float));
+        TrackVertex* slots = malloc(maxVertices * sizeof(TrackVertex));
+        int* slotCounts = malloc((size_t)drawDistance * sizeof(int));
+        TrackVertex* expected = malloc(maxVertices * sizeof(TrackVertex));
+        TrackVertex* vertices = malloc(maxVertices * sizeof(TrackVertex));
+        if (scales == NULL || screenX == NULL || screenY == NULL || slots == NULL || slotCounts == NULL || expected == NULL ||
+            vertices == NULL)
+        {
+            fprintf(stderr, "track3d_bench: out of memory\n");
+            return EXIT_FAILURE;
+        }
+
+        TrackView view = {.segments = segments,
+                          .mask = RING_SIZE - 1,
+                          .length = TRACK_LENGTH,
+                          .drawDistance = drawDistance,
+                          .scales = scales,
+                          .screenX = screenX,
+                          .screenY = screenY,
+                          .slots = slots,
+                          .slotCounts = slotCounts};
+
+        printf("\nDraw distance %d\n", drawDistance);
+        double serial = 0.0;
+        int expectedCount = 0;
+        for (int workers = 0; workers <= maxWorkers; workers++)
+        {
+            if (!InitWorkerPool(workers))
+            {
+                fprintf(stderr, "track3d_bench: could only start %d of %d worker(s)\n", GetWorkerCount(), workers);
+                break;
+            }
+
+            int count = 0;
+            BuildFrames(&view, 1, workers == 0 ? expected : vertices, &count); // Warm up.
+            const double perFrame = BuildFrames(&view, frames, workers == 0 ? expected : vertices, &count);
+            if (workers == 0)
+            {
+                serial = perFrame;
+                expectedCount = count;
+            }
+            const bool same = count == expectedCount &&
+                              (workers == 0 || memcmp(vertices, expected, (size_t)count * sizeof(TrackVertex)) == 0);
+            printf("  %2d thread(s): %8.3f ms/frame, %5.2fx%s\n", workers + 1, perFrame * 1000.0, serial / perFrame,
+                   same ? "" : " MISMATCH");
+            mismatched = mismatched || !same;
+        }
+        CloseWorkerPool();
+
+        free(vertices);
+        free(expected);
+        free(slotCounts);
+        free(slots);
+        free(screenY);
+        free(screenX);
+        free(scales);
+    }
+
+    // Drive at different frame rates with one thread per processor.
+    float scales[DRIVE_DRAW_DISTANCE + 1];
+    float screenX[DRIVE_DRAW_DISTANCE + 1];
+    float screenY[DRIVE_DRAW_DISTANCE + 1];
+    static TrackVertex slots[DRIVE_DRAW_DISTANCE * SEGMENT_VERTICES];
+    int slotCounts[DRIVE_DRAW_DISTANCE];
+    static TrackVertex vertices[DRIVE_DRAW_DISTANCE * SEGMENT_VERTICES];
+    TrackView view = {.segments = segments,
+                      .mask = RING_SIZE - 1,
+                      .length = TRACK_LENGTH,
+                      .drawDistance = DRIVE_DRAW_DISTANCE,
+                      .scales = scales,
+                      .screenX = screenX,
+                      .screenY = screenY,
+                      .slots = slots,
+                      .slotCounts = slotCounts};
+    InitWorkerPool(maxWorkers);
+    printf("\nDriving for %d seconds at %d updates per second\n", DRIVE_SECONDS, UPDATE_FPS);
+    for (size_t i = 0; i < sizeof(renderFps) / sizeof(renderFps[0]); i++)
+    {
+        Car car;
+        int updates = 0;
+        const double perFrame = Drive(renderFps[i], &view, vertices, &car, &updates);
+        printf("  %3d fps: %8.3f ms/frame, %d update(s), z=%.3f x=%.3f speed=%.3f\n", renderFps[i], perFrame * 1000.0, updates,
+               car.z, car.x, car.speed);
+    }
+    CloseWorkerPool();
+
+    // Update increasing amounts of traffic for DRIVE_SECONDS.
+    printf("\nTraffic for %d seconds at %d updates per second\n", DRIVE_SECONDS, UPDATE_FPS);
+    for (size_t i = 0; i < sizeof(trafficCounts) / sizeof(trafficCounts[0]); i++)
+    {
+        const int updates = DRIVE_SECONDS * UPDATE_FPS;
+        InitTraffic(&traffic, trafficCounts[i], TRACK_LENGTH);
+        const double start = GetBenchTime();
+        for (int update = 0; update < updates; update++)
+        {
+            UpdateTraffic(&traffic, 1.0f / UPDATE_FPS);
+        }
+        const double perUpdate = (GetBenchTime() - start) / updates;
+        printf("  %5d car(s): %8.3f us/update, %6.1f ns/car\n", traffic.count, perUpdate * 1e6, perUpdate * 1e9 / traffic.count);
+    }
+
+    return mismatched ? EXIT_FAILURE : EXIT_SUCCESS;
+}
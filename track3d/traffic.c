@@ -0,0 +1,163 @@
+#include "traffic.h"
+
+#include <math.h>
+#include <stdbool.h>
+
+// A small generator of our own, so that the same count and length always give the same traffic.
+static unsigned int NextRandom(Traffic* traffic)
+{
+    traffic->seed = traffic->seed * 1664525u + 1013904223u;
+    return traffic->seed >> 8;
+}
+
+static float RandomFloat(Traffic* traffic, float min, float max)
+{
+    return min + (max - min) * (float)(NextRandom(traffic) & 0xffff) / 65535.0f;
+}
+
+float GetTrafficLaneX(int lane)
+{
+    return ((float)lane - (TRAFFIC_LANES - 1) / 2.0f) * TRAFFIC_LANE_WIDTH;
+}
+
+// Spread the cars evenly around the lap, in random lanes at random speeds.
+void InitTraffic(Traffic* traffic, int count, int length)
+{
+    traffic->count = count < MAX_TRAFFIC ? count : MAX_TRAFFIC;
+    traffic->length = length;
+    traffic->seed = 1;
+    for (int i = 0; i < traffic->count; i++)
+    {
+        traffic->z[i] = (float)length * (float)i / (float)traffic->count;
+        traffic->lane[i] = GetTrafficLaneX((int)(NextRandom(traffic) % TRAFFIC_LANES));
+        traffic->x[i] = traffic->lane[i];
+        traffic->cruise[i] = RandomFloat(traffic, TRAFFIC_MIN_SPEED, TRAFFIC_MAX_SPEED);
+        traffic->speed[i] = traffic->cruise[i];
+        traffic->target[i] = traffic->cruise[i];
+        traffic->type[i] = (unsigned char)(NextRandom(traffic) % TRAFFIC_TYPES);
+    }
+}
+
+// Decide how fast each car wants to go, and whether it wants to change lanes, from where the cars in front of it are. Nothing
+// moves until every car has decided.
+static void DecideTraffic(Traffic* traffic)
+{
+    const int count = traffic->count;
+    const float length = (float)traffic->length;
+    for (int i = 0; i < count; i++)
+    {
+        float target = traffic->cruise[i];
+        bool blocked = false;
+        const int ahead = count - 1 < TRAFFIC_LOOKAHEAD ? count - 1 : TRAFFIC_LOOKAHEAD;
+        for (int k = 1; k <= ahead; k++)
+        {
+            const int j = i + k < count ? i + k : i + k - count;
+            float gap = traffic->z[j] - traffic->z[i];
+            if (gap < 0.0f)
+            {
+                gap += length;
+            }
+            if (gap > TRAFFIC_FOLLOW)
+            {
+                break;
+            }
+            if (fabsf(traffic->x[j] - traffic->x[i]) < TRAFFIC_LANE_WIDTH && traffic->speed[j] < target)
+            {
+                target = traffic->speed[j];
+                blocked = true;
+            }
+        }
+        traffic->target[i] = target;
+
+        // Pull out to overtake, if the car has finished changing lanes and isn't boxed in at the edge of the road.
+        if (blocked && fabsf(traffic->x[i] - traffic->lane[i]) < 1.0f)
+        {
+            const float step = (NextRandom(traffic) & 1) ? TRAFFIC_LANE_WIDTH : -TRAFFIC_LANE_WIDTH;
+            const float edge = GetTrafficLaneX(TRAFFIC_LANES - 1);
+            const float lane = fabsf(traffic->lane[i] + step) <= edge ? traffic->lane[i] + step : traffic->lane[i] - step;
+            traffic->lane[i] = lane;
+        }
+    }
+}
+
+// Move every car on by one fixed update.
+static void MoveTraffic(Traffic* traffic, float dt)
+{
+    const int count = traffic->count;
+    const float length = (float)traffic->length;
+    const float accelerate = TRAFFIC_ACCELERATION * dt;
+    const float brake = -TRAFFIC_BRAKING * dt;
+    const float steer = TRAFFIC_LANE_CHANGE * dt;
+    for (int i = 0; i < count; i++)
+    {
+        const float dv = fminf(fmaxf(traffic->target[i] - traffic->speed[i], brake), accelerate);
+        traffic->speed[i] += dv;
+        const float dx = fminf(fmaxf(traffic->lane[i] - traffic->x[i], -steer), steer);
+        traffic->x[i] += dx;
+        traffic->z[i] += traffic->speed[i] * dt;
+        if (traffic->z[i] >= length)
+        {
+            traffic->z[i] -= length;
+        }
+    }
+}
+
+static void SwapFloats(float* values, int a, int b)
+{
+    const float value = values[a];
+    values[a] = values[b];
+    values[b] = value;
+}
+
+static void SwapTraffic(Traffic* traffic, int a, int b)
+{
+    SwapFloats(traffic->z, a, b);
+    SwapFloats(traffic->x, a, b);
+    SwapFloats(traffic->speed, a, b);
+    SwapFloats(traffic->cruise, a, b);
+    SwapFloats(traffic->lane, a, b);
+    SwapFloats(traffic->target, a, b);
+    const unsigned char type = traffic->type[a];
+    traffic->type[a] = traffic->type[b];
+    traffic->type[b] = type;
+}
+
+// Put the cars back in order. They've hardly moved relative to each other, so an insertion sort only does a few swaps, apart
+// from when a car starts a new lap and moves from the end to the start.
+static void SortTraffic(Traffic* traffic)
+{
+    for (int i = 1; i < traffic->count; i++)
+    {
+        for (int j = i; j > 0 && traffic->z[j] < traffic->z[j - 1]; j--)
+        {
+            SwapTraffic(traffic, j, j - 1);
+        }
+    }
+}
+
+void UpdateTraffic(Traffic* traffic, float dt)
+{
+    DecideTraffic(traffic);
+    MoveTraffic(traffic, dt);
+    SortTraffic(traffic);
+}
+
+// Find the first car at or past z, or count if there isn't one.
+int FindTraffic(const Traffic* traffic, float z)
+{
+    int first = 0;
+    int last = traffic->count;
+    while (first < last)
+    {
+        const int middle = first + (last - first) / 2;
+        if (traffic->z[middle] < z)
+        {
+            first = middle + 1;
+        }
+        else
+        {
+            last = middle;
+        }
+    }
+    return first;
+}
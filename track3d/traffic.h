@@ -0,0 +1,34 @@
+#pragma once
+
+#define MAX_TRAFFIC 8192           // The most AI cars on the track.
+#define TRAFFIC_TYPES 4            // How many colours of car there are.
+#define TRAFFIC_LANES 4            // How many lanes the road has.
+#define TRAFFIC_LANE_WIDTH 875.0f  // How wide each lane is, in world units.
+#define TRAFFIC_LOOKAHEAD 8        // How many cars ahead each car looks at when deciding how fast to go.
+#define TRAFFIC_FOLLOW 12.0f       // How close a car gets to the car in front before it slows down, in segments.
+#define TRAFFIC_MIN_SPEED 20.0f    // The slowest that a car likes to go, in segments per second.
+#define TRAFFIC_MAX_SPEED 50.0f    // The fastest that a car likes to go.
+#define TRAFFIC_ACCELERATION 8.0f  // How quickly a car speeds up, in segments per second per second.
+#define TRAFFIC_BRAKING 30.0f      // How quickly a car slows down.
+#define TRAFFIC_LANE_CHANGE 800.0f // How quickly a car moves across the road when it changes lanes, in world units per second.
+
+// The AI cars, as a structure of arrays so that each pass over them only touches what it needs. They're kept sorted by how far
+// around the lap they are, so that the cars in front of a car come after it, and so that the cars in view are a contiguous range.
+typedef struct
+{
+    int count;                       // How many cars are there?
+    int length;                      // How many segments are there in a lap?
+    unsigned int seed;               // For choosing lanes and speeds.
+    float z[MAX_TRAFFIC];            // How far around the lap is each car, in segments? Ascending.
+    float x[MAX_TRAFFIC];            // How far left or right of the centre line is each car, in world units?
+    float speed[MAX_TRAFFIC];        // How fast is each car going, in segments per second?
+    float cruise[MAX_TRAFFIC];       // How fast would each car like to go?
+    float lane[MAX_TRAFFIC];         // Where is the middle of the lane that each car is heading for?
+    float target[MAX_TRAFFIC];       // How fast is each car trying to go this update?
+    unsigned char type[MAX_TRAFFIC]; // What colour is each car?
+} Traffic;
+
+void InitTraffic(Traffic* traffic, int count, int length);
+void UpdateTraffic(Traffic* traffic, float dt);
+int FindTraffic(const Traffic* traffic, float z);
+float GetTrafficLaneX(int lane);